@@ -19,6 +19,23 @@
 //
 // The chip is setup for SINGLE ENDED, ODD Sign, UNIPOLAR with an I2C Adderess of 0.
 //
+// Most of the day the dish is settled (or it is dark) and the photo-resistors do not change, so
+//     ADC_Adaptive_Get_Data() decides whether a full sample set is worth taking on this call.
+//     While the H/V error is outside the deadband or a dish motor is being driven, every call samples.
+//     When settled, only every ADC_SLOW_SAMPLE_DIVISOR calls samples.  At night (all photo-resistors
+//     below the dark threshold) only every ADC_NIGHT_SAMPLE_DIVISOR calls samples.
+//     Events are only raised when the error crosses the deadband or day/night changes.
+//
+// Once the site and the time are known, Solar_Position drives the dish.  The photo-resistors are
+//     then only read every ADC_CORRECTION_SAMPLE_DIVISOR calls and the H/V error is fed back into the
+//     model as a correction.
+//
+// When the acquisition cycle overruns the period, Cycle_Budget.c can drop the sample count
+//     (Cycle_Budget_ADC_Samples()), never below what the trimmed mean needs.
+//
+// A channel gets at most ADC_ATTEMPTS_PER_SAMPLE reads per sample it needs.  When the chip keeps failing
+//     the bus is released, the channel keeps its last reading and one event is logged for it.
+//
 // Notes:
 // 	    Chip 1 - Dish Movement
 // 	    Chip 2 - Motor Speed
@@ -89,13 +106,93 @@
 #include "Task_Setups.h"
 #include "Console_Interface.h"
 #include "Semaphore_Setup.h"
+#include "Solar_Position.h"
+#include "I2C_Scheduler.h"
+#include "Event_Log.h"
+#include "Boot_Timing.h"
+#include "Perf_Instrument.h"
+#include "Acquisition_Kernels.h"
+#include "Cycle_Budget.h"
+
+
+
+// Adaptive Sampling
+#define ADC_SAMPLE_MODE_FAST				0      // dish is moving or out of the deadband
+#define ADC_SAMPLE_MODE_SLOW				1      // dish is settled
+#define ADC_SAMPLE_MODE_NIGHT				2      // all photo-resistors are dark
+#define ADC_SAMPLE_MODE_CORRECTION			3      // the sun position model is tracking, only correct it
+
+#define ADC_FAST_SAMPLE_DIVISOR				1      // sample on every call
+#define ADC_SLOW_SAMPLE_DIVISOR				10     // sample on every 10th call
+#define ADC_NIGHT_SAMPLE_DIVISOR			60     // sample on every 60th call
+#define ADC_CORRECTION_SAMPLE_DIVISOR		30     // sample on every 30th call
+
+#define ADC_I2C_DEADLINE_TICKS				5      // ADC reads are latency critical on a shared bus
+#define ADC_ATTEMPTS_PER_SAMPLE				2      // a channel gives up after 2 x samples reads, good or bad
+
+#define ADC_DEADBAND_DEFAULT				40     // H/V differential counts (12 bit data, 4 channel sums)
+#define ADC_DARK_THRESHOLD_DEFAULT			100    // per channel counts, below this is dark
+
+// Event Bits - returned by ADC_Get_Events()
+#define ADC_EVENT_H_LEFT_DEADBAND			0x01
+#define ADC_EVENT_H_ENTERED_DEADBAND		0x02
+#define ADC_EVENT_V_LEFT_DEADBAND			0x04
+#define ADC_EVENT_V_ENTERED_DEADBAND		0x08
+#define ADC_EVENT_NIGHT_BEGIN				0x10
+#define ADC_EVENT_NIGHT_END					0x20
+
+
+uint32_t a_uiADC_Sample_Divisor[] = { ADC_FAST_SAMPLE_DIVISOR, ADC_SLOW_SAMPLE_DIVISOR, ADC_NIGHT_SAMPLE_DIVISOR, ADC_CORRECTION_SAMPLE_DIVISOR };
+
+uint32_t g_uiADC_Sample_Mode = ADC_SAMPLE_MODE_FAST;
+uint32_t g_uiADC_Call_Counter = 0;
+uint32_t g_uiADC_Deadband = ADC_DEADBAND_DEFAULT;
+uint32_t g_uiADC_Dark_Threshold = ADC_DARK_THRESHOLD_DEFAULT;
+uint32_t g_uiADC_Motor_Driven = false;
+uint32_t g_uiADC_Events = 0;
+
+uint32_t g_uiADC_H_Outside_Deadband = false;
+uint32_t g_uiADC_V_Outside_Deadband = false;
+uint32_t g_uiADC_Night = false;
+
+
+
+void ADC_Set_Motor_Driven(uint32_t uiMotorDriven)
+{
+	// the dish motor code tells us when it is moving the dish, we want every sample while it moves
+	// (when the sun position model is tracking, the model moves the dish and the photo-resistors stay slow)
+	g_uiADC_Motor_Driven = uiMotorDriven;
+
+	if (uiMotorDriven && (Solar_Position_Is_Valid() == false))
+	{
+		g_uiADC_Sample_Mode = ADC_SAMPLE_MODE_FAST;
+	}
+}
+
+
+void ADC_Set_Sampling_Thresholds(uint32_t uiDeadband, uint32_t uiDarkThreshold)
+{
+	g_uiADC_Deadband = uiDeadband;
+	g_uiADC_Dark_Threshold = uiDarkThreshold;
+}
+
+
+uint32_t ADC_Get_Events(void)
+{
+	// hand back what has happened since the last call and start over...
+	uint32_t uiEvents = g_uiADC_Events;
+
+	g_uiADC_Events = 0;
+
+	return uiEvents;
+}
 
 
 
 int ADC_Get_Channel_Data(uint8_t ui8_ChipAddress, uint8_t ui8_Channel_Config, uint16_t *ui16_Voltage)
 {
 	// if we use sleep mode, there is a 200ms delay....  Right now, we are using nap mode....
-	bool bTransferOK;
+	uint32_t ui32ErrorCode;
 
 	I2C_Transaction ADC_Transaction;
 
@@ -124,16 +221,14 @@ int ADC_Get_Channel_Data(uint8_t ui8_ChipAddress, uint8_t ui8_Channel_Config, ui
 	ADC_Transaction.readCount = 0;
 	ADC_Transaction.arg = NULL;
 
-	bTransferOK = I2C_transfer(g_I2C_ADC_Handle, &ADC_Transaction); /* Perform I2C transfer */
-	if (bTransferOK == false)
+	ui32ErrorCode = I2C_Scheduler_Transfer(I2C_BUS_ADC, I2C_PRIORITY_CRITICAL, ADC_I2C_DEADLINE_TICKS, &ADC_Transaction);
+	if (ui32ErrorCode != I2C_MASTER_ERR_NONE)
 	{
 		*ui16_Voltage = ERROR_VOLTAGE_VALUE;
 
-		int iReturn = I2C_control(g_I2C_ADC_Handle, I2C_MASTER_ERR_NONE, 0);
-
-		Telemetry_Send_Output_Value("ADC_Get_Channel_Data()::Write() ", iReturn);
+		Event_Log_Push(EVENT_SOURCE_ADC, EVENT_NO_PROBE, 100, ui32ErrorCode, ui8_Channel_Config, "ADC_Get_Channel_Data()::Write() \n");
 
-		return iReturn;
+		return ui32ErrorCode;
 	}
 
 	// a little delay before reading the channel
@@ -151,16 +246,14 @@ int ADC_Get_Channel_Data(uint8_t ui8_ChipAddress, uint8_t ui8_Channel_Config, ui
 	ADC_Transaction.readCount = 2;
 	ADC_Transaction.arg = NULL;
 
-	bTransferOK = I2C_transfer(g_I2C_ADC_Handle, &ADC_Transaction); /* Perform I2C transfer */
-	if (bTransferOK == false)
+	ui32ErrorCode = I2C_Scheduler_Transfer(I2C_BUS_ADC, I2C_PRIORITY_CRITICAL, ADC_I2C_DEADLINE_TICKS, &ADC_Transaction);
+	if (ui32ErrorCode != I2C_MASTER_ERR_NONE)
 	{
 		*ui16_Voltage = ERROR_VOLTAGE_VALUE;
 
-		int iReturn = I2C_control(g_I2C_ADC_Handle, I2C_MASTER_ERR_NONE, 0);
+		Event_Log_Push(EVENT_SOURCE_ADC, EVENT_NO_PROBE, 110, ui32ErrorCode, ui8_Channel_Config, "ADC_Get_Channel_Data()::Read() \n");
 
-		Telemetry_Send_Output_Value("ADC_Get_Channel_Data()::Read() ", iReturn);
-
-		return iReturn;
+		return ui32ErrorCode;
 	}
 
 
@@ -191,6 +284,20 @@ int ADC_Get_Channel_Data(uint8_t ui8_ChipAddress, uint8_t ui8_Channel_Config, ui
 
 
 
+void ADC_Calculate_Results(void)
+{
+	g_s_Dish_Movement_Telemetry.MT_iH_ResultCalc =
+						(g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_H_Data[0] + g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_H_Data[2]) -
+						(g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_H_Data[1] + g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_H_Data[3]);
+
+
+	g_s_Dish_Movement_Telemetry.MT_iV_ResultCalc =
+						(g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_V_Data[0] + g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_V_Data[2]) -
+						(g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_V_Data[1] + g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_V_Data[3]);
+}
+
+
+
 void ADC_Get_Data(void)
 {
 	int iRtn;
@@ -219,6 +326,12 @@ void ADC_Get_Data(void)
 
 	//char szMessage[128];
 
+	PERF_START(ui32Perf);
+	uint32_t ui32Cycle_Start = Cycle_Budget_Phase_Start(CYCLE_PHASE_ADC);
+
+	// fewer when the cycle is degraded
+	uint32_t uiSamples = Cycle_Budget_ADC_Samples(MAX_ADC_SAMPLES);
+
 	// ths routine is 'programming' each chip to start data gathering
 	//uiMaxChips = MAX_ADC_CHIPS;
 	uiMaxChips = 1;
@@ -232,23 +345,38 @@ void ADC_Get_Data(void)
 		{
 			ui8_Channel_Selector = a_ui8_Channel_Select[uiChannel_Index];
 
-			uint32_t uiLow = 0xFFFF;
-			uint32_t uiHigh = 0;
-			uint32_t uiAccumulator = 0;
+			Acquisition_Trim sTrim;
+			uint32_t uiAccumulator;
 			uint32_t uiAverageIndex = 0;
+			uint32_t uiAttempts = 0;
+			int iLast_Error = 0;
+
+			Acquisition_Trim_Reset(&sTrim);
+
+			// all of the samples for one channel go out as one batch on the bus
+			iRtn = I2C_Scheduler_Acquire(I2C_BUS_ADC, I2C_PRIORITY_CRITICAL, ADC_I2C_DEADLINE_TICKS);
+			if (iRtn != I2C_MASTER_ERR_NONE)
+			{
+				// never got the bus, so there is nothing to release... the channel keeps its last reading
+				Event_Log_Push(EVENT_SOURCE_ADC, uiChannel_Index, 121, iRtn, ui8_Channel_Selector, "ADC_Get_Data()::Could Not Acquire The Bus \n");
+				continue;
+			}
 
-			while (uiAverageIndex < MAX_ADC_SAMPLES)
+			// a chip that keeps NACKing can't hold the bus forever, the other waiters need it too
+			while ((uiAverageIndex < uiSamples) && (uiAttempts < (uiSamples * ADC_ATTEMPTS_PER_SAMPLE)))
 			{
+				PERF_START(ui32Perf_Channel);
+
+				uiAttempts++;
 				iRtn = ADC_Get_Channel_Data(ui8_Chips_Addresses, ui8_Channel_Selector, &ui16_Voltage);
 
+				PERF_STOP(PERF_OP_ADC_CHANNEL, uiChannel_Index, ui32Perf_Channel);
+
 				if (iRtn == 0)
 				{
 					uiAverageIndex++;
 
-					if (ui16_Voltage < uiLow) uiLow = ui16_Voltage;
-					if (ui16_Voltage > uiHigh) uiHigh = ui16_Voltage;
-
-					uiAccumulator += ui16_Voltage;
+					Acquisition_Trim_Add(&sTrim, ui16_Voltage);
 
 					//char szMessage[128];
 					//sprintf(szMessage, "Max Chips: %i  Chip Used: %i  Chip Address: %x   Max Channels: %i   Channel Index: %i   Channel Selector: %x   Voltage: %i \n",
@@ -263,14 +391,21 @@ void ADC_Get_Data(void)
 				}
 				else
 				{
-					Telemetry_Send_Output("ADC_Get_Data()::Invalid Return On Data \n");
+					iLast_Error = iRtn;
 				}
 			}
 
+			I2C_Scheduler_Release(I2C_BUS_ADC);
+
+			if (uiAverageIndex < uiSamples)
+			{
+				// out of attempts... one record for the channel, not one per bad read, and it keeps its last reading
+				Event_Log_Push(EVENT_SOURCE_ADC, uiChannel_Index, 120, iLast_Error, uiAverageIndex, "ADC_Get_Data()::Invalid Return On Data \n");
+				continue;
+			}
+
 			// scratch the high and the low and average it out...
-			uiAccumulator -= uiLow;
-			uiAccumulator -= uiHigh;
-			uiAccumulator = uiAccumulator / (MAX_ADC_SAMPLES - 2);
+			uiAccumulator = Acquisition_Trimmed_Mean(&sTrim);
 
 
 			if (uiChipInUse == 0)
@@ -298,19 +433,117 @@ void ADC_Get_Data(void)
 	}
 
 
-	g_s_Dish_Movement_Telemetry.MT_iH_ResultCalc =
-						(g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_H_Data[0] + g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_H_Data[2]) -
-						(g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_H_Data[1] + g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_H_Data[3]);
+	ADC_Calculate_Results();
 
+	PERF_STOP(PERF_OP_ADC_GET_DATA, PERF_NO_SLOT, ui32Perf);
+	Cycle_Budget_Phase_Stop(CYCLE_PHASE_ADC, ui32Cycle_Start);
+
+	Boot_Timing_Mark(BOOT_STAGE_FIRST_ADC);
+
+}
+
+
+
+uint32_t ADC_Is_Dark(void)
+{
+	uint32_t i;
+
+	// every photo-resistor has to be dark, one bright channel means the sun is up somewhere
+	for (i = 0; i < MAX_PHOTORESISTOR_RLUP; i++)
+	{
+		if (g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_H_Data[i] >= g_uiADC_Dark_Threshold) return false;
+		if (g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_V_Data[i] >= g_uiADC_Dark_Threshold) return false;
+	}
+
+	return true;
+}
+
+
+
+void ADC_Update_Sample_Mode(void)
+{
+	int iH = g_s_Dish_Movement_Telemetry.MT_iH_ResultCalc;
+	int iV = g_s_Dish_Movement_Telemetry.MT_iV_ResultCalc;
+
+	uint32_t uiH_Outside = (abs(iH) > (int) g_uiADC_Deadband);
+	uint32_t uiV_Outside = (abs(iV) > (int) g_uiADC_Deadband);
+	uint32_t uiNight = ADC_Is_Dark();
+
+
+	// only raise events on the crossings, not on every sample
+	if (uiH_Outside != g_uiADC_H_Outside_Deadband)
+	{
+		g_uiADC_Events |= (uiH_Outside ? ADC_EVENT_H_LEFT_DEADBAND : ADC_EVENT_H_ENTERED_DEADBAND);
+		g_uiADC_H_Outside_Deadband = uiH_Outside;
+	}
+
+	if (uiV_Outside != g_uiADC_V_Outside_Deadband)
+	{
+		g_uiADC_Events |= (uiV_Outside ? ADC_EVENT_V_LEFT_DEADBAND : ADC_EVENT_V_ENTERED_DEADBAND);
+		g_uiADC_V_Outside_Deadband = uiV_Outside;
+	}
+
+	if (uiNight != g_uiADC_Night)
+	{
+		g_uiADC_Events |= (uiNight ? ADC_EVENT_NIGHT_BEGIN : ADC_EVENT_NIGHT_END);
+		g_uiADC_Night = uiNight;
+	}
 
-	g_s_Dish_Movement_Telemetry.MT_iV_ResultCalc =
-						(g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_V_Data[0] + g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_V_Data[2]) -
-						(g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_V_Data[1] + g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_V_Data[3]);
 
+	// the model wins when it is valid, otherwise a moving dish, then night, then the deadband
+	if (Solar_Position_Is_Valid())
+	{
+		if (uiNight)
+		{
+			// the sun is up but it is dark... clouds.  Keep following the model and don't correct it.
+			g_uiADC_Sample_Mode = ADC_SAMPLE_MODE_NIGHT;
+		}
+		else
+		{
+			Solar_Position_Apply_Correction(iH, iV);
+			g_uiADC_Sample_Mode = ADC_SAMPLE_MODE_CORRECTION;
+		}
+	}
+	else if (g_uiADC_Motor_Driven)
+	{
+		g_uiADC_Sample_Mode = ADC_SAMPLE_MODE_FAST;
+	}
+	else if (uiNight)
+	{
+		g_uiADC_Sample_Mode = ADC_SAMPLE_MODE_NIGHT;
+	}
+	else if (uiH_Outside || uiV_Outside)
+	{
+		g_uiADC_Sample_Mode = ADC_SAMPLE_MODE_FAST;
+	}
+	else
+	{
+		g_uiADC_Sample_Mode = ADC_SAMPLE_MODE_SLOW;
+	}
+}
+
+
+
+uint32_t ADC_Adaptive_Get_Data(void)
+{
+	// called on every cycle in place of ADC_Get_Data()
+	// returns true if the channels were actually read on this call
+
+	g_uiADC_Call_Counter++;
+
+	if (g_uiADC_Call_Counter < a_uiADC_Sample_Divisor[g_uiADC_Sample_Mode])
+	{
+		// nothing has changed enough to spend the I2C time
+		return false;
+	}
 
+	g_uiADC_Call_Counter = 0;
 
+	ADC_Get_Data();
 
+	ADC_Update_Sample_Mode();
 
+	return true;
 }
 
 
@@ -0,0 +1,203 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// The compute that runs every acquisition cycle, pulled out of Temperature_Interface.c,
+// ADC_Interface.c and Event_Log.c so it can be benchmarked off the board:
+//     Acquisition_CRC8()                  - the 1-Wire CRC of every ROM and scratchpad read
+//     Acquisition_Decode_Temperature()    - scratchpad bytes 0 and 1 to whole / tenths / sign
+//     Acquisition_Celsius_To_Fahrenheit() - the F side of every reading
+//     Acquisition_Trim_...()              - the high / low trimmed mean of each ADC channel
+//     Acquisition_Format_Event()          - the text of an Event_Log record
+//
+// The code is the same as it was in place, only the globals became parameters.  There are no TI-RTOS
+// or driverlib calls in here and nothing is allocated.  tools/Acquisition_Bench.c times each one
+// against a stored baseline, any change here should be run through it.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Event_Log.h"
+#include "Acquisition_Kernels.h"
+
+
+
+							  // 0    1    2    3    4    5    6    7   8    9    A    B    C    D    E    F
+							  // 0  .06  .12  .18  .25  .31  .38  .44  .5  .56  .62  .69  .75  .81  .88  .93
+static const uint8_t a_ui8Fraction_Pos[16] = {0,   1,   1,   2,   3,   3,   4,   4,  5,   6,   6,   7,   8,   8,   9,   9};
+
+							  // 0    1    2    3    4    5    6    7   8    9    A    B    C    D    E    F
+							  // 0  .93  .88  .81  .75  .69  .62  .56  .5  .44  .38  .31  .25  .18  .12  .06
+static const uint8_t a_ui8Fraction_Neg[16] = {9,   9,   8,   7,   7,   6,   6,  5,   4,   4,   3,   3,   2,   1,   1,  0 };
+
+
+
+uint8_t Acquisition_CRC8(const uint8_t* pData, uint32_t uiLength)
+{
+	// Dallas / Maxim 1-Wire CRC (x^8 + x^5 + x^4 + 1), a bit at a time
+	uint8_t uCalcCRC = 0;
+	uint32_t i, j;
+
+	for (i = 0; i < uiLength; i++)
+	{
+		uint8_t inbyte = pData[i];
+
+		for (j = 0; j < 8; j++)
+		{
+			uint8_t mix = (uCalcCRC ^ inbyte) & 0x01;
+			uCalcCRC >>= 1;
+
+			if (mix)
+			{
+				uCalcCRC ^= 0x8C;
+			}
+
+			inbyte >>= 1;
+		}
+	}
+
+	return uCalcCRC;
+}
+
+
+void Acquisition_Decode_Temperature(uint8_t ucByte0, uint8_t ucByte1, uint8_t ui8Resolution_Mask,
+									uint8_t* pui8Whole, uint8_t* pui8Fraction, uint8_t* pui8SignBit)
+{
+	// the 4 bit fractions are downshifted to .1, .2, .3... see the tables above
+	uint8_t ucFractionIndex = ucByte0 & ui8Resolution_Mask;
+
+	ucByte0 = ucByte0 >> 4;   	// shifts bit7 through bit4 down to bit3 through bit0 - clears out the decimal portion
+	ucByte0 = ucByte0 & 0x0F;    // clears out the upper bits
+
+	ucByte1 = ucByte1 << 4;		// shifts bit0 through bit3 up to bit 7 through bit4 - clears out the sign bits
+	ucByte1 = ucByte1 & 0xF0;   // clears out the lower bits
+
+	int8_t i8Temperature = ucByte1 | ucByte0;
+
+	// check the sign bit
+	if ((i8Temperature & (int8_t) 0x80) == 0)
+	{
+		*pui8SignBit = 0;
+		*pui8Whole = i8Temperature;
+		*pui8Fraction = a_ui8Fraction_Pos[ucFractionIndex];
+	}
+	else
+	{
+		// negative... flip the bits of the whole number
+		*pui8SignBit = 1;
+		*pui8Whole = i8Temperature ^ 0xFF;
+		*pui8Fraction = a_ui8Fraction_Neg[ucFractionIndex];
+	}
+}
+
+
+void Acquisition_Celsius_To_Fahrenheit(uint8_t ui8Whole_C, uint8_t ui8Fraction_C, uint8_t ui8SignBit_C,
+									   uint8_t* pui8Whole_F, uint8_t* pui8Fraction_F, uint8_t* pui8SignBit_F)
+{
+	float fTemp;
+	float fTemp2;
+
+	fTemp = (float) ui8Whole_C + ((float) ui8Fraction_C / 10.0);
+
+	if (ui8SignBit_C)
+	{
+		fTemp = fTemp * -1;
+	}
+
+	// get the whole portion
+	fTemp = (fTemp * 1.8) + 32;
+	uint8_t ui8Temp_1 = (uint8_t) fTemp;
+	*pui8Whole_F = ui8Temp_1;
+
+	// get the fraction
+	fTemp2 = fTemp - (float) ui8Temp_1;
+	fTemp2 *= 10;
+	*pui8Fraction_F = (uint8_t) fTemp2;
+
+	// get the sign bit
+	*pui8SignBit_F = 0;
+	if (fTemp < 0) *pui8SignBit_F = 1;
+}
+
+
+void Acquisition_Trim_Reset(Acquisition_Trim* pTrim)
+{
+	pTrim->uiLow = 0xFFFF;
+	pTrim->uiHigh = 0;
+	pTrim->uiAccumulator = 0;
+	pTrim->uiCount = 0;
+}
+
+
+void Acquisition_Trim_Add(Acquisition_Trim* pTrim, uint32_t uiSample)
+{
+	if (uiSample < pTrim->uiLow) pTrim->uiLow = uiSample;
+	if (uiSample > pTrim->uiHigh) pTrim->uiHigh = uiSample;
+
+	pTrim->uiAccumulator += uiSample;
+	pTrim->uiCount++;
+}
+
+
+uint32_t Acquisition_Trimmed_Mean(const Acquisition_Trim* pTrim)
+{
+	// scratch the high and the low and average it out...
+	if (pTrim->uiCount <= 2) return 0;
+
+	return (pTrim->uiAccumulator - pTrim->uiLow - pTrim->uiHigh) / (pTrim->uiCount - 2);
+}
+
+
+static void Acquisition_Ltoa(int32_t i32Value, char* szBuffer)
+{
+	// what the TI ltoa() does with a 32 bit long, without depending on it
+	char szDigits[12];
+	uint32_t uiValue = (i32Value < 0) ? (0 - (uint32_t) i32Value) : (uint32_t) i32Value;
+	uint32_t uiCount = 0;
+
+	do
+	{
+		szDigits[uiCount++] = (char) ('0' + (uiValue % 10));
+		uiValue /= 10;
+	} while (uiValue);
+
+	if (i32Value < 0) *szBuffer++ = '-';
+
+	while (uiCount) *szBuffer++ = szDigits[--uiCount];
+
+	*szBuffer = 0;
+}
+
+
+void Acquisition_Format_Event(const Event_Record* pRecord, const char* szSource, char* szBuffer)
+{
+	// same layout Temperature_Log_Message() used to print, with the time in front
+
+	char szTime[12];
+	char szIndex[12];
+	char szLocation[12];
+	char szErrorCode[12];
+	char szExtended[12];
+
+	Acquisition_Ltoa((int32_t) pRecord->ui32Timestamp, szTime);
+	Acquisition_Ltoa(pRecord->ui8Probe, szIndex);
+	Acquisition_Ltoa(pRecord->ui16Location, szLocation);
+	Acquisition_Ltoa((int32_t) pRecord->ui32ErrorCode, szErrorCode);
+	Acquisition_Ltoa((int32_t) pRecord->ui32Extended, szExtended);
+
+	strcpy(szBuffer, szTime);
+	strcat(szBuffer, " ");
+	strcat(szBuffer, szSource);
+	strcat(szBuffer, " Index: ");
+	strcat(szBuffer, szIndex);
+	strcat(szBuffer, "   Location: ");
+	strcat(szBuffer, szLocation);
+	strcat(szBuffer, "   Error: ");
+	strcat(szBuffer, szErrorCode);
+	strcat(szBuffer, "   Extended: ");
+	strcat(szBuffer, szExtended);
+	strcat(szBuffer, "\n");
+}
@@ -0,0 +1,41 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Acquisition Kernels - the per cycle compute of the temperature and ADC paths, with no TI-RTOS or
+// driver dependencies so tools/Acquisition_Bench.c can time them on the PC.
+//
+//*****************************************************************************
+
+#ifndef ACQUISITION_KERNELS_H_
+#define ACQUISITION_KERNELS_H_
+
+#include <stdint.h>
+
+#include "Event_Log.h"
+
+
+// running low / high / sum of the samples of one ADC channel
+typedef struct
+{
+	uint32_t uiLow;
+	uint32_t uiHigh;
+	uint32_t uiAccumulator;
+	uint32_t uiCount;
+} Acquisition_Trim;
+
+
+uint8_t Acquisition_CRC8(const uint8_t* pData, uint32_t uiLength);
+
+void Acquisition_Decode_Temperature(uint8_t ucByte0, uint8_t ucByte1, uint8_t ui8Resolution_Mask,
+									uint8_t* pui8Whole, uint8_t* pui8Fraction, uint8_t* pui8SignBit);
+void Acquisition_Celsius_To_Fahrenheit(uint8_t ui8Whole_C, uint8_t ui8Fraction_C, uint8_t ui8SignBit_C,
+									   uint8_t* pui8Whole_F, uint8_t* pui8Fraction_F, uint8_t* pui8SignBit_F);
+
+void Acquisition_Trim_Reset(Acquisition_Trim* pTrim);
+void Acquisition_Trim_Add(Acquisition_Trim* pTrim, uint32_t uiSample);
+uint32_t Acquisition_Trimmed_Mean(const Acquisition_Trim* pTrim);
+
+void Acquisition_Format_Event(const Event_Record* pRecord, const char* szSource, char* szBuffer);
+
+#endif /* ACQUISITION_KERNELS_H_ */
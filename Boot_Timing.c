@@ -0,0 +1,128 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Boot used to be one long line... three UARTs, three I2C buses, the clocks, then the four pump PWMs last,
+// then Temperature_Initiate() reset every DS2482, read every ROM and configured every probe before the
+// first reading existed.  A failure on any driver returned before the PWMs were ever opened, so the pump
+// outputs sat in whatever state the pins came up in.
+//
+// Driver_Setup() is now staged:
+//     Pumps Safe - the PWMs are opened first and set to 0 duty, before anything that can fail.
+//     UARTs      - logger, test and console.
+//     I2C        - the three buses through the I2C Scheduler.
+//     Timers     - the job scheduler and its jobs.
+// The ROM code reads are spread over the first temperature passes (see Temperature_Initiate()), they
+// aren't needed for a reading, so the first pass only resets, configures and converts.
+//
+// Each stage is marked here as it completes.  The temperature pass and the ADC sample set mark their
+// first completion, once both are in the pump and dish logic has its inputs (Inputs Ready) and the report
+// goes out.  The control logic marks BOOT_STAGE_FIRST_CONTROL on its first decision.
+//
+// Times are from the Timestamp counter (us) while they fit in it, Clock ticks after that.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <xdc/std.h>
+#include <xdc/runtime/Types.h>
+#include <xdc/runtime/Timestamp.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#include "Telemetry.h"
+#include "Boot_Timing.h"
+#include "I2C_HAL.h"
+
+
+
+#define BOOT_TIMESTAMP_LIMIT_TICKS			20000  // well inside one Timestamp wrap at 120 MHz
+
+
+uint32_t a_uiBoot_Marked[BOOT_MAX_STAGES];
+uint32_t a_ui32Boot_Timestamp[BOOT_MAX_STAGES];
+uint32_t a_ui32Boot_Ticks[BOOT_MAX_STAGES];
+
+const char* a_szBoot_Stage[BOOT_MAX_STAGES] = { "Boot: Start (us): ",
+												"Boot: Pumps Safe (us): ",
+												"Boot: UARTs (us): ",
+												"Boot: I2C (us): ",
+												"Boot: Timers (us): ",
+												"Boot: Drivers Done (us): ",
+												"Boot: First Temperature (us): ",
+												"Boot: First ADC (us): ",
+												"Boot: Inputs Ready (us): ",
+												"Boot: First Control (us): " };
+
+
+
+void Boot_Timing_Mark(uint32_t uiStage)
+{
+	// only the first time each stage completes counts
+	uint32_t uiInputs_Ready = false;
+	uint32_t uiNew = false;
+
+	if (uiStage >= BOOT_MAX_STAGES) return;
+
+	UInt uiKey = Hwi_disable();
+
+	if (a_uiBoot_Marked[uiStage] == false)
+	{
+		a_ui32Boot_Timestamp[uiStage] = I2C_HAL_Timestamp();
+		a_ui32Boot_Ticks[uiStage] = I2C_HAL_Get_Ticks();
+		a_uiBoot_Marked[uiStage] = true;
+		uiNew = true;
+
+		if (a_uiBoot_Marked[BOOT_STAGE_FIRST_TEMPERATURE] && a_uiBoot_Marked[BOOT_STAGE_FIRST_ADC] && (a_uiBoot_Marked[BOOT_STAGE_INPUTS_READY] == false))
+		{
+			a_ui32Boot_Timestamp[BOOT_STAGE_INPUTS_READY] = a_ui32Boot_Timestamp[uiStage];
+			a_ui32Boot_Ticks[BOOT_STAGE_INPUTS_READY] = a_ui32Boot_Ticks[uiStage];
+			a_uiBoot_Marked[BOOT_STAGE_INPUTS_READY] = true;
+			uiInputs_Ready = true;
+		}
+	}
+
+	Hwi_restore(uiKey);
+
+	if (uiInputs_Ready) Boot_Timing_Report();
+	else if (uiNew && (uiStage == BOOT_STAGE_FIRST_CONTROL)) Telemetry_Send_Output_Value(a_szBoot_Stage[uiStage], Boot_Timing_Get_us(uiStage));
+}
+
+
+uint32_t Boot_Timing_Get_us(uint32_t uiStage)
+{
+	// time from Driver_Setup() to this stage, 0 if it hasn't happened yet
+	if ((uiStage >= BOOT_MAX_STAGES) || (a_uiBoot_Marked[uiStage] == false) || (a_uiBoot_Marked[BOOT_STAGE_START] == false)) return 0;
+
+	uint32_t ui32Ticks = a_ui32Boot_Ticks[uiStage] - a_ui32Boot_Ticks[BOOT_STAGE_START];
+
+	if (ui32Ticks < BOOT_TIMESTAMP_LIMIT_TICKS)
+	{
+		Types_FreqHz sFrequency;
+		Timestamp_getFreq(&sFrequency);
+
+		uint32_t uiCycles_Per_us = sFrequency.lo / 1000000;
+		if (uiCycles_Per_us == 0) uiCycles_Per_us = 1;
+
+		return (a_ui32Boot_Timestamp[uiStage] - a_ui32Boot_Timestamp[BOOT_STAGE_START]) / uiCycles_Per_us;
+	}
+
+	return ui32Ticks * Clock_tickPeriod;
+}
+
+
+void Boot_Timing_Report(void)
+{
+	uint32_t i;
+
+	for (i = BOOT_STAGE_PUMPS_SAFE; i < BOOT_MAX_STAGES; i++)
+	{
+		if (a_uiBoot_Marked[i] == false) continue;
+
+		Telemetry_Send_Output_Value(a_szBoot_Stage[i], Boot_Timing_Get_us(i));
+	}
+}
@@ -0,0 +1,33 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Boot Timing - time stamps for each boot stage, up to the first control decision.
+//
+//*****************************************************************************
+
+#ifndef BOOT_TIMING_H_
+#define BOOT_TIMING_H_
+
+#include <stdint.h>
+
+
+// Stages - in the order they normally complete
+#define BOOT_STAGE_START					0      // Driver_Setup() entered
+#define BOOT_STAGE_PUMPS_SAFE				1      // all four PWMs open at 0 duty
+#define BOOT_STAGE_UARTS					2
+#define BOOT_STAGE_I2C						3
+#define BOOT_STAGE_TIMERS					4
+#define BOOT_STAGE_DRIVERS_DONE				5
+#define BOOT_STAGE_FIRST_TEMPERATURE		6      // first complete temperature pass
+#define BOOT_STAGE_FIRST_ADC				7      // first dish ADC sample set
+#define BOOT_STAGE_INPUTS_READY				8      // both of the above... the pump and dish logic can decide
+#define BOOT_STAGE_FIRST_CONTROL			9      // marked by the control logic itself
+#define BOOT_MAX_STAGES						10
+
+
+void Boot_Timing_Mark(uint32_t uiStage);
+uint32_t Boot_Timing_Get_us(uint32_t uiStage);
+void Boot_Timing_Report(void);
+
+#endif /* BOOT_TIMING_H_ */
@@ -0,0 +1,695 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// The resolution, the probe count, the bus speed and MAX_ADC_SAMPLES all move the cycle time, and there
+// was no way to know the worst case of a configuration before it was on a board.  A 12 bit hold is 750ms
+// on its own, at 100 kHz the rest of the cycle doesn't fit in the second the pump and dish control runs on.
+//
+// Cycle_Budget_Estimate_Cycle() walks the same command sequence as Temperature_Initiate(),
+// Temperature_Get() and ADC_Get_Data() for a configuration and adds it up:
+//     I2C          - start, address, data and stop bits at the bus speed (the same sums as I2C_Sim.c)
+//     1-Wire wait  - the delay before each busy poll and the copy scratchpad wait
+//     Conversion   - the part of the temperature hold that isn't covered by the rest of Temperature_Initiate()
+//     CPU          - the driver's time on each transfer and the compute on each reading
+// Best, typical and worst are the cases in Cycle_Budget.h.  The busy polls come out of the 1-Wire timing,
+// a reset is 1148us and a byte is 560us on the wire, and the status is read every poll delay (100 us,
+// g_ui_0001_Second) + read.  The worst case is the fault handling at its bounds, not just a slow warm up:
+// the healthy poll limit, the config poll limit and the ADC retries are the same numbers as the firmware's.
+// The two temperature buses are worked one after the other by one task, so their time adds.
+//
+// Cycle_Budget_Check() is the worst case against a period.  Create_The_One_Shot_Temperature_Clock()
+// checks the EEPROM settings with it and refuses a setting that doesn't fit... the setting is kept, the
+// probes run at the highest resolution that does (Temperature_Resolution_Fallback()).
+//
+// On the board each phase is also measured, min / mean / max, and Cycle_Budget_Report() puts the estimate
+// and the measurement side by side.  tools/Cycle_Budget_Report.c prints the estimates for any configuration
+// on the PC, tools/I2C_Sim_Bench.c runs the firmware on the bus simulator and fails if this model, with
+// the board's configuration, doesn't bracket and track the cycle it measures.
+//
+// Overruns - the check above is for the settings, a bus fault or a busy board can still stretch a cycle.
+// Each acquisition (Temperature_Initiate() start to Temperature_Get() end, the hold included) is measured
+// against the period.  An acquisition over the period is an overrun and steps the degrade level up,
+// the work that isn't control critical is shed until the cycles fit again:
+//     Tracking  - the PROBE_CLASS_TRACKING probes' period is 4 times longer
+//     ADC       - and ADC_Get_Data() takes half the samples
+//     Minimum   - tracking probes at 16 times their period, CYCLE_DEGRADE_MIN_ADC_SAMPLES samples
+// The level steps back down one at a time after Recover Cycles acquisitions in a row that are under
+// CYCLE_DEGRADE_RECOVER_PERCENT of the period.  If a step down is followed by an overrun before another
+// Recover Cycles have gone by, the board can't hold that level yet and Recover Cycles doubles.
+// Every level change goes in the event log.
+//
+// The model has no TI dependencies... build with CYCLE_BUDGET_MODEL_ONLY for the model alone.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#if !defined(CYCLE_BUDGET_MODEL_ONLY)
+#include <xdc/std.h>
+
+#include "constants.h"
+#include "globals.h"
+
+#include "Telemetry.h"
+#include "I2C_HAL.h"
+#include "Event_Log.h"
+#endif
+
+#include "Cycle_Budget.h"
+
+
+
+#define CYCLE_PROBES_PER_DS2482				8
+#define CYCLE_ROM_READS_PER_CHIP			2          // TEMPERATURE_ROM_READS_PER_CHIP, each DS2482 each pass
+#define CYCLE_ONE_WIRE_RESET_NS				1148000    // tRSTL + tRSTH
+#define CYCLE_ONE_WIRE_BYTE_NS				560000     // 8 x 70us slots
+#define CYCLE_DS2482_RESET_NS				1000       // tRST, done by the first poll
+
+// the fault bounds in Temperature_Interface.c and ADC_Interface.c, the worst case is built from them
+#define CYCLE_HEALTHY_POLL_LIMIT			20         // a_uiBusy_Poll_Limit[PROBE_HEALTHY]
+#define CYCLE_CONFIG_MAX_POLLS				100        // TEMPERATURE_CONFIG_MAX_POLLS
+#define CYCLE_ADC_ATTEMPTS_PER_SAMPLE		2          // ADC_ATTEMPTS_PER_SAMPLE
+
+// defaults until the board's own numbers say otherwise (Cycle_Budget_Report(), Perf_Instrument)
+#define CYCLE_DEFAULT_POLL_DELAY_NS			100000     // g_ui_0001_Second, 100 us
+#define CYCLE_DEFAULT_COPY_WAIT_NS			2000000    // 2 x g_ui_001_Second
+#define CYCLE_DEFAULT_TRANSFER_CPU_NS		25000
+#define CYCLE_DEFAULT_PROBE_CPU_NS			50000
+#define CYCLE_DEFAULT_ADC_CHANNEL_CPU_NS	20000
+#define CYCLE_DEFAULT_ADC_CHANNELS			8
+#define CYCLE_DEFAULT_ADC_SAMPLES			10
+
+
+// ns, accumulated while the sequence is walked
+typedef struct
+{
+	uint64_t ui64I2C_ns;
+	uint64_t ui64One_Wire_ns;
+	uint64_t ui64CPU_ns;
+	uint32_t ui32Transfers;
+} Cycle_Tally;
+
+
+typedef struct
+{
+	const Cycle_Budget_Config* pConfig;
+	uint32_t uiExtra_Polls;                 // the worst case adds one to every 1-Wire command
+	uint32_t uiFaults;                      // and a probe that dies on top of that
+	Cycle_Tally sTally;
+} Cycle_Walk;
+
+
+// the DS18B20 conversion time, 9 - 12 bits
+static const uint32_t a_uiCycle_Conversion_ms[4] = {94, 188, 375, 750};
+
+
+
+static uint64_t Cycle_Wire_ns(const Cycle_Budget_Config* pConfig, uint32_t uiWrite_Count, uint32_t uiRead_Count)
+{
+	// start, address + data at 9 bits a byte, repeated start, stop
+	uint64_t ui64Bits = 1;
+
+	if (uiWrite_Count) ui64Bits += 9 * (1 + uiWrite_Count);
+	if (uiRead_Count) ui64Bits += 9 * (1 + uiRead_Count) + (uiWrite_Count ? 1 : 0);
+	ui64Bits += 1;
+
+	return (ui64Bits * 1000000) / pConfig->uiBit_Rate_kHz;
+}
+
+
+static void Cycle_Transfer(Cycle_Walk* pWalk, uint32_t uiWrite_Count, uint32_t uiRead_Count, uint32_t uiCount)
+{
+	pWalk->sTally.ui64I2C_ns += Cycle_Wire_ns(pWalk->pConfig, uiWrite_Count, uiRead_Count) * uiCount;
+	pWalk->sTally.ui64CPU_ns += (uint64_t) pWalk->pConfig->uiTransfer_CPU_ns * uiCount;
+	pWalk->sTally.ui32Transfers += uiCount;
+}
+
+
+static void Cycle_One_Wire_Command(Cycle_Walk* pWalk, uint32_t uiWrite_Count, uint32_t ui32Busy_ns)
+{
+	// I2C_SendCommand_Generic()... the command, then delay + status read until 1WB clears
+	const Cycle_Budget_Config* pConfig = pWalk->pConfig;
+
+	uint64_t ui64Poll_ns = pConfig->uiPoll_Delay_ns + Cycle_Wire_ns(pConfig, 0, 1) + pConfig->uiTransfer_CPU_ns;
+	uint32_t uiPolls = (uint32_t) ((ui32Busy_ns + ui64Poll_ns - 1) / ui64Poll_ns);
+	if (uiPolls == 0) uiPolls = 1;
+
+	uiPolls += pWalk->uiExtra_Polls;
+
+	Cycle_Transfer(pWalk, uiWrite_Count, 0, 1);
+	Cycle_Transfer(pWalk, 0, 1, uiPolls);
+	pWalk->sTally.ui64One_Wire_ns += (uint64_t) pConfig->uiPoll_Delay_ns * uiPolls;
+}
+
+
+static void Cycle_Busy_Timeout(Cycle_Walk* pWalk)
+{
+	// Clear_1_Wire_Busy_Status() giving up... a healthy probe's full poll limit, the last thing it does this pass
+	const Cycle_Budget_Config* pConfig = pWalk->pConfig;
+
+	if (pWalk->uiFaults == false) return;
+
+	Cycle_Transfer(pWalk, 0, 1, CYCLE_HEALTHY_POLL_LIMIT);
+	pWalk->sTally.ui64One_Wire_ns += (uint64_t) pConfig->uiPoll_Delay_ns * (CYCLE_HEALTHY_POLL_LIMIT + 1);
+}
+
+
+static void Cycle_Read_Byte(Cycle_Walk* pWalk)
+{
+	// I2C_Read_Data()... read byte, read pointer to data, receive
+	Cycle_One_Wire_Command(pWalk, 1, CYCLE_ONE_WIRE_BYTE_NS);
+	Cycle_Transfer(pWalk, 2, 0, 1);
+	Cycle_Transfer(pWalk, 0, 1, 1);
+}
+
+
+static void Cycle_Channel_Select(Cycle_Walk* pWalk)
+{
+	Cycle_Transfer(pWalk, 2, 0, 1);
+	Cycle_Transfer(pWalk, 0, 1, 1);
+}
+
+
+static void Cycle_DS2482_Reset(Cycle_Walk* pWalk)
+{
+	// I2C_Reset_DS2482_And_Configure()
+	Cycle_One_Wire_Command(pWalk, 1, CYCLE_DS2482_RESET_NS);
+	Cycle_Transfer(pWalk, 2, 0, 1);
+	Cycle_Transfer(pWalk, 0, 1, 1);
+}
+
+
+static void Cycle_ROM_Read(Cycle_Walk* pWalk)
+{
+	// I2C_Get_ROM_Codes()
+	uint32_t i;
+
+	Cycle_One_Wire_Command(pWalk, 1, CYCLE_ONE_WIRE_RESET_NS);
+	Cycle_Transfer(pWalk, 0, 1, 1);
+	Cycle_One_Wire_Command(pWalk, 2, CYCLE_ONE_WIRE_BYTE_NS);
+
+	for (i = 0; i < 8; i++) Cycle_Read_Byte(pWalk);
+}
+
+
+static void Cycle_Configure(Cycle_Walk* pWalk)
+{
+	// Set_DS18B20_Configuration()... reset, skip ROM, write scratchpad + 3 bytes, reset, skip ROM, copy,
+	// the copy wait, reset and one pass of the config poll
+	uint32_t i;
+
+	Cycle_One_Wire_Command(pWalk, 1, CYCLE_ONE_WIRE_RESET_NS);
+	for (i = 0; i < 5; i++) Cycle_One_Wire_Command(pWalk, 2, CYCLE_ONE_WIRE_BYTE_NS);
+
+	Cycle_One_Wire_Command(pWalk, 1, CYCLE_ONE_WIRE_RESET_NS);
+	for (i = 0; i < 2; i++) Cycle_One_Wire_Command(pWalk, 2, CYCLE_ONE_WIRE_BYTE_NS);
+
+	pWalk->sTally.ui64One_Wire_ns += pWalk->pConfig->uiCopy_Wait_ns;
+
+	Cycle_One_Wire_Command(pWalk, 1, CYCLE_ONE_WIRE_RESET_NS);
+
+	// a probe that never answers the config poll runs it out, that's the probe's fault instead of a busy timeout
+	uint32_t uiPolls = pWalk->uiFaults ? CYCLE_CONFIG_MAX_POLLS : 1;
+	Cycle_Transfer(pWalk, 2, 0, uiPolls);
+	Cycle_Transfer(pWalk, 0, 1, uiPolls);
+}
+
+
+static void Cycle_Activate(Cycle_Walk* pWalk)
+{
+	// I2C_Activate_The_Temperatures()... reset, skip ROM, convert
+	Cycle_One_Wire_Command(pWalk, 1, CYCLE_ONE_WIRE_RESET_NS);
+	Cycle_One_Wire_Command(pWalk, 2, CYCLE_ONE_WIRE_BYTE_NS);
+	Cycle_One_Wire_Command(pWalk, 2, CYCLE_ONE_WIRE_BYTE_NS);
+}
+
+
+static void Cycle_Retrieve(Cycle_Walk* pWalk)
+{
+	// I2C_Retrieve_The_Temperatures()... reset, status, skip ROM, read scratchpad, 9 bytes
+	uint32_t i;
+
+	Cycle_One_Wire_Command(pWalk, 1, CYCLE_ONE_WIRE_RESET_NS);
+	Cycle_Transfer(pWalk, 0, 1, 1);
+	Cycle_One_Wire_Command(pWalk, 2, CYCLE_ONE_WIRE_BYTE_NS);
+	Cycle_One_Wire_Command(pWalk, 2, CYCLE_ONE_WIRE_BYTE_NS);
+
+	for (i = 0; i < 9; i++) Cycle_Read_Byte(pWalk);
+
+	pWalk->sTally.ui64CPU_ns += pWalk->pConfig->uiProbe_CPU_ns;
+}
+
+
+static uint64_t Cycle_Tally_ns(const Cycle_Tally* pTally)
+{
+	return pTally->ui64I2C_ns + pTally->ui64One_Wire_ns + pTally->ui64CPU_ns;
+}
+
+
+static void Cycle_Add(Cycle_Tally* pTotal, const Cycle_Tally* pTally)
+{
+	pTotal->ui64I2C_ns += pTally->ui64I2C_ns;
+	pTotal->ui64One_Wire_ns += pTally->ui64One_Wire_ns;
+	pTotal->ui64CPU_ns += pTally->ui64CPU_ns;
+	pTotal->ui32Transfers += pTally->ui32Transfers;
+}
+
+
+static void Cycle_Estimate_Case(const Cycle_Budget_Config* pConfig, uint32_t uiWorst, uint32_t uiADC, Cycle_Budget_Breakdown* pBreakdown)
+{
+	Cycle_Walk sWalk;
+	Cycle_Tally sTotal;
+	uint64_t ui64After_Hold_Start_ns = 0;
+	uint32_t uiROM_Reads = 0;
+	uint32_t i, j;
+
+	memset(&sWalk, 0, sizeof(sWalk));
+	memset(&sTotal, 0, sizeof(sTotal));
+	sWalk.pConfig = pConfig;
+	sWalk.uiExtra_Polls = uiWorst ? 1 : 0;
+	sWalk.uiFaults = uiWorst;
+
+	// The worst case is the warm up cycle (every probe configured, the ROM reads) with a busy poll more on
+	// every command, and every probe dying in it.  A probe that was healthy at the start of a pass gets the
+	// healthy poll limit, so each one can time out once (the ROM read doesn't stop it, so twice there) or run
+	// the config poll out.  The pass budget (TEMPERATURE_PASS_BUDGET_TICKS) can't make a pass longer than
+	// this: it only stops the probes that had already failed, and a failed probe gets 3 polls a command
+	// where the healthy one dying here gets 20.  Past this, the overrun handling below takes over.
+
+
+	// Temperature_Initiate()... the hold starts at probe 1, the rest of the pass runs under it
+	for (i = 0; i < pConfig->uiProbes; i++)
+	{
+		uint64_t ui64Before_ns = Cycle_Tally_ns(&sWalk.sTally);
+
+		if ((i % CYCLE_PROBES_PER_DS2482) == 0)
+		{
+			Cycle_DS2482_Reset(&sWalk);
+			uiROM_Reads = 0;
+		}
+
+		Cycle_Channel_Select(&sWalk);
+
+		if (uiWorst)
+		{
+			if (uiROM_Reads < CYCLE_ROM_READS_PER_CHIP)
+			{
+				Cycle_ROM_Read(&sWalk);
+				Cycle_Busy_Timeout(&sWalk);
+				uiROM_Reads++;
+			}
+
+			Cycle_Configure(&sWalk);
+		}
+
+		Cycle_Activate(&sWalk);
+		Cycle_Busy_Timeout(&sWalk);
+
+		if (i >= 1) ui64After_Hold_Start_ns += Cycle_Tally_ns(&sWalk.sTally) - ui64Before_ns;
+	}
+
+	Cycle_Add(&sTotal, &sWalk.sTally);
+
+	uint64_t ui64Hold_ns = (uint64_t) pConfig->uiHold_ms * 1000000;
+	uint64_t ui64Conversion_ns = (ui64Hold_ns > ui64After_Hold_Start_ns) ? (ui64Hold_ns - ui64After_Hold_Start_ns) : 0;
+	if (pConfig->uiProbes < 2) ui64Conversion_ns = ui64Hold_ns;
+
+
+	// Temperature_Get()
+	memset(&sWalk.sTally, 0, sizeof(sWalk.sTally));
+
+	for (i = 0; i < pConfig->uiProbes; i++)
+	{
+		Cycle_Channel_Select(&sWalk);
+		Cycle_Retrieve(&sWalk);
+		Cycle_Busy_Timeout(&sWalk);
+	}
+
+	Cycle_Add(&sTotal, &sWalk.sTally);
+
+
+	// ADC_Get_Data()... a config write then a write + read for each sample, the worst case uses every retry
+	if (uiADC)
+	{
+		uint32_t uiReads = pConfig->uiADC_Samples * (uiWorst ? CYCLE_ADC_ATTEMPTS_PER_SAMPLE : 1);
+
+		memset(&sWalk.sTally, 0, sizeof(sWalk.sTally));
+
+		for (i = 0; i < pConfig->uiADC_Channels; i++)
+		{
+			for (j = 0; j < uiReads; j++)
+			{
+				Cycle_Transfer(&sWalk, 1, 0, 1);
+				Cycle_Transfer(&sWalk, 1, 2, 1);
+			}
+
+			sWalk.sTally.ui64CPU_ns += pConfig->uiADC_Channel_CPU_ns;
+		}
+
+		Cycle_Add(&sTotal, &sWalk.sTally);
+	}
+
+
+	pBreakdown->ui32I2C_us = (uint32_t) (sTotal.ui64I2C_ns / 1000);
+	pBreakdown->ui32One_Wire_us = (uint32_t) (sTotal.ui64One_Wire_ns / 1000);
+	pBreakdown->ui32Conversion_us = (uint32_t) (ui64Conversion_ns / 1000);
+	pBreakdown->ui32CPU_us = (uint32_t) (sTotal.ui64CPU_ns / 1000);
+	pBreakdown->ui32Total_us = (uint32_t) ((Cycle_Tally_ns(&sTotal) + ui64Conversion_ns) / 1000);
+	pBreakdown->ui32Transfers = sTotal.ui32Transfers;
+}
+
+
+void Cycle_Budget_Default_Config(Cycle_Budget_Config* pConfig, uint32_t uiResolution, uint32_t uiBit_Rate_kHz)
+{
+	// the board as it ships... 16 probes, 8 dish channels, the DS18B20 conversion time as the hold
+	if (uiResolution > 3) uiResolution = 0;
+
+	pConfig->uiResolution = uiResolution;
+	pConfig->uiProbes = 16;
+	pConfig->uiBit_Rate_kHz = uiBit_Rate_kHz ? uiBit_Rate_kHz : 100;
+	pConfig->uiADC_Channels = CYCLE_DEFAULT_ADC_CHANNELS;
+	pConfig->uiADC_Samples = CYCLE_DEFAULT_ADC_SAMPLES;
+	pConfig->uiHold_ms = a_uiCycle_Conversion_ms[uiResolution];
+	pConfig->uiPoll_Delay_ns = CYCLE_DEFAULT_POLL_DELAY_NS;
+	pConfig->uiCopy_Wait_ns = CYCLE_DEFAULT_COPY_WAIT_NS;
+	pConfig->uiTransfer_CPU_ns = CYCLE_DEFAULT_TRANSFER_CPU_NS;
+	pConfig->uiProbe_CPU_ns = CYCLE_DEFAULT_PROBE_CPU_NS;
+	pConfig->uiADC_Channel_CPU_ns = CYCLE_DEFAULT_ADC_CHANNEL_CPU_NS;
+}
+
+
+void Cycle_Budget_Estimate_Cycle(const Cycle_Budget_Config* pConfig, Cycle_Budget_Estimate* pEstimate)
+{
+	memset(pEstimate, 0, sizeof(Cycle_Budget_Estimate));
+
+	if ((pConfig->uiBit_Rate_kHz == 0) || (pConfig->uiResolution > 3)) return;
+
+	Cycle_Estimate_Case(pConfig, false, false, &pEstimate->sBest);
+	Cycle_Estimate_Case(pConfig, false, true, &pEstimate->sTypical);
+	Cycle_Estimate_Case(pConfig, true, true, &pEstimate->sWorst);
+}
+
+
+uint32_t Cycle_Budget_Check(const Cycle_Budget_Config* pConfig, uint32_t uiPeriod_ms)
+{
+	// 0 if the worst case fits in the period
+	Cycle_Budget_Estimate sEstimate;
+
+	if ((pConfig->uiBit_Rate_kHz == 0) || (pConfig->uiResolution > 3)) return CYCLE_BUDGET_ERR_INVALID;
+
+	Cycle_Budget_Estimate_Cycle(pConfig, &sEstimate);
+
+	if (sEstimate.sWorst.ui32Total_us > (uiPeriod_ms * 1000)) return CYCLE_BUDGET_ERR_OVER_PERIOD;
+
+	return 0;
+}
+
+
+
+#if !defined(CYCLE_BUDGET_MODEL_ONLY)
+
+#define CYCLE_DEGRADE_RECOVER_PERCENT		75     // of the period, a clean cycle for the step down
+#define CYCLE_DEGRADE_RECOVER_MIN_CYCLES	30
+#define CYCLE_DEGRADE_RECOVER_MAX_CYCLES	960
+#define CYCLE_DEGRADE_MIN_ADC_SAMPLES		4      // the trimmed mean drops 2
+
+													  // None  Tracking  ADC  Minimum
+uint32_t a_uiDegrade_Tracking_Divisor[CYCLE_MAX_DEGRADE_LEVELS] = { 1,    4,        4,   16 };
+uint32_t a_uiDegrade_ADC_Shift[CYCLE_MAX_DEGRADE_LEVELS]        = { 0,    0,        1,   2 };   // never under CYCLE_DEGRADE_MIN_ADC_SAMPLES
+
+Cycle_Budget_Measured a_sCycle_Measured[CYCLE_MAX_PHASES];
+
+uint32_t g_uiCycle_Last_Start_Ticks;
+uint32_t g_uiCycle_Started;
+
+Cycle_Budget_Degrade_Counters g_sCycle_Degrade = { 0, 0, 0, CYCLE_DEGRADE_NONE, CYCLE_DEGRADE_NONE, 0, 0, CYCLE_DEGRADE_RECOVER_MIN_CYCLES };
+uint32_t g_uiCycle_Degrade_Enable = true;
+uint32_t g_uiCycle_Clean_Cycles;
+uint32_t g_uiCycle_Acquisitions;
+uint32_t g_uiCycle_Last_Step_Down;          // g_uiCycle_Acquisitions at the last step down
+
+// from I2C_Scheduler.c
+extern uint32_t g_uiI2C_Cycles_Per_us;
+
+const char* a_szCycle_Phase[CYCLE_MAX_PHASES] = { "    Temperature Initiate (us)",
+												  "    Temperature Get (us)",
+												  "    ADC Sample Set (us)",
+												  "    Cycle, Start To Start (us)",
+												  "    Acquisition, Initiate To Get (us)" };
+
+
+
+static void Cycle_Budget_Record(uint32_t uiPhase, uint32_t ui32Elapsed_us)
+{
+	Cycle_Budget_Measured* pMeasured = &a_sCycle_Measured[uiPhase];
+
+	if ((pMeasured->ui32Count == 0) || (ui32Elapsed_us < pMeasured->ui32Min_us)) pMeasured->ui32Min_us = ui32Elapsed_us;
+	if (ui32Elapsed_us > pMeasured->ui32Max_us) pMeasured->ui32Max_us = ui32Elapsed_us;
+
+	pMeasured->ui64Sum_us += ui32Elapsed_us;
+	pMeasured->ui32Count++;
+}
+
+
+void Cycle_Budget_Board_Config(Cycle_Budget_Config* pConfig, uint32_t uiResolution, uint32_t uiBit_Rate_kHz)
+{
+	// the defaults with what this board is actually running... the delays, the probe count and the hold
+	Cycle_Budget_Default_Config(pConfig, uiResolution, uiBit_Rate_kHz);
+
+	pConfig->uiProbes = MAX_TEMPERATURE_PROBES;
+	pConfig->uiADC_Samples = MAX_ADC_SAMPLES;
+
+	// SysCtlDelay() is 3 cycles a count
+	pConfig->uiPoll_Delay_ns = (uint32_t) (((uint64_t) g_ui_0001_Second * 3 * 1000) / g_uiI2C_Cycles_Per_us);
+	pConfig->uiCopy_Wait_ns = (uint32_t) (((uint64_t) g_ui_001_Second * 2 * 3 * 1000) / g_uiI2C_Cycles_Per_us);
+
+	if (pConfig->uiResolution <= TEMP_RESOLUTION_BITS_12)
+	{
+		pConfig->uiHold_ms = g_ui_Temperature_Clock_Delay[pConfig->uiResolution];
+	}
+}
+
+
+uint32_t Cycle_Budget_Check_Settings(uint32_t uiResolution, uint32_t uiBit_Rate_kHz)
+{
+	// for anything that changes the resolution or the bus speed... 0 if the worst case fits
+	Cycle_Budget_Config sConfig;
+
+	if (uiResolution > TEMP_RESOLUTION_BITS_12) return CYCLE_BUDGET_ERR_INVALID;
+
+	Cycle_Budget_Board_Config(&sConfig, uiResolution, uiBit_Rate_kHz);
+
+	return Cycle_Budget_Check(&sConfig, CYCLE_BUDGET_PERIOD_MS);
+}
+
+
+uint32_t Cycle_Budget_Phase_Start(uint32_t uiPhase)
+{
+	// the Initiate start is also the cycle start, start to start in ms ticks
+	if (uiPhase == CYCLE_PHASE_INITIATE)
+	{
+		uint32_t uiNow = I2C_HAL_Get_Ticks();
+
+		if (g_uiCycle_Started) Cycle_Budget_Record(CYCLE_PHASE_CYCLE, (uiNow - g_uiCycle_Last_Start_Ticks) * 1000);
+
+		g_uiCycle_Last_Start_Ticks = uiNow;
+		g_uiCycle_Started = true;
+	}
+
+	return I2C_HAL_Timestamp();
+}
+
+
+static void Cycle_Budget_Degrade_Step(uint32_t uiLevel)
+{
+	Event_Log_Push(EVENT_SOURCE_TEMPERATURE, 0, 200, CYCLE_BUDGET_ERR_OVERRUN, uiLevel, "Cycle_Budget()::Degrade Level Changed");
+
+	g_sCycle_Degrade.ui32Level = uiLevel;
+	if (uiLevel > g_sCycle_Degrade.ui32Max_Level) g_sCycle_Degrade.ui32Max_Level = uiLevel;
+
+	g_uiCycle_Clean_Cycles = 0;
+}
+
+
+static void Cycle_Budget_Degrade_Update(uint32_t ui32Acquisition_ms)
+{
+	Cycle_Budget_Degrade_Counters* pDegrade = &g_sCycle_Degrade;
+
+	g_uiCycle_Acquisitions++;
+
+	if (ui32Acquisition_ms > CYCLE_BUDGET_PERIOD_MS)
+	{
+		uint32_t ui32Overrun_ms = ui32Acquisition_ms - CYCLE_BUDGET_PERIOD_MS;
+
+		pDegrade->ui32Overruns++;
+		pDegrade->ui32Consecutive_Overruns++;
+		if (ui32Overrun_ms > pDegrade->ui32Max_Overrun_ms) pDegrade->ui32Max_Overrun_ms = ui32Overrun_ms;
+
+		g_uiCycle_Clean_Cycles = 0;
+
+		if ((g_uiCycle_Degrade_Enable == false) || (pDegrade->ui32Level >= CYCLE_DEGRADE_MINIMUM)) return;
+
+		// back up too soon after a step down, wait longer before the next one
+		if (pDegrade->ui32Level_Downs && ((g_uiCycle_Acquisitions - g_uiCycle_Last_Step_Down) <= pDegrade->ui32Recover_Cycles))
+		{
+			pDegrade->ui32Recover_Cycles *= 2;
+			if (pDegrade->ui32Recover_Cycles > CYCLE_DEGRADE_RECOVER_MAX_CYCLES) pDegrade->ui32Recover_Cycles = CYCLE_DEGRADE_RECOVER_MAX_CYCLES;
+		}
+
+		pDegrade->ui32Level_Ups++;
+		Cycle_Budget_Degrade_Step(pDegrade->ui32Level + 1);
+		return;
+	}
+
+	pDegrade->ui32Consecutive_Overruns = 0;
+
+	// inside the period but without much room... hold the level
+	if (ui32Acquisition_ms > (CYCLE_BUDGET_PERIOD_MS * CYCLE_DEGRADE_RECOVER_PERCENT) / 100)
+	{
+		g_uiCycle_Clean_Cycles = 0;
+		return;
+	}
+
+	if (pDegrade->ui32Level == CYCLE_DEGRADE_NONE) return;
+
+	g_uiCycle_Clean_Cycles++;
+	if (g_uiCycle_Clean_Cycles < pDegrade->ui32Recover_Cycles) return;
+
+	pDegrade->ui32Level_Downs++;
+	g_uiCycle_Last_Step_Down = g_uiCycle_Acquisitions;
+	Cycle_Budget_Degrade_Step(pDegrade->ui32Level - 1);
+}
+
+
+void Cycle_Budget_Phase_Stop(uint32_t uiPhase, uint32_t ui32Start)
+{
+	if (uiPhase >= CYCLE_PHASE_CYCLE) return;
+
+	Cycle_Budget_Record(uiPhase, (I2C_HAL_Timestamp() - ui32Start) / g_uiI2C_Cycles_Per_us);
+
+	// the end of Temperature_Get() is the end of the acquisition that started with the last Initiate
+	if ((uiPhase == CYCLE_PHASE_GET) && g_uiCycle_Started)
+	{
+		uint32_t ui32Acquisition_ms = I2C_HAL_Get_Ticks() - g_uiCycle_Last_Start_Ticks;
+
+		Cycle_Budget_Record(CYCLE_PHASE_ACQUISITION, ui32Acquisition_ms * 1000);
+		Cycle_Budget_Degrade_Update(ui32Acquisition_ms);
+	}
+}
+
+
+void Cycle_Budget_Set_Degrade_Enable(uint32_t uiEnable)
+{
+	// off puts everything back to full rate at once, the overruns are still counted
+	g_uiCycle_Degrade_Enable = uiEnable;
+
+	if ((uiEnable == false) && (g_sCycle_Degrade.ui32Level != CYCLE_DEGRADE_NONE))
+	{
+		Cycle_Budget_Degrade_Step(CYCLE_DEGRADE_NONE);
+	}
+}
+
+
+uint32_t Cycle_Budget_Get_Degrade_Level(void)
+{
+	return g_sCycle_Degrade.ui32Level;
+}
+
+
+uint32_t Cycle_Budget_Tracking_Divisor(void)
+{
+	// the tracking class period is multiplied by this at the current level
+	return a_uiDegrade_Tracking_Divisor[g_sCycle_Degrade.ui32Level];
+}
+
+
+uint32_t Cycle_Budget_ADC_Samples(uint32_t uiMax_Samples)
+{
+	// the samples ADC_Get_Data() takes on each channel at this level
+	uint32_t uiSamples = uiMax_Samples >> a_uiDegrade_ADC_Shift[g_sCycle_Degrade.ui32Level];
+
+	if (uiSamples < CYCLE_DEGRADE_MIN_ADC_SAMPLES) uiSamples = CYCLE_DEGRADE_MIN_ADC_SAMPLES;
+	if (uiSamples > uiMax_Samples) uiSamples = uiMax_Samples;
+
+	return uiSamples;
+}
+
+
+void Cycle_Budget_Get_Degrade_Counters(Cycle_Budget_Degrade_Counters* pCounters)
+{
+	*pCounters = g_sCycle_Degrade;
+}
+
+
+void Cycle_Budget_Get_Measured(uint32_t uiPhase, Cycle_Budget_Measured* pMeasured)
+{
+	if (uiPhase >= CYCLE_MAX_PHASES)
+	{
+		memset(pMeasured, 0, sizeof(Cycle_Budget_Measured));
+		return;
+	}
+
+	*pMeasured = a_sCycle_Measured[uiPhase];
+}
+
+
+static void Cycle_Budget_Report_Breakdown(const char* szCase, const Cycle_Budget_Breakdown* pBreakdown)
+{
+	Telemetry_Send_Output((char *) szCase);
+	Telemetry_Send_Output_Value("    Total (us): ", pBreakdown->ui32Total_us);
+	Telemetry_Send_Output_Value("    I2C (us): ", pBreakdown->ui32I2C_us);
+	Telemetry_Send_Output_Value("    1-Wire Wait (us): ", pBreakdown->ui32One_Wire_us);
+	Telemetry_Send_Output_Value("    Conversion (us): ", pBreakdown->ui32Conversion_us);
+	Telemetry_Send_Output_Value("    CPU (us): ", pBreakdown->ui32CPU_us);
+	Telemetry_Send_Output_Value("    Transfers: ", pBreakdown->ui32Transfers);
+}
+
+
+void Cycle_Budget_Report(uint32_t uiResolution, uint32_t uiBit_Rate_kHz)
+{
+	Cycle_Budget_Config sConfig;
+	Cycle_Budget_Estimate sEstimate;
+	uint32_t i;
+
+	Cycle_Budget_Board_Config(&sConfig, uiResolution, uiBit_Rate_kHz);
+	Cycle_Budget_Estimate_Cycle(&sConfig, &sEstimate);
+
+	Telemetry_Send_Output("Cycle Budget\n");
+	Telemetry_Send_Output_Value("    Resolution Index: ", sConfig.uiResolution);
+	Telemetry_Send_Output_Value("    Bus (kHz): ", sConfig.uiBit_Rate_kHz);
+	Telemetry_Send_Output_Value("    Hold (ms): ", sConfig.uiHold_ms);
+	Telemetry_Send_Output_Value("    Period (ms): ", CYCLE_BUDGET_PERIOD_MS);
+
+	Cycle_Budget_Report_Breakdown("Cycle Budget: Best (estimate)\n", &sEstimate.sBest);
+	Cycle_Budget_Report_Breakdown("Cycle Budget: Typical (estimate)\n", &sEstimate.sTypical);
+	Cycle_Budget_Report_Breakdown("Cycle Budget: Worst (estimate)\n", &sEstimate.sWorst);
+
+	Telemetry_Send_Output("Cycle Budget: Measured\n");
+
+	for (i = 0; i < CYCLE_MAX_PHASES; i++)
+	{
+		Cycle_Budget_Measured* pMeasured = &a_sCycle_Measured[i];
+
+		if (pMeasured->ui32Count == 0) continue;
+
+		Telemetry_Send_Output((char *) a_szCycle_Phase[i]);
+		Telemetry_Send_Output_Value("        Count: ", pMeasured->ui32Count);
+		Telemetry_Send_Output_Value("        Min: ", pMeasured->ui32Min_us);
+		Telemetry_Send_Output_Value("        Mean: ", (uint32_t) (pMeasured->ui64Sum_us / pMeasured->ui32Count));
+		Telemetry_Send_Output_Value("        Max: ", pMeasured->ui32Max_us);
+	}
+
+	Telemetry_Send_Output("Cycle Budget: Overruns\n");
+	Telemetry_Send_Output_Value("    Overruns: ", g_sCycle_Degrade.ui32Overruns);
+	Telemetry_Send_Output_Value("    Max Overrun (ms): ", g_sCycle_Degrade.ui32Max_Overrun_ms);
+	Telemetry_Send_Output_Value("    Degrade Level: ", g_sCycle_Degrade.ui32Level);
+	Telemetry_Send_Output_Value("    Max Degrade Level: ", g_sCycle_Degrade.ui32Max_Level);
+	Telemetry_Send_Output_Value("    Level Ups: ", g_sCycle_Degrade.ui32Level_Ups);
+	Telemetry_Send_Output_Value("    Level Downs: ", g_sCycle_Degrade.ui32Level_Downs);
+	Telemetry_Send_Output_Value("    Recover Cycles: ", g_sCycle_Degrade.ui32Recover_Cycles);
+}
+
+#endif
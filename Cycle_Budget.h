@@ -0,0 +1,122 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Cycle Budget - the time of one temperature + ADC cycle for a configuration, worked out from the
+// command sequence and measured on the running board, against the control loop period.
+//
+//*****************************************************************************
+
+#ifndef CYCLE_BUDGET_H_
+#define CYCLE_BUDGET_H_
+
+#include <stdint.h>
+
+
+#define CYCLE_BUDGET_PERIOD_MS					1000   // the one second system job, the pump and dish control
+
+// Measured phases
+#define CYCLE_PHASE_INITIATE					0      // Temperature_Initiate()
+#define CYCLE_PHASE_GET							1      // Temperature_Get()
+#define CYCLE_PHASE_ADC							2      // ADC_Get_Data()
+#define CYCLE_PHASE_CYCLE						3      // Temperature_Initiate() start to start
+#define CYCLE_PHASE_ACQUISITION					4      // Temperature_Initiate() start to Temperature_Get() end
+#define CYCLE_MAX_PHASES						5
+
+// Degrade levels - each one sheds more of the work that isn't control critical
+#define CYCLE_DEGRADE_NONE						0
+#define CYCLE_DEGRADE_TRACKING					1      // the tracking class period x 4
+#define CYCLE_DEGRADE_ADC						2      // and half the ADC samples
+#define CYCLE_DEGRADE_MINIMUM					3      // the tracking class period x 16, the fewest ADC samples
+#define CYCLE_MAX_DEGRADE_LEVELS				4
+
+// Errors
+#define CYCLE_BUDGET_ERR_OVER_PERIOD			18001
+#define CYCLE_BUDGET_ERR_INVALID				18002
+#define CYCLE_BUDGET_ERR_OVERRUN				18003  // logged on a degrade level change, the new level in the extended
+
+
+typedef struct
+{
+	uint32_t uiResolution;                  // TEMP_RESOLUTION_BITS_9 (0) to TEMP_RESOLUTION_BITS_12 (3)
+	uint32_t uiProbes;                      // 8 to a DS2482
+	uint32_t uiBit_Rate_kHz;                // 100 or 400
+	uint32_t uiADC_Channels;
+	uint32_t uiADC_Samples;                 // MAX_ADC_SAMPLES
+	uint32_t uiHold_ms;                     // the temperature hold job, the conversion time for the resolution
+	uint32_t uiPoll_Delay_ns;               // g_ui_0001_Second, before each 1-Wire busy poll
+	uint32_t uiCopy_Wait_ns;                // 2 x g_ui_001_Second, after the copy scratchpad
+	uint32_t uiTransfer_CPU_ns;             // driver time on each transfer, on top of the wire
+	uint32_t uiProbe_CPU_ns;                // CRC, decode, F and the rest for each probe reading
+	uint32_t uiADC_Channel_CPU_ns;          // trim and store for each channel
+} Cycle_Budget_Config;
+
+
+typedef struct
+{
+	uint32_t ui32I2C_us;                    // on the wire
+	uint32_t ui32One_Wire_us;               // waiting out the 1-Wire busy flag and the copy
+	uint32_t ui32Conversion_us;             // the part of the hold the temperature task sits idle
+	uint32_t ui32CPU_us;
+	uint32_t ui32Total_us;
+	uint32_t ui32Transfers;
+} Cycle_Budget_Breakdown;
+
+
+typedef struct
+{
+	Cycle_Budget_Breakdown sBest;           // every probe healthy and configured, the ADC set skipped (settled / night)
+	Cycle_Budget_Breakdown sTypical;        // every probe healthy and configured, a full ADC set
+	Cycle_Budget_Breakdown sWorst;          // the warm up cycle with a busy poll more on every 1-Wire command, every probe
+											// dying in it at the healthy poll limits, every ADC retry used
+} Cycle_Budget_Estimate;
+
+
+typedef struct
+{
+	uint32_t ui32Count;
+	uint32_t ui32Min_us;
+	uint32_t ui32Max_us;
+	uint64_t ui64Sum_us;
+} Cycle_Budget_Measured;
+
+
+typedef struct
+{
+	uint32_t ui32Overruns;                  // acquisitions longer than the period
+	uint32_t ui32Consecutive_Overruns;
+	uint32_t ui32Max_Overrun_ms;            // past the period
+	uint32_t ui32Level;
+	uint32_t ui32Max_Level;
+	uint32_t ui32Level_Ups;
+	uint32_t ui32Level_Downs;
+	uint32_t ui32Recover_Cycles;            // clean cycles before the next step down
+} Cycle_Budget_Degrade_Counters;
+
+
+// the model - no TI dependencies, the PC tools use it too
+void Cycle_Budget_Default_Config(Cycle_Budget_Config* pConfig, uint32_t uiResolution, uint32_t uiBit_Rate_kHz);
+void Cycle_Budget_Estimate_Cycle(const Cycle_Budget_Config* pConfig, Cycle_Budget_Estimate* pEstimate);
+uint32_t Cycle_Budget_Check(const Cycle_Budget_Config* pConfig, uint32_t uiPeriod_ms);
+
+
+#if !defined(CYCLE_BUDGET_MODEL_ONLY)
+
+// the board
+void Cycle_Budget_Board_Config(Cycle_Budget_Config* pConfig, uint32_t uiResolution, uint32_t uiBit_Rate_kHz);
+uint32_t Cycle_Budget_Check_Settings(uint32_t uiResolution, uint32_t uiBit_Rate_kHz);
+
+uint32_t Cycle_Budget_Phase_Start(uint32_t uiPhase);
+void Cycle_Budget_Phase_Stop(uint32_t uiPhase, uint32_t ui32Start);
+void Cycle_Budget_Get_Measured(uint32_t uiPhase, Cycle_Budget_Measured* pMeasured);
+void Cycle_Budget_Report(uint32_t uiResolution, uint32_t uiBit_Rate_kHz);
+
+void Cycle_Budget_Set_Degrade_Enable(uint32_t uiEnable);
+uint32_t Cycle_Budget_Get_Degrade_Level(void);
+uint32_t Cycle_Budget_Tracking_Divisor(void);
+uint32_t Cycle_Budget_ADC_Samples(uint32_t uiMax_Samples);
+void Cycle_Budget_Get_Degrade_Counters(Cycle_Budget_Degrade_Counters* pCounters);
+
+#endif
+
+#endif /* CYCLE_BUDGET_H_ */
@@ -71,6 +71,16 @@
 #include "Telemetry.h"
 #include "Console_Interface.h"
 #include "Temperature_Interface.h"
+#include "I2C_Scheduler.h"
+#include "Logger_Output.h"
+#include "Job_Scheduler.h"
+#include "Event_Log.h"
+#include "Flash_Datalogger.h"
+#include "Telemetry_Publisher.h"
+#include "Static_Footprint.h"
+#include "Boot_Timing.h"
+#include "Perf_Instrument.h"
+#include "Cycle_Budget.h"
 
 
 // from main.c
@@ -80,6 +90,9 @@ void Timer_Startup(void);
 void Timer_One_Second_System(void);
 void Timer_LED_Blink(void);
 
+// from Temperature_Interface.c
+uint32_t Temperature_Resolution_Fallback(uint32_t uiResolution);
+
 
 int Create_The_One_Shot_Temperature_Clock(void)
 {
@@ -93,44 +106,47 @@ int Create_The_One_Shot_Temperature_Clock(void)
 	}
 
 
+	// the worst case cycle at this resolution and bus speed has to fit in the control period...
+	// if it doesn't the setting is refused for now and the highest resolution that fits is run instead.
+	// The EEPROM setting is left alone, Temperature_Set_Resolution() falls back the same way
+	// (Temperature_Resolution_Fallback()) when Temperature_Initialize() is given it.
+	I2C_Bus_Counters sBus_Counters;
+	I2C_Scheduler_Get_Counters(I2C_BUS_TEMPERATURE_0_7, &sBus_Counters);
 
-	uint32_t uint32Temperature_Clock_Delay = g_ui_Temperature_Clock_Delay[uiResolution];
-
-
-	if (g_Clock_Temperature_OneShot_Handle)  // does this already exist?
+	uint32_t uiRunning = Temperature_Resolution_Fallback(uiResolution);
+	if (uiRunning != uiResolution)
 	{
-		uint32_t uiClock_Timeout = Clock_getTimeout(g_Clock_Temperature_OneShot_Handle);
-
-		if (uiClock_Timeout == uint32Temperature_Clock_Delay)  // clocks equal??
-		{
-			//Telemetry_Dump_Clock_Settings("Create_The_One_Shot_Temperature_Clock / Update", g_Clock_Temperature_OneShot_Handle);
-			return 0;  // if so, get out...
-		}
+		Telemetry_Send_Output_Value("Driver_Setup()::Create_The_One_Shot_Temperature_Clock  Over The Cycle Budget, Refused Resolution Index (EEPROM Setting Kept): ", uiResolution);
+		Telemetry_Send_Output_Value("Driver_Setup()::Create_The_One_Shot_Temperature_Clock  Running At Resolution Index: ", uiRunning);
 
-		// if not, change the clocks...
-		Clock_delete(&g_Clock_Temperature_OneShot_Handle);
-		g_Clock_Temperature_OneShot_Handle = NULL;
+		uiResolution = uiRunning;
 	}
 
+	Cycle_Budget_Report(uiResolution, sBus_Counters.ui32Bit_Rate_kHz);
 
 
-	Error_Block eb;
- 	Error_init(&eb);
 
- 	Clock_Params clockParams;
+	uint32_t uint32Temperature_Clock_Delay = g_ui_Temperature_Clock_Delay[uiResolution];
 
- 	Clock_Params_init(&clockParams);
- 	clockParams.period = 0;
- 	clockParams.startFlag = FALSE;
- 	g_Clock_Temperature_OneShot_Handle = Clock_create( (Clock_FuncPtr) Clock_Temperature_Hold, uint32Temperature_Clock_Delay, &clockParams, &eb);
- 	if (!g_Clock_Temperature_OneShot_Handle)
- 	{
- 		Telemetry_Send_Output("Driver_Setup()::Create_The_One_Shot_Temperature_Clock()  Error: Unable To Create!...\n");
- 		return 10;
- 	}
 
- 	//Telemetry_Dump_Clock_Settings("Create_The_One_Shot_Temperature_Clock", g_Clock_Temperature_OneShot_Handle);
+	// the hold is a one shot job on the scheduler's wheel... Temperature_Initiate() starts it
+	if (Job_Scheduler_Get_Period(JOB_TEMPERATURE_HOLD) == uint32Temperature_Clock_Delay)  // delays equal??
+	{
+		return 0;  // if so, get out...
+	}
 
+	// if not, change the delay in place... a waiting hold keeps the delay it was started with
+	uint32_t ui32Error = Job_Scheduler_Set_Period(JOB_TEMPERATURE_HOLD, uint32Temperature_Clock_Delay);
+	if (ui32Error == JOB_SCHEDULER_ERR_NOT_DEFINED)
+	{
+		ui32Error = Job_Scheduler_Define_One_Shot(JOB_TEMPERATURE_HOLD, "Temperature Hold", Clock_Temperature_Hold, uint32Temperature_Clock_Delay, JOB_NO_BUDGET);
+	}
+
+	if (ui32Error)
+	{
+		Telemetry_Send_Output_Value("Driver_Setup()::Create_The_One_Shot_Temperature_Clock()  Error: Unable To Define The Job!... ", ui32Error);
+		return 10;
+	}
 
  	return 0;
 }
@@ -161,18 +177,26 @@ int Create_The_One_Shot_ADC_Clock(void)
 
 int Create_Timer_One_Second_System(void)
 {
-	Error_Block eb;
- 	Error_init(&eb);
+	uint32_t ui32Error = Job_Scheduler_Define_Periodic(JOB_ONE_SECOND_SYSTEM, "One Second System", Timer_One_Second_System, 1000, JOB_PHASE_ONE_SECOND_SYSTEM, JOB_NO_BUDGET);
+	if (ui32Error == 0) ui32Error = Job_Scheduler_Start(JOB_ONE_SECOND_SYSTEM);
+ 	if (ui32Error)
+ 	{
+ 		Telemetry_Send_Output_Value("Driver_Setup()::Create_Timer_One_Second_System()  Error: Unable To Create!... ", ui32Error);
+ 		return 10;
+ 	}
 
- 	Clock_Params clockParams;
+ 	return NO_ERRORS;
+}
 
- 	Clock_Params_init(&clockParams);
- 	clockParams.period = 1000;
- 	clockParams.startFlag = TRUE;
- 	g_Clock_One_Second_Timer_Handle = Clock_create( (Clock_FuncPtr) Timer_One_Second_System, 1, &clockParams, &eb);
- 	if (!g_Clock_One_Second_Timer_Handle)
+
+int Create_Timer_LED_Blink(void)
+{
+	// a phase of its own, so it never lands on the same tick as the one second job
+	uint32_t ui32Error = Job_Scheduler_Define_Periodic(JOB_LED_BLINK, "LED Blink", Timer_LED_Blink, 250, JOB_PHASE_LED_BLINK, JOB_NO_BUDGET);
+	if (ui32Error == 0) ui32Error = Job_Scheduler_Start(JOB_LED_BLINK);
+ 	if (ui32Error)
  	{
- 		Telemetry_Send_Output("Driver_Setup()::Create_Timer_One_Second_System()  Error: Unable To Create!...\n");
+ 		Telemetry_Send_Output_Value("Driver_Setup()::Create_Timer_LED_Blink()  Error: Unable To Create!... ", ui32Error);
  		return 10;
  	}
 
@@ -180,20 +204,47 @@ int Create_Timer_One_Second_System(void)
 }
 
 
-int Create_Timer_LED_Blink(void)
+
+int Create_Event_Log_Drain(void)
 {
-	Error_Block eb;
- 	Error_init(&eb);
+	// the events the acquisition tasks push are written out by a low priority task, this job wakes it
+	Event_Log_Start_Drain_Task(EVENT_LOG_DRAIN_PRIORITY);
 
- 	Clock_Params clockParams;
+	uint32_t ui32Error = Job_Scheduler_Define_Periodic(JOB_EVENT_LOG_DRAIN, "Event Log Drain", Event_Log_Wake_Drain, EVENT_LOG_DRAIN_TICKS, JOB_PHASE_EVENT_LOG_DRAIN, JOB_NO_BUDGET);
+	if (ui32Error == 0) ui32Error = Job_Scheduler_Start(JOB_EVENT_LOG_DRAIN);
+ 	if (ui32Error)
+ 	{
+ 		Telemetry_Send_Output_Value("Driver_Setup()::Create_Event_Log_Drain()  Error: Unable To Create!... ", ui32Error);
+ 		return 10;
+ 	}
 
- 	Clock_Params_init(&clockParams);
- 	clockParams.period = 250;
- 	clockParams.startFlag = TRUE;
- 	g_Clock_One_Second_Timer_Handle = Clock_create( (Clock_FuncPtr) Timer_LED_Blink, 1, &clockParams, &eb);
- 	if (!g_Clock_One_Second_Timer_Handle)
+ 	return NO_ERRORS;
+}
+
+
+
+int Create_Flash_Datalogger(void)
+{
+	// find where the log left off, and send what it held before the reset out the frame port
+	uint32_t ui32Error = Flash_Datalogger_Mount();
+	if (ui32Error)
+	{
+		// Log_Telemetry() refuses until a mount works... no log is no reason to hold the pumps off
+		Telemetry_Send_Output_Value("Driver_Setup()::Create_Flash_Datalogger()  Mount Error, Not Logging: ", ui32Error);
+	}
+	else
+	{
+		Flash_Datalogger_Dump_Recent(FLASH_LOG_BOOT_DUMP_RECORDS);
+	}
+
+	// the flash work is done by a low priority task, this job wakes it
+	Flash_Datalogger_Start_Task(FLASH_LOG_PRIORITY);
+
+	ui32Error = Job_Scheduler_Define_Periodic(JOB_FLASH_DATALOGGER, "Flash Datalogger", Flash_Datalogger_Wake, FLASH_LOG_TICKS, JOB_PHASE_FLASH_DATALOGGER, JOB_NO_BUDGET);
+	if (ui32Error == 0) ui32Error = Job_Scheduler_Start(JOB_FLASH_DATALOGGER);
+ 	if (ui32Error)
  	{
- 		Telemetry_Send_Output("Driver_Setup()::Create_Timer_LED_Blink()  Error: Unable To Create!...\n");
+ 		Telemetry_Send_Output_Value("Driver_Setup()::Create_Flash_Datalogger()  Error: Unable To Create!... ", ui32Error);
  		return 10;
  	}
 
@@ -202,6 +253,23 @@ int Create_Timer_LED_Blink(void)
 
 
 
+int Create_Telemetry_Publisher(void)
+{
+	// the temperature and dish frames (keyframes and deltas) are built and sent by a low priority task, this job wakes it
+	Telemetry_Publisher_Start_Task(TELEMETRY_PUBLISHER_PRIORITY);
+
+	uint32_t ui32Error = Job_Scheduler_Define_Periodic(JOB_TELEMETRY_PUBLISHER, "Telemetry Publisher", Telemetry_Publisher_Wake, TELEMETRY_PUBLISHER_TICKS, JOB_PHASE_TELEMETRY_PUBLISHER, JOB_NO_BUDGET);
+	if (ui32Error == 0) ui32Error = Job_Scheduler_Start(JOB_TELEMETRY_PUBLISHER);
+ 	if (ui32Error)
+ 	{
+ 		Telemetry_Send_Output_Value("Driver_Setup()::Create_Telemetry_Publisher()  Error: Unable To Create!... ", ui32Error);
+ 		return 10;
+ 	}
+
+ 	return NO_ERRORS;
+}
+
+
 
 void ReadCallBack(void)
 {
@@ -217,9 +285,63 @@ void ReadCallBack(void)
 int Driver_Setup(void)
 {
 
+	Boot_Timing_Mark(BOOT_STAGE_START);
+	Perf_Instrument_Initialize();      // nothing unless built with PERF_INSTRUMENT
+
 	Telemetry_Send_Output("Driver_Setup()  Begin...\n");
 
 
+	// Pumps first... every pump output is at a known, off state before anything else can fail
+	PWM_Params      params;
+
+	PWM_Params_init(&params);
+	params.period = PWM_PERIOD;					// Period in microseconds
+	params.dutyMode = PWM_DUTY_TIME;		// Duty specified in microseconds
+	g_PWM_Handle_Dish_Pump = PWM_open(Board_PWM3, &params);
+	if (!g_PWM_Handle_Dish_Pump)
+	{
+		Telemetry_Send_Output("Driver_Setup()::Exit on PWM3 Setup (Dish Pump) ..\n");
+		return 100;
+	}
+	PWM_setDuty(g_PWM_Handle_Dish_Pump, 0);
+
+
+	params.period = PWM_PERIOD;					// Period in microseconds
+	params.dutyMode = PWM_DUTY_TIME;		// Duty specified in microseconds
+	g_PWM_Handle_Immediate_Pump = PWM_open(Board_PWM2, &params);
+	if (!g_PWM_Handle_Immediate_Pump)
+	{
+		Telemetry_Send_Output("Driver_Setup()::Exit on PWM2 Setup (Immediate Pump)..\n");
+		return 110;
+	}
+	PWM_setDuty(g_PWM_Handle_Immediate_Pump, 0);
+
+
+	params.period = PWM_PERIOD;					// Period in microseconds
+	params.dutyMode = PWM_DUTY_TIME;		// Duty specified in microseconds
+	g_PWM_Handle_Hold_Pump = PWM_open(Board_PWM1, &params);
+	if (!g_PWM_Handle_Hold_Pump)
+	{
+		Telemetry_Send_Output("Driver_Setup()::Exit on PWM1 Setup (Hold Pump)..\n");
+		return 120;
+	}
+	PWM_setDuty(g_PWM_Handle_Hold_Pump, 0);
+
+
+	params.period = PWM_PERIOD;					// Period in microseconds
+	params.dutyMode = PWM_DUTY_TIME;		// Duty specified in microseconds
+	g_PWM_Handle_AUX_Pump = PWM_open(Board_PWM0, &params);
+	if (!g_PWM_Handle_AUX_Pump)
+	{
+		Telemetry_Send_Output("Driver_Setup()::Exit on PWM0 Setup (AUX Pump)..\n");
+		return 130;
+	}
+	PWM_setDuty(g_PWM_Handle_AUX_Pump, 0);
+
+	Boot_Timing_Mark(BOOT_STAGE_PUMPS_SAFE);
+
+
+
 	// Setup UARTS for Reporting and Console
 
 
@@ -248,9 +370,13 @@ int Driver_Setup(void)
  	}
 
 
+	// the loggers are blocking, Telemetry_Send_Output() writes them directly... the frames go through
+	// Logger_Output.  Only the priority 1 tasks write them after boot (Logger_Output.c).
+	Logger_Output_Initialize();
+
 	UART_Parameters.readMode = UART_MODE_BLOCKING;
-	UART_Parameters.writeMode = UART_MODE_BLOCKING;
 	UART_Parameters.readCallback = 0;
+	UART_Parameters.writeMode = UART_MODE_BLOCKING;
 	UART_Parameters.writeCallback = 0;
  	UART_Parameters.readEcho = UART_ECHO_OFF;  // Logger is Off
  	g_UART_Handle_Logger = UART_open(UART_LOGGER, &UART_Parameters);
@@ -260,10 +386,12 @@ int Driver_Setup(void)
  		return 20;
  	}
 
+ 	Logger_Output_Attach(LOGGER_PORT_LOGGER, g_UART_Handle_Logger);
+
  	/* TEST!!!!!!!!!!!!!!!! */
 	UART_Parameters.readMode = UART_MODE_BLOCKING;
-	UART_Parameters.writeMode = UART_MODE_BLOCKING;
 	UART_Parameters.readCallback = 0;
+	UART_Parameters.writeMode = UART_MODE_BLOCKING;
 	UART_Parameters.writeCallback = 0;
  	UART_Parameters.readEcho = UART_ECHO_OFF;  // Logger is Off
  	g_UART_Handle_Test_Logger = UART_open(UART_TEST, &UART_Parameters);
@@ -273,46 +401,57 @@ int Driver_Setup(void)
  		return 30;
  	}
 
+ 	Logger_Output_Attach(LOGGER_PORT_TEST, g_UART_Handle_Test_Logger);
+
+ 	Boot_Timing_Mark(BOOT_STAGE_UARTS);
+
 
 
 
  	// Setup I2C...
-	I2C_Params I2C_Parameters;
+ 	// The I2C Scheduler opens the buses at the configured speed (100 or 400 kHz) and drops a bus back
+ 	// to 100 kHz on its own if the error rate climbs.  The speeds are the I2C_FAST_MODE_ defaults for
+ 	// now, the EEPROM data has no field for them yet.
+ 	// A fallback re-opens the bus with a new handle, so the handles are not kept here (g_I2C_Handle_0_7,
+ 	// g_I2C_Handle_8_15 and g_I2C_ADC_Handle stay NULL)... I2C_Scheduler_Get_Handle() is the only source.
+ 	I2C_Scheduler_Initialize();
+
+ 	I2C_Scheduler_Configure_Bus_Speed(I2C_BUS_TEMPERATURE_0_7, I2C_FAST_MODE_TEMPERATURE_0_7);
+ 	I2C_Scheduler_Configure_Bus_Speed(I2C_BUS_TEMPERATURE_8_15, I2C_FAST_MODE_TEMPERATURE_8_15);
+ 	I2C_Scheduler_Configure_Bus_Speed(I2C_BUS_ADC, I2C_FAST_MODE_ADC);
 
 
- 	I2C_Params_init(&I2C_Parameters);
- 	I2C_Parameters.transferMode  = I2C_MODE_BLOCKING;
- 	I2C_Parameters.transferCallbackFxn = NULL;   // Temperature_CallBack_Handler;
- 	I2C_Parameters.bitRate = I2C_100kHz;
- 	g_I2C_Handle_0_7 = I2C_open(Board_I2C0, &I2C_Parameters);
- 	if (!g_I2C_Handle_0_7)
+ 	if (!I2C_Scheduler_Open_Bus(I2C_BUS_TEMPERATURE_0_7, Board_I2C0))
  	{
  		Telemetry_Send_Output("Driver_Setup()  Exit on I2C (Temperatures... 0-7) Setup...\n");
  		return 40;
  	}
 
 
- 	I2C_Parameters.transferMode  = I2C_MODE_BLOCKING;
- 	I2C_Parameters.transferCallbackFxn = NULL;   // Temperature_CallBack_Handler;
- 	I2C_Parameters.bitRate = I2C_100kHz;
- 	g_I2C_Handle_8_15 = I2C_open(Board_I2C1, &I2C_Parameters);
- 	if (!g_I2C_Handle_8_15)
+ 	if (!I2C_Scheduler_Open_Bus(I2C_BUS_TEMPERATURE_8_15, Board_I2C1))
  	{
  		Telemetry_Send_Output("Driver_Setup()  Exit on I2C (Temperatures... 8-15) Setup...\n");
  		return 50;
  	}
 
 
- 	I2C_Parameters.transferMode  = I2C_MODE_BLOCKING;
- 	I2C_Parameters.transferCallbackFxn = NULL;   // ADC_CallBack_Handler;
- 	I2C_Parameters.bitRate = I2C_100kHz;
- 	g_I2C_ADC_Handle = I2C_open(Board_I2C2, &I2C_Parameters);
- 	if (!g_I2C_ADC_Handle)
+ 	if (!I2C_Scheduler_Open_Bus(I2C_BUS_ADC, Board_I2C2))
  	{
  		Telemetry_Send_Output("Driver_Setup()  Exit on I2C (ADC) Setup...\n");
  		return 60;
  	}
 
+ 	Boot_Timing_Mark(BOOT_STAGE_I2C);
+
+
+
+	// one Clock for every timed job (temperature hold, one second system, LED blink)
+	if (Job_Scheduler_Initialize())
+	{
+ 		Telemetry_Send_Output("Driver_Setup()::Job_Scheduler_Initialize()   Error on Setup..\n");
+ 		return 65;
+	}
+
 
 
 	int iRtn = Create_The_One_Shot_Temperature_Clock();
@@ -342,57 +481,43 @@ int Driver_Setup(void)
 
 
 
-	PWM_Params      params;
-
-	PWM_Params_init(&params);
-	params.period = PWM_PERIOD;					// Period in microseconds
-	params.dutyMode = PWM_DUTY_TIME;		// Duty specified in microseconds
-	g_PWM_Handle_Dish_Pump = PWM_open(Board_PWM3, &params);
-	if (!g_PWM_Handle_Dish_Pump)
+	iRtn = Create_Event_Log_Drain();
+	if (iRtn)
 	{
-		Telemetry_Send_Output("Driver_Setup()::Exit on PWM3 Setup (Dish Pump) ..\n");
-		return 100;
+ 		Telemetry_Send_Output("Driver_Setup()::Create_Event_Log_Drain()   Error on Setup..\n");
+ 		return 95;
 	}
-	PWM_setDuty(g_PWM_Handle_Dish_Pump, 0);
 
 
-	params.period = PWM_PERIOD;					// Period in microseconds
-	params.dutyMode = PWM_DUTY_TIME;		// Duty specified in microseconds
-	g_PWM_Handle_Immediate_Pump = PWM_open(Board_PWM2, &params);
-	if (!g_PWM_Handle_Immediate_Pump)
+
+	iRtn = Create_Flash_Datalogger();
+	if (iRtn)
 	{
-		Telemetry_Send_Output("Driver_Setup()::Exit on PWM2 Setup (Immediate Pump)..\n");
-		return 110;
+ 		Telemetry_Send_Output("Driver_Setup()::Create_Flash_Datalogger()   Error on Setup..\n");
+ 		return 97;
 	}
-	PWM_setDuty(g_PWM_Handle_Immediate_Pump, 0);
 
 
-	params.period = PWM_PERIOD;					// Period in microseconds
-	params.dutyMode = PWM_DUTY_TIME;		// Duty specified in microseconds
-	g_PWM_Handle_Hold_Pump = PWM_open(Board_PWM1, &params);
-	if (!g_PWM_Handle_Hold_Pump)
+
+	iRtn = Create_Telemetry_Publisher();
+	if (iRtn)
 	{
-		Telemetry_Send_Output("Driver_Setup()::Exit on PWM1 Setup (Hold Pump)..\n");
-		return 120;
+ 		Telemetry_Send_Output("Driver_Setup()::Create_Telemetry_Publisher()   Error on Setup..\n");
+ 		return 98;
 	}
-	PWM_setDuty(g_PWM_Handle_Hold_Pump, 0);
 
+	Boot_Timing_Mark(BOOT_STAGE_TIMERS);
 
-	params.period = PWM_PERIOD;					// Period in microseconds
-	params.dutyMode = PWM_DUTY_TIME;		// Duty specified in microseconds
-	g_PWM_Handle_AUX_Pump = PWM_open(Board_PWM0, &params);
-	if (!g_PWM_Handle_AUX_Pump)
-	{
-		Telemetry_Send_Output("Driver_Setup()::Exit on PWM0 Setup (AUX Pump)..\n");
-		return 130;
-	}
-	PWM_setDuty(g_PWM_Handle_AUX_Pump, 0);
 
 
+	// what the modules hold in static RAM (the budgets are checked at compile time)
+	Static_Footprint_Report();
 
 
  	Telemetry_Send_Output("Driver_Setup()  All Drivers Created Successfully!\n");
 
+ 	Boot_Timing_Mark(BOOT_STAGE_DRIVERS_DONE);
+
 
 
  	return 0;
@@ -0,0 +1,222 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// This module replaces the text building that used to happen inside Temperature_Log_Message().
+//
+// That routine ran four ltoa() calls and a chain of strcpy/strcat on the stack, then blocked on
+// Telemetry_Send_Output() - all from inside the I2C hot path.  Turning logging on changed the timing
+// of the very thing being logged.
+//
+// Now an event is a fixed size binary record (time, probe, location, error, extended and a pointer to
+// static text).  Pushing one is a handful of stores into a ring buffer.  Event_Log_Drain() is called
+// from a low priority task and does the formatting and the output.
+//
+// That task is here (Event_Log_Start_Drain_Task(), constructed in place like the job scheduler's Clock).
+// JOB_EVENT_LOG_DRAIN wakes it every EVENT_LOG_DRAIN_TICKS and it writes at most EVENT_LOG_DRAIN_RECORDS
+// each time, so a burst of errors goes out over a few wake ups instead of holding the logger port.
+//
+// There is one ring for each source.  Each source is written by one task and the drain is the only
+// reader, so every ring is single producer / single consumer and needs no lock.  The producer only
+// moves the head, the consumer only moves the tail.  When a ring is full the new event is dropped
+// and counted, the producer never waits.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <xdc/std.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/knl/Task.h>
+#include <ti/sysbios/knl/Semaphore.h>
+
+#include "constants.h"
+#include "globals.h"
+
+#include "Telemetry.h"
+#include "Event_Log.h"
+#include "Acquisition_Kernels.h"
+#include "Job_Scheduler.h"
+#include "I2C_HAL.h"
+#include "Static_Footprint.h"
+
+
+
+#define EVENT_LOG_SIZE						64     // records per source, power of 2
+#define EVENT_LOG_MASK						(EVENT_LOG_SIZE - 1)
+
+#define EVENT_LOG_DRAIN_STACK				1024   // bytes, the format buffer and Telemetry_Send_Output()
+#define EVENT_LOG_DRAIN_RECORDS				16     // per wake up
+
+
+typedef struct
+{
+	volatile uint32_t uiHead;           // next slot to write - producer only
+	volatile uint32_t uiTail;           // next slot to read  - consumer only
+	volatile uint32_t uiDropped;
+	volatile Event_Record a_sRecords[EVENT_LOG_SIZE];
+} Event_Ring;
+
+
+Event_Ring a_sEvent_Ring[EVENT_LOG_MAX_SOURCES];
+
+const char* a_szEvent_Source[EVENT_LOG_MAX_SOURCES] = { "TEMP", "ADC" };
+
+Task_Struct g_sEvent_Log_Drain_Task;
+Semaphore_Struct g_sEvent_Log_Drain_Semaphore;
+uint64_t a_ui64Event_Log_Drain_Stack[EVENT_LOG_DRAIN_STACK / sizeof(uint64_t)];   // 8 byte aligned
+
+const uint32_t g_uiEvent_Log_Static_Bytes = sizeof(a_sEvent_Ring) + sizeof(a_ui64Event_Log_Drain_Stack);
+STATIC_FOOTPRINT_CHECK((sizeof(a_sEvent_Ring) + sizeof(a_ui64Event_Log_Drain_Stack)) <= STATIC_BUDGET_EVENT_LOG, Event_Log);
+
+
+
+void Event_Log_Push(uint32_t uiSource, uint32_t uiProbe, uint32_t uiLocation, uint32_t ui32ErrorCode, uint32_t ui32Extended, const char* szMessage)
+{
+	if (uiSource >= EVENT_LOG_MAX_SOURCES) return;
+
+	Event_Ring* pRing = &a_sEvent_Ring[uiSource];
+
+	uint32_t uiHead = pRing->uiHead;
+
+	if ((uiHead - pRing->uiTail) >= EVENT_LOG_SIZE)
+	{
+		// full... drop it, never wait in the hot path
+		pRing->uiDropped++;
+		return;
+	}
+
+	volatile Event_Record* pRecord = &pRing->a_sRecords[uiHead & EVENT_LOG_MASK];
+
+	pRecord->ui32Timestamp = I2C_HAL_Get_Ticks();
+	pRecord->szMessage = szMessage;
+	pRecord->ui32ErrorCode = ui32ErrorCode;
+	pRecord->ui32Extended = ui32Extended;
+	pRecord->ui16Location = (uint16_t) uiLocation;
+	pRecord->ui8Probe = (uint8_t) uiProbe;
+	pRecord->ui8Source = (uint8_t) uiSource;
+
+	// the record is complete before the consumer can see it
+	pRing->uiHead = uiHead + 1;
+}
+
+
+uint32_t Event_Log_Pop(uint32_t uiSource, Event_Record* pRecord)
+{
+	if (uiSource >= EVENT_LOG_MAX_SOURCES) return false;
+
+	Event_Ring* pRing = &a_sEvent_Ring[uiSource];
+
+	uint32_t uiTail = pRing->uiTail;
+
+	if (uiTail == pRing->uiHead) return false;  // empty
+
+	volatile Event_Record* pSlot = &pRing->a_sRecords[uiTail & EVENT_LOG_MASK];
+
+	pRecord->ui32Timestamp = pSlot->ui32Timestamp;
+	pRecord->szMessage = pSlot->szMessage;
+	pRecord->ui32ErrorCode = pSlot->ui32ErrorCode;
+	pRecord->ui32Extended = pSlot->ui32Extended;
+	pRecord->ui16Location = pSlot->ui16Location;
+	pRecord->ui8Probe = pSlot->ui8Probe;
+	pRecord->ui8Source = pSlot->ui8Source;
+
+	// the slot is copied out before the producer can reuse it
+	pRing->uiTail = uiTail + 1;
+
+	return true;
+}
+
+
+uint32_t Event_Log_Get_Dropped(uint32_t uiSource)
+{
+	if (uiSource >= EVENT_LOG_MAX_SOURCES) return 0;
+
+	return a_sEvent_Ring[uiSource].uiDropped;
+}
+
+
+void Event_Log_Format_Record(const Event_Record* pRecord, char* szBuffer)
+{
+	// the text is built in Acquisition_Kernels.c so it can be benchmarked
+	Acquisition_Format_Event(pRecord, a_szEvent_Source[pRecord->ui8Source], szBuffer);
+}
+
+
+uint32_t Event_Log_Drain(uint32_t uiMax_Records)
+{
+	// called from a low priority task... this is where the time for formatting and output is spent.
+	// returns the number of records written.
+
+	Event_Record sRecord;
+	char szTemp[EVENT_LOG_FORMAT_SIZE];
+
+	uint32_t uiCount = 0;
+	uint32_t uiSource;
+	uint32_t uiMore = true;
+
+	// round robin across the sources so a chatty one can't starve the other
+	while (uiMore && (uiCount < uiMax_Records))
+	{
+		uiMore = false;
+
+		for (uiSource = 0; (uiSource < EVENT_LOG_MAX_SOURCES) && (uiCount < uiMax_Records); uiSource++)
+		{
+			if (Event_Log_Pop(uiSource, &sRecord) == false) continue;
+
+			uiMore = true;
+			uiCount++;
+
+			if (sRecord.szMessage)
+			{
+				Telemetry_Send_Output((char *) sRecord.szMessage);
+			}
+
+			Event_Log_Format_Record(&sRecord, szTemp);
+			Telemetry_Send_Output(szTemp);
+		}
+	}
+
+	return uiCount;
+}
+
+
+void Event_Log_Drain_Task(UArg arg0, UArg arg1)
+{
+	while (true)
+	{
+		Semaphore_pend(Semaphore_handle(&g_sEvent_Log_Drain_Semaphore), BIOS_WAIT_FOREVER);
+
+		Event_Log_Drain(EVENT_LOG_DRAIN_RECORDS);
+
+		Job_Scheduler_Work_Done(JOB_EVENT_LOG_DRAIN);
+	}
+}
+
+
+void Event_Log_Wake_Drain(void)
+{
+	// the JOB_EVENT_LOG_DRAIN job... runs in the Clock Swi, the task does the work
+	Semaphore_post(Semaphore_handle(&g_sEvent_Log_Drain_Semaphore));
+}
+
+
+void Event_Log_Start_Drain_Task(uint32_t uiPriority)
+{
+	Semaphore_Params sSemaphore_Params;
+	Semaphore_Params_init(&sSemaphore_Params);
+	sSemaphore_Params.mode = Semaphore_Mode_BINARY;
+	Semaphore_construct(&g_sEvent_Log_Drain_Semaphore, 0, &sSemaphore_Params);
+
+	Task_Params sTask_Params;
+	Task_Params_init(&sTask_Params);
+	sTask_Params.stack = a_ui64Event_Log_Drain_Stack;
+	sTask_Params.stackSize = sizeof(a_ui64Event_Log_Drain_Stack);
+	sTask_Params.priority = uiPriority;
+	Task_construct(&g_sEvent_Log_Drain_Task, (Task_FuncPtr) Event_Log_Drain_Task, &sTask_Params, NULL);
+}
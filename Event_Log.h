@@ -0,0 +1,51 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Event Log - fixed size binary event records, formatted later by a low priority task.
+//
+//*****************************************************************************
+
+#ifndef EVENT_LOG_H_
+#define EVENT_LOG_H_
+
+#include <stdint.h>
+
+
+// Sources - each source is written by exactly one task
+#define EVENT_SOURCE_TEMPERATURE			0
+#define EVENT_SOURCE_ADC					1
+#define EVENT_LOG_MAX_SOURCES				2
+
+#define EVENT_NO_PROBE						0xFF
+
+#define EVENT_LOG_FORMAT_SIZE				128    // buffer size for Event_Log_Format_Record()
+
+#define EVENT_LOG_DRAIN_PRIORITY			1      // just above idle, below every acquisition task
+#define EVENT_LOG_DRAIN_TICKS				100
+
+
+typedef struct
+{
+	uint32_t ui32Timestamp;             // Clock ticks
+	const char* szMessage;              // static text only, it is never copied
+	uint32_t ui32ErrorCode;
+	uint32_t ui32Extended;
+	uint16_t ui16Location;
+	uint8_t ui8Probe;
+	uint8_t ui8Source;
+} Event_Record;
+
+
+void Event_Log_Push(uint32_t uiSource, uint32_t uiProbe, uint32_t uiLocation, uint32_t ui32ErrorCode, uint32_t ui32Extended, const char* szMessage);
+uint32_t Event_Log_Pop(uint32_t uiSource, Event_Record* pRecord);
+
+void Event_Log_Format_Record(const Event_Record* pRecord, char* szBuffer);
+uint32_t Event_Log_Drain(uint32_t uiMax_Records);
+
+uint32_t Event_Log_Get_Dropped(uint32_t uiSource);
+
+void Event_Log_Start_Drain_Task(uint32_t uiPriority);
+void Event_Log_Wake_Drain(void);
+
+#endif /* EVENT_LOG_H_ */
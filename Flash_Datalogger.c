@@ -0,0 +1,576 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Nothing was kept once a reading left the UART.  This module keeps an append only log of telemetry
+// frames (the binary frames from Telemetry_Frame.c) in the top 256KB of the internal flash, so days of
+// readings survive without a host attached.
+//
+// Layout:
+//     16 segments of 16KB, one flash erase block each, used as a ring.
+//     Each segment starts with a header:  magic, sequence, erase count, ~sequence
+//     then records:                       length (16 bits), ~length (16 bits), payload padded to 4 bytes
+//     An erased word (0xFFFFFFFF) where a record header would be is the end of the segment.
+//
+// Wear levelling - segments are always used in order, and the next one is only erased when the current
+//     one is full.  Every segment is erased the same number of times (+/- 1), the erase count in the
+//     header shows it.
+// Batched writes - records are collected in a RAM page and programmed FLASH_LOG_PAGE_SIZE bytes at a
+//     time (or on Flash_Datalogger_Flush()).  A reset loses at most one page.
+// Tail index - the addresses of the last FLASH_LOG_TAIL_RECORDS records are kept in RAM so the most
+//     recent data can be read back without walking the flash.
+//
+// Flash_Datalogger_Mount() finds the newest segment from the 16 headers and walks that segment to find
+// where to carry on (and the one before it, to fill the tail index).  A record header that doesn't
+// check out ends the segment... the rest of it may be half written, so a new segment is started.
+//
+// Erasing a segment stalls flash for tens of ms, call Append / Log from a low priority task.  That task
+// is here (Flash_Datalogger_Start_Task(), built like the event log drain), JOB_FLASH_DATALOGGER wakes it
+// every FLASH_LOG_TICKS to log one temperature and one dish frame.  Driver_Setup() mounts the log at
+// boot and sends the last FLASH_LOG_BOOT_DUMP_RECORDS records out the frame port.
+//
+// With FLASH_DATALOGGER_EMULATOR defined the flash is a file on the PC, with the same erase / program
+// rules (programming can only clear bits).  tools/Flash_Datalogger_Bench.c uses it.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef FLASH_DATALOGGER_EMULATOR
+
+#include <xdc/std.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/knl/Task.h>
+#include <ti/sysbios/knl/Semaphore.h>
+
+#include "driverlib/flash.h"
+
+#include "constants.h"
+#include "globals.h"
+
+#include "Telemetry.h"
+#include "Telemetry_Frame.h"
+#include "Job_Scheduler.h"
+
+#else
+
+#include <stdio.h>
+
+#endif
+
+#include "Flash_Datalogger.h"
+#include "Static_Footprint.h"
+
+
+
+#define FLASH_LOG_MAGIC						0x584C4F47  // "XLOG"
+#define FLASH_LOG_HEADER_SIZE				16
+#define FLASH_LOG_RECORD_HEADER				4
+#define FLASH_LOG_PAGE_SIZE					512
+#define FLASH_LOG_TAIL_RECORDS				64
+#define FLASH_LOG_ERASED					0xFFFFFFFF
+#define FLASH_LOG_TASK_STACK				1024        // bytes, a frame, the snapshot it's built from and Append()
+
+
+typedef struct
+{
+	uint32_t ui32Magic;
+	uint32_t ui32Sequence;
+	uint32_t ui32Erase_Count;
+	uint32_t ui32Sequence_Check;        // ~ui32Sequence
+} Flash_Segment_Header;
+
+
+uint32_t g_uiFlash_Log_Mounted;
+uint32_t g_uiFlash_Log_Segment;
+uint32_t g_uiFlash_Log_Sequence;
+uint32_t g_uiFlash_Log_Erase_Count;
+uint32_t g_uiFlash_Log_Write_Offset;                     // within the segment, flash programmed up to here
+
+uint32_t a_uiFlash_Log_Page[FLASH_LOG_PAGE_SIZE / 4];    // word aligned for FlashProgram()
+uint32_t g_uiFlash_Log_Page_Used;
+
+uint32_t a_uiFlash_Log_Tail[FLASH_LOG_TAIL_RECORDS];    // record addresses, newest at g_uiFlash_Log_Tail_Next - 1
+uint32_t g_uiFlash_Log_Tail_Next;
+uint32_t g_uiFlash_Log_Tail_Count;
+
+Flash_Datalogger_Counters g_sFlash_Log_Counters;
+
+#ifndef FLASH_DATALOGGER_EMULATOR
+
+Task_Struct g_sFlash_Log_Task;
+Semaphore_Struct g_sFlash_Log_Semaphore;
+uint64_t a_ui64Flash_Log_Stack[FLASH_LOG_TASK_STACK / sizeof(uint64_t)];   // 8 byte aligned
+
+#define FLASH_LOG_TASK_BYTES				sizeof(a_ui64Flash_Log_Stack)
+
+#else
+
+#define FLASH_LOG_TASK_BYTES				0           // no task on the PC
+
+#endif
+
+const uint32_t g_uiFlash_Datalogger_Static_Bytes = sizeof(a_uiFlash_Log_Page) + sizeof(a_uiFlash_Log_Tail) + sizeof(g_sFlash_Log_Counters) + FLASH_LOG_TASK_BYTES;
+STATIC_FOOTPRINT_CHECK((sizeof(a_uiFlash_Log_Page) + sizeof(a_uiFlash_Log_Tail) + sizeof(g_sFlash_Log_Counters) + FLASH_LOG_TASK_BYTES) <= STATIC_BUDGET_FLASH_DATALOGGER, Flash_Datalogger);
+
+
+
+#ifdef FLASH_DATALOGGER_EMULATOR
+
+// ------------------------------------------------------------------------------------------------
+// PC side - the flash region is a file
+
+FILE* g_pFlash_Emulator_File;
+
+
+uint32_t Flash_Emulator_Open(const char* szFile)
+{
+	// the file is created erased if it isn't there
+	g_pFlash_Emulator_File = fopen(szFile, "r+b");
+
+	if (g_pFlash_Emulator_File == NULL)
+	{
+		uint8_t a_ui8Erased[256];
+		uint32_t i;
+
+		g_pFlash_Emulator_File = fopen(szFile, "w+b");
+		if (g_pFlash_Emulator_File == NULL) return false;
+
+		memset(a_ui8Erased, 0xFF, sizeof(a_ui8Erased));
+		for (i = 0; i < (FLASH_LOG_SEGMENT_SIZE * FLASH_LOG_SEGMENTS) / sizeof(a_ui8Erased); i++)
+		{
+			fwrite(a_ui8Erased, 1, sizeof(a_ui8Erased), g_pFlash_Emulator_File);
+		}
+	}
+
+	return true;
+}
+
+
+void Flash_Emulator_Close(void)
+{
+	if (g_pFlash_Emulator_File) fclose(g_pFlash_Emulator_File);
+	g_pFlash_Emulator_File = NULL;
+}
+
+
+static int32_t FlashErase(uint32_t ui32Address)
+{
+	uint8_t a_ui8Erased[256];
+	uint32_t i;
+
+	if ((ui32Address - FLASH_LOG_BASE) % FLASH_LOG_SEGMENT_SIZE) return -1;
+
+	memset(a_ui8Erased, 0xFF, sizeof(a_ui8Erased));
+	fseek(g_pFlash_Emulator_File, ui32Address - FLASH_LOG_BASE, SEEK_SET);
+	for (i = 0; i < FLASH_LOG_SEGMENT_SIZE / sizeof(a_ui8Erased); i++)
+	{
+		fwrite(a_ui8Erased, 1, sizeof(a_ui8Erased), g_pFlash_Emulator_File);
+	}
+
+	return 0;
+}
+
+
+static int32_t FlashProgram(uint32_t* pui32Data, uint32_t ui32Address, uint32_t ui32Count)
+{
+	// like the real thing, programming can only clear bits
+	uint8_t a_ui8Old[FLASH_LOG_PAGE_SIZE];
+	const uint8_t* pui8Data = (const uint8_t *) pui32Data;
+	uint32_t i;
+
+	if ((ui32Address & 3) || (ui32Count & 3) || (ui32Count > sizeof(a_ui8Old))) return -1;
+
+	fseek(g_pFlash_Emulator_File, ui32Address - FLASH_LOG_BASE, SEEK_SET);
+	if (fread(a_ui8Old, 1, ui32Count, g_pFlash_Emulator_File) != ui32Count) return -1;
+
+	for (i = 0; i < ui32Count; i++) a_ui8Old[i] &= pui8Data[i];
+
+	fseek(g_pFlash_Emulator_File, ui32Address - FLASH_LOG_BASE, SEEK_SET);
+	fwrite(a_ui8Old, 1, ui32Count, g_pFlash_Emulator_File);
+
+	return 0;
+}
+
+
+static void Flash_Datalogger_Read_Flash(uint32_t ui32Address, void* pData, uint32_t uiLength)
+{
+	fseek(g_pFlash_Emulator_File, ui32Address - FLASH_LOG_BASE, SEEK_SET);
+	if (fread(pData, 1, uiLength, g_pFlash_Emulator_File) != uiLength) memset(pData, 0xFF, uiLength);
+}
+
+#else
+
+static void Flash_Datalogger_Read_Flash(uint32_t ui32Address, void* pData, uint32_t uiLength)
+{
+	// internal flash is memory mapped
+	memcpy(pData, (const void *) ui32Address, uiLength);
+}
+
+#endif
+
+
+
+static uint32_t Flash_Datalogger_Segment_Address(uint32_t uiSegment)
+{
+	return FLASH_LOG_BASE + (uiSegment * FLASH_LOG_SEGMENT_SIZE);
+}
+
+
+static void Flash_Datalogger_Read(uint32_t ui32Address, void* pData, uint32_t uiLength)
+{
+	// reads what has been programmed, or what is still waiting in the page
+	uint32_t ui32Page_Address = Flash_Datalogger_Segment_Address(g_uiFlash_Log_Segment) + g_uiFlash_Log_Write_Offset;
+
+	if ((ui32Address >= ui32Page_Address) && (ui32Address < (ui32Page_Address + g_uiFlash_Log_Page_Used)))
+	{
+		memcpy(pData, ((const uint8_t *) a_uiFlash_Log_Page) + (ui32Address - ui32Page_Address), uiLength);
+		return;
+	}
+
+	Flash_Datalogger_Read_Flash(ui32Address, pData, uiLength);
+}
+
+
+static void Flash_Datalogger_Tail_Add(uint32_t ui32Address)
+{
+	a_uiFlash_Log_Tail[g_uiFlash_Log_Tail_Next] = ui32Address;
+	g_uiFlash_Log_Tail_Next = (g_uiFlash_Log_Tail_Next + 1) % FLASH_LOG_TAIL_RECORDS;
+	if (g_uiFlash_Log_Tail_Count < FLASH_LOG_TAIL_RECORDS) g_uiFlash_Log_Tail_Count++;
+}
+
+
+static uint32_t Flash_Datalogger_Start_Segment(uint32_t uiSegment, uint32_t ui32Sequence)
+{
+	// erase a segment and write its header... 16000's
+	Flash_Segment_Header sHeader;
+	uint32_t ui32Address = Flash_Datalogger_Segment_Address(uiSegment);
+
+	// carry the erase count forward
+	Flash_Datalogger_Read_Flash(ui32Address, &sHeader, sizeof(sHeader));
+	uint32_t ui32Erase_Count = (sHeader.ui32Magic == FLASH_LOG_MAGIC) ? sHeader.ui32Erase_Count + 1 : 1;
+
+	if (FlashErase(ui32Address) != 0) return FLASH_LOG_ERR_ERASE;
+
+	g_sFlash_Log_Counters.ui32Segment_Erases++;
+
+	sHeader.ui32Magic = FLASH_LOG_MAGIC;
+	sHeader.ui32Sequence = ui32Sequence;
+	sHeader.ui32Erase_Count = ui32Erase_Count;
+	sHeader.ui32Sequence_Check = ~ui32Sequence;
+
+	if (FlashProgram((uint32_t *) &sHeader, ui32Address, sizeof(sHeader)) != 0) return FLASH_LOG_ERR_PROGRAM;
+
+	g_uiFlash_Log_Segment = uiSegment;
+	g_uiFlash_Log_Sequence = ui32Sequence;
+	g_uiFlash_Log_Erase_Count = ui32Erase_Count;
+	g_uiFlash_Log_Write_Offset = FLASH_LOG_HEADER_SIZE;
+
+	if (ui32Erase_Count > g_sFlash_Log_Counters.ui32Max_Erase_Count) g_sFlash_Log_Counters.ui32Max_Erase_Count = ui32Erase_Count;
+
+	return 0;
+}
+
+
+static uint32_t Flash_Datalogger_Walk_Segment(uint32_t uiSegment, uint32_t* puiOffset)
+{
+	// add a segment's records to the tail index, returns false if a record header doesn't check out
+	uint32_t ui32Base = Flash_Datalogger_Segment_Address(uiSegment);
+	uint32_t uiOffset = FLASH_LOG_HEADER_SIZE;
+	uint32_t uiClean = true;
+
+	while ((uiOffset + FLASH_LOG_RECORD_HEADER) <= FLASH_LOG_SEGMENT_SIZE)
+	{
+		uint32_t ui32Record;
+
+		Flash_Datalogger_Read_Flash(ui32Base + uiOffset, &ui32Record, sizeof(ui32Record));
+
+		if (ui32Record == FLASH_LOG_ERASED) break;
+
+		uint32_t uiLength = ui32Record & 0xFFFF;
+
+		if (((ui32Record >> 16) != (~uiLength & 0xFFFF)) || (uiLength > FLASH_LOG_MAX_RECORD) ||
+			((uiOffset + FLASH_LOG_RECORD_HEADER + uiLength) > FLASH_LOG_SEGMENT_SIZE))
+		{
+			uiClean = false;
+			break;
+		}
+
+		Flash_Datalogger_Tail_Add(ui32Base + uiOffset);
+		uiOffset += FLASH_LOG_RECORD_HEADER + ((uiLength + 3) & ~3);
+	}
+
+	*puiOffset = uiOffset;
+	return uiClean;
+}
+
+
+uint32_t Flash_Datalogger_Mount(void)
+{
+	// find the newest segment and the end of its records... 16000's
+	Flash_Segment_Header sHeader;
+	uint32_t uiSegment;
+	uint32_t uiNewest = FLASH_LOG_SEGMENTS;
+	uint32_t ui32Newest_Sequence = 0;
+	uint32_t ui32Error;
+
+	g_uiFlash_Log_Mounted = false;
+	g_uiFlash_Log_Page_Used = 0;
+	g_uiFlash_Log_Tail_Next = 0;
+	g_uiFlash_Log_Tail_Count = 0;
+	memset(&g_sFlash_Log_Counters, 0, sizeof(g_sFlash_Log_Counters));
+
+	for (uiSegment = 0; uiSegment < FLASH_LOG_SEGMENTS; uiSegment++)
+	{
+		Flash_Datalogger_Read_Flash(Flash_Datalogger_Segment_Address(uiSegment), &sHeader, sizeof(sHeader));
+
+		if (sHeader.ui32Magic != FLASH_LOG_MAGIC) continue;
+		if (sHeader.ui32Sequence_Check != ~sHeader.ui32Sequence) continue;
+
+		if (sHeader.ui32Erase_Count > g_sFlash_Log_Counters.ui32Max_Erase_Count) g_sFlash_Log_Counters.ui32Max_Erase_Count = sHeader.ui32Erase_Count;
+
+		if ((uiNewest == FLASH_LOG_SEGMENTS) || ((int32_t) (sHeader.ui32Sequence - ui32Newest_Sequence) > 0))
+		{
+			uiNewest = uiSegment;
+			ui32Newest_Sequence = sHeader.ui32Sequence;
+			g_uiFlash_Log_Erase_Count = sHeader.ui32Erase_Count;
+		}
+	}
+
+	if (uiNewest == FLASH_LOG_SEGMENTS)
+	{
+		// empty (or foreign) flash... start at the beginning
+		ui32Error = Flash_Datalogger_Start_Segment(0, 1);
+		if (ui32Error) return ui32Error;
+
+		g_uiFlash_Log_Mounted = true;
+		return 0;
+	}
+
+	g_uiFlash_Log_Segment = uiNewest;
+	g_uiFlash_Log_Sequence = ui32Newest_Sequence;
+
+	// the segment before it fills the tail index too, so a mount just after a new segment doesn't
+	// leave only a handful of records to read back
+	uint32_t uiPrevious = (uiNewest + FLASH_LOG_SEGMENTS - 1) % FLASH_LOG_SEGMENTS;
+	uint32_t uiOffset;
+
+	Flash_Datalogger_Read_Flash(Flash_Datalogger_Segment_Address(uiPrevious), &sHeader, sizeof(sHeader));
+	if ((sHeader.ui32Magic == FLASH_LOG_MAGIC) && (sHeader.ui32Sequence == (ui32Newest_Sequence - 1)))
+	{
+		Flash_Datalogger_Walk_Segment(uiPrevious, &uiOffset);
+	}
+
+	uint32_t uiClean = Flash_Datalogger_Walk_Segment(uiNewest, &uiOffset);
+
+	g_uiFlash_Log_Write_Offset = uiOffset;
+
+	if (uiClean == false)
+	{
+		// a write was cut off... don't append after it, move on
+		ui32Error = Flash_Datalogger_Start_Segment((uiNewest + 1) % FLASH_LOG_SEGMENTS, ui32Newest_Sequence + 1);
+		if (ui32Error) return ui32Error;
+	}
+
+	g_uiFlash_Log_Mounted = true;
+	return 0;
+}
+
+
+uint32_t Flash_Datalogger_Flush(void)
+{
+	// program whatever is in the page
+	if (g_uiFlash_Log_Page_Used == 0) return 0;
+
+	uint32_t ui32Address = Flash_Datalogger_Segment_Address(g_uiFlash_Log_Segment) + g_uiFlash_Log_Write_Offset;
+
+	if (FlashProgram(a_uiFlash_Log_Page, ui32Address, g_uiFlash_Log_Page_Used) != 0) return FLASH_LOG_ERR_PROGRAM;
+
+	g_sFlash_Log_Counters.ui32Page_Writes++;
+
+	g_uiFlash_Log_Write_Offset += g_uiFlash_Log_Page_Used;
+	g_uiFlash_Log_Page_Used = 0;
+
+	return 0;
+}
+
+
+uint32_t Flash_Datalogger_Append(const uint8_t* pData, uint32_t uiLength)
+{
+	// 16000's
+	uint32_t ui32Error;
+
+	if (g_uiFlash_Log_Mounted == false) return FLASH_LOG_ERR_NOT_MOUNTED;
+	if ((uiLength == 0) || (uiLength > FLASH_LOG_MAX_RECORD)) return FLASH_LOG_ERR_TOO_BIG;
+
+	uint32_t uiRecord_Size = FLASH_LOG_RECORD_HEADER + ((uiLength + 3) & ~3);
+
+	if ((g_uiFlash_Log_Page_Used + uiRecord_Size) > FLASH_LOG_PAGE_SIZE)
+	{
+		ui32Error = Flash_Datalogger_Flush();
+		if (ui32Error) return ui32Error;
+	}
+
+	if ((g_uiFlash_Log_Write_Offset + g_uiFlash_Log_Page_Used + uiRecord_Size) > FLASH_LOG_SEGMENT_SIZE)
+	{
+		ui32Error = Flash_Datalogger_Flush();
+		if (ui32Error) return ui32Error;
+
+		// the segment is full, the oldest one goes
+		ui32Error = Flash_Datalogger_Start_Segment((g_uiFlash_Log_Segment + 1) % FLASH_LOG_SEGMENTS, g_uiFlash_Log_Sequence + 1);
+		if (ui32Error)
+		{
+			g_uiFlash_Log_Mounted = false;
+			return ui32Error;
+		}
+
+		// the tail index never reaches back into the segment just erased... it only spans a few KB
+	}
+
+	uint8_t* pPage = ((uint8_t *) a_uiFlash_Log_Page) + g_uiFlash_Log_Page_Used;
+	uint32_t ui32Header = uiLength | ((~uiLength & 0xFFFF) << 16);
+
+	memcpy(pPage, &ui32Header, FLASH_LOG_RECORD_HEADER);
+	memcpy(pPage + FLASH_LOG_RECORD_HEADER, pData, uiLength);
+	memset(pPage + FLASH_LOG_RECORD_HEADER + uiLength, 0, uiRecord_Size - FLASH_LOG_RECORD_HEADER - uiLength);
+
+	Flash_Datalogger_Tail_Add(Flash_Datalogger_Segment_Address(g_uiFlash_Log_Segment) + g_uiFlash_Log_Write_Offset + g_uiFlash_Log_Page_Used);
+
+	g_uiFlash_Log_Page_Used += uiRecord_Size;
+
+	g_sFlash_Log_Counters.ui32Records++;
+	g_sFlash_Log_Counters.ui32Bytes += uiLength;
+
+	return 0;
+}
+
+
+uint32_t Flash_Datalogger_Get_Recent(uint32_t uiBack, uint8_t* pData, uint32_t uiMax, uint32_t* puiLength)
+{
+	// uiBack 0 is the newest record... 16000's
+	if (g_uiFlash_Log_Mounted == false) return FLASH_LOG_ERR_NOT_MOUNTED;
+	if (uiBack >= g_uiFlash_Log_Tail_Count) return FLASH_LOG_ERR_NO_RECORD;
+
+	uint32_t uiSlot = (g_uiFlash_Log_Tail_Next + FLASH_LOG_TAIL_RECORDS - 1 - uiBack) % FLASH_LOG_TAIL_RECORDS;
+	uint32_t ui32Address = a_uiFlash_Log_Tail[uiSlot];
+	uint32_t ui32Header;
+
+	Flash_Datalogger_Read(ui32Address, &ui32Header, sizeof(ui32Header));
+
+	uint32_t uiLength = ui32Header & 0xFFFF;
+
+	if ((ui32Header >> 16) != (~uiLength & 0xFFFF)) return FLASH_LOG_ERR_NO_RECORD;
+	if (uiLength > uiMax) return FLASH_LOG_ERR_TOO_BIG;
+
+	Flash_Datalogger_Read(ui32Address + FLASH_LOG_RECORD_HEADER, pData, uiLength);
+	*puiLength = uiLength;
+
+	return 0;
+}
+
+
+void Flash_Datalogger_Get_Counters(Flash_Datalogger_Counters* pCounters)
+{
+	*pCounters = g_sFlash_Log_Counters;
+
+	pCounters->ui32Current_Segment = g_uiFlash_Log_Segment;
+	pCounters->ui32Current_Sequence = g_uiFlash_Log_Sequence;
+	pCounters->ui32Free_In_Segment = FLASH_LOG_SEGMENT_SIZE - g_uiFlash_Log_Write_Offset - g_uiFlash_Log_Page_Used;
+}
+
+
+#ifndef FLASH_DATALOGGER_EMULATOR
+
+uint32_t Flash_Datalogger_Log_Telemetry(void)
+{
+	// one temperature and one dish frame... ~100 bytes, 256KB holds about 2500 of these.
+	// at one call every 2 minutes that is 3 1/2 days.
+	uint8_t a_ui8Frame[TELEMETRY_FRAME_MAX_ENCODED];
+	Temperature_Snapshot sSnapshot;
+	uint16_t a_ui16Channels[TELEMETRY_DISH_CHANNELS];
+	uint8_t ui8Mode;
+	uint8_t ui8Flags;
+	uint32_t ui32Error;
+
+	Temperature_Snapshot_Read(&sSnapshot);
+
+	ui32Error = Flash_Datalogger_Append(a_ui8Frame, Telemetry_Frame_Build_Temperature(&sSnapshot, a_ui8Frame));
+	if (ui32Error) return ui32Error;
+
+	Telemetry_Frame_Get_Dish(a_ui16Channels, &ui8Mode, &ui8Flags);
+
+	return Flash_Datalogger_Append(a_ui8Frame, Telemetry_Frame_Build_Dish(a_ui16Channels, ui8Mode, ui8Flags, a_ui8Frame));
+}
+
+
+uint32_t Flash_Datalogger_Dump_Recent(uint32_t uiCount)
+{
+	// sends the last uiCount records, oldest first, out the telemetry frame port.
+	// they are telemetry frames already, tools/Telemetry_Decode.c reads them.
+	uint8_t a_ui8Frame[FLASH_LOG_MAX_RECORD];
+	uint32_t uiLength;
+	uint32_t uiSent = 0;
+
+	if (uiCount > g_uiFlash_Log_Tail_Count) uiCount = g_uiFlash_Log_Tail_Count;
+
+	while (uiCount)
+	{
+		uiCount--;
+
+		if (Flash_Datalogger_Get_Recent(uiCount, a_ui8Frame, sizeof(a_ui8Frame), &uiLength) != 0) continue;
+
+		Telemetry_Frame_Write(a_ui8Frame, uiLength);
+		uiSent++;
+	}
+
+	return uiSent;
+}
+
+
+void Flash_Datalogger_Task(UArg arg0, UArg arg1)
+{
+	uint32_t ui32Error;
+
+	while (true)
+	{
+		Semaphore_pend(Semaphore_handle(&g_sFlash_Log_Semaphore), BIOS_WAIT_FOREVER);
+
+		// not mounted is reported once at boot, every 2 minutes would only repeat it
+		ui32Error = Flash_Datalogger_Log_Telemetry();
+		if (ui32Error && (ui32Error != FLASH_LOG_ERR_NOT_MOUNTED))
+		{
+			Telemetry_Send_Output_Value("Flash_Datalogger_Task()::Log Telemetry Error: ", ui32Error);
+		}
+
+		Job_Scheduler_Work_Done(JOB_FLASH_DATALOGGER);
+	}
+}
+
+
+void Flash_Datalogger_Wake(void)
+{
+	// the JOB_FLASH_DATALOGGER job... runs in the Clock Swi, the task does the flash work
+	Semaphore_post(Semaphore_handle(&g_sFlash_Log_Semaphore));
+}
+
+
+void Flash_Datalogger_Start_Task(uint32_t uiPriority)
+{
+	Semaphore_Params sSemaphore_Params;
+	Semaphore_Params_init(&sSemaphore_Params);
+	sSemaphore_Params.mode = Semaphore_Mode_BINARY;
+	Semaphore_construct(&g_sFlash_Log_Semaphore, 0, &sSemaphore_Params);
+
+	Task_Params sTask_Params;
+	Task_Params_init(&sTask_Params);
+	sTask_Params.stack = a_ui64Flash_Log_Stack;
+	sTask_Params.stackSize = sizeof(a_ui64Flash_Log_Stack);
+	sTask_Params.priority = uiPriority;
+	Task_construct(&g_sFlash_Log_Task, (Task_FuncPtr) Flash_Datalogger_Task, &sTask_Params, NULL);
+}
+
+#endif
@@ -0,0 +1,69 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Flash Datalogger - append only log of telemetry frames in internal flash.
+//
+// Build with FLASH_DATALOGGER_EMULATOR defined to run it on a PC against a file instead of flash
+// (see tools/Flash_Datalogger_Bench.c).
+//
+//*****************************************************************************
+
+#ifndef FLASH_DATALOGGER_H_
+#define FLASH_DATALOGGER_H_
+
+#include <stdint.h>
+
+
+#define FLASH_LOG_BASE						0x000C0000  // last 256KB of the 1MB flash
+#define FLASH_LOG_SEGMENT_SIZE				0x4000      // 16KB, one erase block
+#define FLASH_LOG_SEGMENTS					16
+#define FLASH_LOG_MAX_RECORD				252         // payload bytes
+
+#define FLASH_LOG_PRIORITY					1           // with the event log drain, below every acquisition task
+#define FLASH_LOG_TICKS						120000      // a temperature and a dish frame every 2 minutes
+#define FLASH_LOG_BOOT_DUMP_RECORDS			8           // sent at boot, the last 8 minutes before the reset
+
+// Errors
+#define FLASH_LOG_ERR_TOO_BIG				16001
+#define FLASH_LOG_ERR_ERASE					16002
+#define FLASH_LOG_ERR_PROGRAM				16003
+#define FLASH_LOG_ERR_NOT_MOUNTED			16004
+#define FLASH_LOG_ERR_NO_RECORD				16005
+
+
+typedef struct
+{
+	uint32_t ui32Records;               // appended since mount
+	uint32_t ui32Bytes;
+	uint32_t ui32Page_Writes;           // FlashProgram() calls
+	uint32_t ui32Segment_Erases;
+	uint32_t ui32Current_Segment;
+	uint32_t ui32Current_Sequence;      // goes up by one each time a segment is started
+	uint32_t ui32Max_Erase_Count;       // the most any one segment has been erased
+	uint32_t ui32Free_In_Segment;
+} Flash_Datalogger_Counters;
+
+
+uint32_t Flash_Datalogger_Mount(void);
+
+uint32_t Flash_Datalogger_Append(const uint8_t* pData, uint32_t uiLength);
+uint32_t Flash_Datalogger_Flush(void);
+uint32_t Flash_Datalogger_Log_Telemetry(void);
+
+uint32_t Flash_Datalogger_Get_Recent(uint32_t uiBack, uint8_t* pData, uint32_t uiMax, uint32_t* puiLength);
+uint32_t Flash_Datalogger_Dump_Recent(uint32_t uiCount);
+
+void Flash_Datalogger_Get_Counters(Flash_Datalogger_Counters* pCounters);
+
+#ifndef FLASH_DATALOGGER_EMULATOR
+void Flash_Datalogger_Start_Task(uint32_t uiPriority);
+void Flash_Datalogger_Wake(void);
+#endif
+
+#ifdef FLASH_DATALOGGER_EMULATOR
+uint32_t Flash_Emulator_Open(const char* szFile);
+void Flash_Emulator_Close(void);
+#endif
+
+#endif /* FLASH_DATALOGGER_H_ */
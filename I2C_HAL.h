@@ -0,0 +1,50 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// I2C HAL - the seam between the acquisition code and the hardware.
+//
+// I2C_Scheduler.c and Temperature_Interface.c reach the bus, the busy wait delays and the tick count
+// only through these.  On the board they are the TI-RTOS / driverlib calls and cost nothing.  Built with
+// I2C_HAL_SIMULATOR they go to the bus simulator in I2C_Sim.c instead, so the same code runs on the PC
+// against simulated DS2482-800 / DS18B20 / LTC2309 parts and simulated time.
+//
+// The modules that stamp or age what the acquisition produces (event log, snapshot, estimator,
+// telemetry, boot timing) take their ticks from I2C_HAL_Get_Ticks() too, so on the simulator every
+// timestamp is simulated time.
+//
+// Include this after <ti/drivers/I2C.h> where the transfer calls are used.
+//
+//*****************************************************************************
+
+#ifndef I2C_HAL_H_
+#define I2C_HAL_H_
+
+#include <stdint.h>
+
+
+#ifdef I2C_HAL_SIMULATOR
+
+#include "I2C_Sim.h"
+
+#define I2C_HAL_Transfer(uiBus, hHandle, pTransaction)		I2C_Sim_Transfer((uiBus), (pTransaction)->slaveAddress, (pTransaction)->writeBuf, (pTransaction)->writeCount, (pTransaction)->readBuf, (pTransaction)->readCount)
+#define I2C_HAL_Error(uiBus, hHandle)						I2C_Sim_Get_Error(uiBus)
+#define I2C_HAL_Open(uiBus, uiBoard_Index, pParams)			((I2C_Handle) I2C_Sim_Open((uiBus), ((pParams)->bitRate == I2C_400kHz) ? 400 : 100))
+#define I2C_HAL_Close(uiBus, hHandle)						I2C_Sim_Close(uiBus)
+#define I2C_HAL_Delay(ui32Count)							I2C_Sim_Delay(ui32Count)
+#define I2C_HAL_Get_Ticks()									I2C_Sim_Get_Ticks()
+#define I2C_HAL_Timestamp()									I2C_Sim_Get_Cycles()
+
+#else
+
+#define I2C_HAL_Transfer(uiBus, hHandle, pTransaction)		I2C_transfer((hHandle), (pTransaction))
+#define I2C_HAL_Error(uiBus, hHandle)						I2C_control((hHandle), I2C_MASTER_ERR_NONE, 0)
+#define I2C_HAL_Open(uiBus, uiBoard_Index, pParams)			I2C_open((uiBoard_Index), (pParams))
+#define I2C_HAL_Close(uiBus, hHandle)						I2C_close(hHandle)
+#define I2C_HAL_Delay(ui32Count)							SysCtlDelay(ui32Count)
+#define I2C_HAL_Get_Ticks()									Clock_getTicks()
+#define I2C_HAL_Timestamp()									Timestamp_get32()
+
+#endif
+
+#endif /* I2C_HAL_H_ */
@@ -0,0 +1,608 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// This module arbitrates the I2C buses between the Temperature (DS2482-800) and ADC (LTC2309) clients.
+//
+// Before this, each subsystem called I2C_transfer() on its own handle.  That works as long as every bus
+// has exactly one client.  Once buses are consolidated, a long DS2482 sequence (reset, select, poll, poll,
+// poll...) would hold off an ADC read that the dish needs right now.
+//
+// Every I2C_Transaction now goes through I2C_Scheduler_Transfer().  Each bus has a small wait queue.
+// When the bus is free the caller goes straight through, otherwise it waits.  When the bus is released,
+// the waiter with the best priority goes next, then the earliest deadline, then first come first served.
+//
+// A client that needs several transactions back to back (channel select + verify, ADC write + read)
+// calls I2C_Scheduler_Acquire() / I2C_Scheduler_Release() around them.  That is a batch: transfers from
+// the owning task inside the batch do not queue again.  Batches nest.
+//
+// The scheduler only reorders at transaction / batch boundaries.  Nothing is ever aborted mid transfer.
+//
+// Per bus counters: transactions, errors, busy time, utilization, queue depth, deadline misses.
+// With I2C_TRACE defined every transfer is also filed in the capture buffer (I2C_Trace.c).
+//
+// Bus Speed:
+//     The DS2482-800 and the LTC2309 both run at 400 kHz.  The buses are opened here at the speed
+//     Driver_Setup() gives them (I2C_Scheduler_Configure_Bus_Speed()).  Since every transfer comes through
+//     here, the errors are counted in windows of I2C_ERROR_WINDOW_TRANSACTIONS.  Clients also report
+//     data errors the bus cannot see (scratchpad CRC failures) with I2C_Scheduler_Report_Error().
+//     Too many errors in a window and a fast bus is re-opened at 100 kHz.  Fast mode is tried again
+//     after a hold off, the hold off doubles each time fast mode fails again.  Every speed change starts
+//     a fresh window, errors counted at one speed say nothing about the other.
+//
+//     The speed changes happen inside I2C_Scheduler_Transfer() with the bus owned, so they are only
+//     recorded (Event_Log_Push()), never written out here.  Each bus has one client task for now, the
+//     temperature task on buses 0 / 1 and the ADC task on bus 2, so each bus logs to that task's source.
+//     A second client on a bus needs its own source first, the event rings take one producer each.
+//
+//     The handle changes with the speed, I2C_Scheduler_Get_Handle() is the only place to get it from.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <xdc/std.h>
+#include <xdc/runtime/Types.h>
+#include <xdc/runtime/Timestamp.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/knl/Task.h>
+#include <ti/sysbios/knl/Semaphore.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#include <ti/drivers/I2C.h>
+
+#include "constants.h"
+#include "globals.h"
+
+#include "Telemetry.h"
+#include "I2C_Scheduler.h"
+#include "Event_Log.h"
+#include "I2C_HAL.h"
+#include "I2C_Trace.h"
+#include "Static_Footprint.h"
+
+
+
+#define I2C_SCHEDULER_MAX_WAITERS			4      // tasks that can be waiting on one bus
+
+#define I2C_ERROR_WINDOW_TRANSACTIONS		256
+#define I2C_ERROR_FALLBACK_THRESHOLD		4      // errors in one window that drop a bus to 100 kHz
+#define I2C_FAST_RETRY_TICKS_MIN			600000     // 10 minutes
+#define I2C_FAST_RETRY_TICKS_MAX			86400000   // 1 day
+
+// Event_Log locations, the probe field is the bus
+#define I2C_EVENT_FALLBACK					300
+#define I2C_EVENT_RETRY_FAST				301
+#define I2C_EVENT_REOPEN_FAILED				302
+
+
+typedef struct
+{
+	Semaphore_Struct sSemaphore;
+	uint32_t uiInUse;
+	uint32_t uiPriority;
+	uint32_t uiDeadline;                // absolute Clock ticks, I2C_NO_DEADLINE for none
+	uint32_t uiSequence;                // arrival order, first come first served among equals
+} I2C_Waiter;
+
+
+typedef struct
+{
+	I2C_Handle hHandle;
+	Task_Handle hOwner;
+	uint32_t uiBusy;
+	uint32_t uiNesting;
+	uint32_t uiBatch_Counted;
+	uint32_t uiSequence;
+
+	uint32_t uiSample_Ticks;            // Clock ticks at the last utilization sample
+	uint32_t uiSample_Busy_us;
+
+	uint32_t uiBoard_Index;             // Board_I2Cx
+	uint32_t uiFast_Configured;         // from Driver_Setup(), the I2C_FAST_MODE_ defaults
+	uint32_t uiFast_Active;
+	uint32_t uiWindow_Transactions;
+	uint32_t uiWindow_Errors;
+	uint32_t uiRetry_Ticks;             // current hold off before fast mode is tried again
+	uint32_t uiRetry_At;
+
+	I2C_Waiter a_sWaiters[I2C_SCHEDULER_MAX_WAITERS];
+
+	I2C_Bus_Counters sCounters;
+} I2C_Bus;
+
+
+I2C_Bus a_sI2C_Bus[I2C_MAX_BUSES];
+
+const uint32_t g_uiI2C_Scheduler_Static_Bytes = sizeof(a_sI2C_Bus);
+STATIC_FOOTPRINT_CHECK((sizeof(a_sI2C_Bus)) <= STATIC_BUDGET_I2C_SCHEDULER, I2C_Scheduler);
+
+uint32_t g_uiI2C_Cycles_Per_us = 1;
+
+
+
+void I2C_Scheduler_Initialize(void)
+{
+	uint32_t i, j;
+
+	// no memset here, the bus speeds may already be configured
+
+	Types_FreqHz sFrequency;
+	Timestamp_getFreq(&sFrequency);
+
+	for (i = 0; i < I2C_MAX_BUSES; i++)
+	{
+		a_sI2C_Bus[i].uiRetry_Ticks = I2C_FAST_RETRY_TICKS_MIN;
+	}
+
+	g_uiI2C_Cycles_Per_us = sFrequency.lo / 1000000;
+	if (g_uiI2C_Cycles_Per_us == 0) g_uiI2C_Cycles_Per_us = 1;
+
+
+	Semaphore_Params sSemaphore_Params;
+	Semaphore_Params_init(&sSemaphore_Params);
+	sSemaphore_Params.mode = Semaphore_Mode_BINARY;
+
+	for (i = 0; i < I2C_MAX_BUSES; i++)
+	{
+		for (j = 0; j < I2C_SCHEDULER_MAX_WAITERS; j++)
+		{
+			Semaphore_construct(&a_sI2C_Bus[i].a_sWaiters[j].sSemaphore, 0, &sSemaphore_Params);
+		}
+	}
+}
+
+
+void I2C_Scheduler_Register_Bus(uint32_t uiBus, I2C_Handle hHandle)
+{
+	if (uiBus >= I2C_MAX_BUSES) return;
+
+	a_sI2C_Bus[uiBus].hHandle = hHandle;
+	a_sI2C_Bus[uiBus].uiSample_Ticks = I2C_HAL_Get_Ticks();
+}
+
+
+void I2C_Scheduler_Configure_Bus_Speed(uint32_t uiBus, uint32_t uiFast_Mode)
+{
+	// called from Driver_Setup() before the buses are opened
+	if (uiBus >= I2C_MAX_BUSES) return;
+
+	a_sI2C_Bus[uiBus].uiFast_Configured = uiFast_Mode;
+}
+
+
+void I2C_Scheduler_Clear_Window(I2C_Bus* pBus)
+{
+	// I2C_Scheduler_Report_Error() can land from another task
+	UInt uiKey = Hwi_disable();
+	pBus->uiWindow_Transactions = 0;
+	pBus->uiWindow_Errors = 0;
+	Hwi_restore(uiKey);
+}
+
+
+uint32_t I2C_Scheduler_Event_Source(I2C_Bus* pBus)
+{
+	// the source of the one task that uses this bus... see the banner
+	return ((pBus - a_sI2C_Bus) == I2C_BUS_ADC) ? EVENT_SOURCE_ADC : EVENT_SOURCE_TEMPERATURE;
+}
+
+
+I2C_Handle I2C_Scheduler_Open_Handle(I2C_Bus* pBus, uint32_t uiFast_Mode)
+{
+	I2C_Params I2C_Parameters;
+
+	I2C_Params_init(&I2C_Parameters);
+	I2C_Parameters.transferMode = I2C_MODE_BLOCKING;
+	I2C_Parameters.transferCallbackFxn = NULL;
+	I2C_Parameters.bitRate = uiFast_Mode ? I2C_400kHz : I2C_100kHz;
+
+	pBus->uiFast_Active = uiFast_Mode;
+	pBus->sCounters.ui32Bit_Rate_kHz = uiFast_Mode ? 400 : 100;
+
+	return I2C_HAL_Open((uint32_t) (pBus - a_sI2C_Bus), pBus->uiBoard_Index, &I2C_Parameters);
+}
+
+
+I2C_Handle I2C_Scheduler_Open_Bus(uint32_t uiBus, uint32_t uiBoard_Index)
+{
+	if (uiBus >= I2C_MAX_BUSES) return NULL;
+
+	I2C_Bus* pBus = &a_sI2C_Bus[uiBus];
+
+	pBus->uiBoard_Index = uiBoard_Index;
+
+	I2C_Scheduler_Register_Bus(uiBus, I2C_Scheduler_Open_Handle(pBus, pBus->uiFast_Configured));
+	I2C_Scheduler_Clear_Window(pBus);
+
+	return pBus->hHandle;
+}
+
+
+I2C_Handle I2C_Scheduler_Get_Handle(uint32_t uiBus)
+{
+	// the handle changes when the bus speed changes, don't hang on to it
+	if (uiBus >= I2C_MAX_BUSES) return NULL;
+
+	return a_sI2C_Bus[uiBus].hHandle;
+}
+
+
+void I2C_Scheduler_Report_Error(uint32_t uiBus)
+{
+	// data errors the I2C driver can't see (CRC) count against the bus too
+	if (uiBus >= I2C_MAX_BUSES) return;
+
+	UInt uiKey = Hwi_disable();
+	a_sI2C_Bus[uiBus].uiWindow_Errors++;
+	a_sI2C_Bus[uiBus].sCounters.ui32Errors++;
+	Hwi_restore(uiKey);
+}
+
+
+void I2C_Scheduler_Change_Bus_Speed(I2C_Bus* pBus, uint32_t uiFast_Mode)
+{
+	// only called by the owner of the bus, nothing else is on the wire
+	I2C_HAL_Close((uint32_t) (pBus - a_sI2C_Bus), pBus->hHandle);
+
+	pBus->hHandle = I2C_Scheduler_Open_Handle(pBus, uiFast_Mode);
+	if (pBus->hHandle == NULL)
+	{
+		// that speed won't open at all, go back to what worked
+		Event_Log_Push(I2C_Scheduler_Event_Source(pBus), (uint32_t) (pBus - a_sI2C_Bus), I2C_EVENT_REOPEN_FAILED, 0, uiFast_Mode,
+					   "I2C_Scheduler_Change_Bus_Speed()  Unable To Open, Reverting...");
+		pBus->hHandle = I2C_Scheduler_Open_Handle(pBus, !uiFast_Mode);
+	}
+
+	// whichever speed it ended up at, the window starts over
+	I2C_Scheduler_Clear_Window(pBus);
+}
+
+
+void I2C_Scheduler_Check_Bus_Speed(I2C_Bus* pBus, uint32_t uiFailed)
+{
+	uint32_t uiNow = I2C_HAL_Get_Ticks();
+
+	pBus->uiWindow_Transactions++;
+	if (uiFailed) pBus->uiWindow_Errors++;
+
+
+	if (pBus->uiFast_Active && (pBus->uiWindow_Errors >= I2C_ERROR_FALLBACK_THRESHOLD))
+	{
+		pBus->sCounters.ui32Error_Rate_ppm = (uint32_t) (((uint64_t) pBus->uiWindow_Errors * 1000000) / pBus->uiWindow_Transactions);
+		pBus->sCounters.ui32Fallbacks++;
+
+		Event_Log_Push(I2C_Scheduler_Event_Source(pBus), (uint32_t) (pBus - a_sI2C_Bus), I2C_EVENT_FALLBACK, pBus->uiWindow_Errors, pBus->uiWindow_Transactions,
+					   "I2C_Scheduler_Check_Bus_Speed()  Falling Back To 100 kHz");
+
+		pBus->uiRetry_At = uiNow + pBus->uiRetry_Ticks;
+
+		pBus->uiRetry_Ticks *= 2;
+		if (pBus->uiRetry_Ticks > I2C_FAST_RETRY_TICKS_MAX) pBus->uiRetry_Ticks = I2C_FAST_RETRY_TICKS_MAX;
+
+		I2C_Scheduler_Change_Bus_Speed(pBus, false);
+		return;
+	}
+
+
+	if (pBus->uiWindow_Transactions >= I2C_ERROR_WINDOW_TRANSACTIONS)
+	{
+		pBus->sCounters.ui32Error_Rate_ppm = (uint32_t) (((uint64_t) pBus->uiWindow_Errors * 1000000) / pBus->uiWindow_Transactions);
+
+		// a clean window in fast mode earns back the short hold off
+		if (pBus->uiFast_Active && (pBus->uiWindow_Errors == 0))
+		{
+			pBus->uiRetry_Ticks = I2C_FAST_RETRY_TICKS_MIN;
+		}
+
+		I2C_Scheduler_Clear_Window(pBus);
+	}
+
+
+	if (pBus->uiFast_Configured && (pBus->uiFast_Active == false) && ((int32_t) (uiNow - pBus->uiRetry_At) >= 0))
+	{
+		Event_Log_Push(I2C_Scheduler_Event_Source(pBus), (uint32_t) (pBus - a_sI2C_Bus), I2C_EVENT_RETRY_FAST, 0, pBus->uiRetry_Ticks,
+					   "I2C_Scheduler_Check_Bus_Speed()  Retrying 400 kHz");
+
+		I2C_Scheduler_Change_Bus_Speed(pBus, true);
+	}
+}
+
+
+uint32_t I2C_Scheduler_Deadline_Before(uint32_t uiDeadline_A, uint32_t uiDeadline_B)
+{
+	// no deadline is always last
+	if (uiDeadline_A == I2C_NO_DEADLINE) return false;
+	if (uiDeadline_B == I2C_NO_DEADLINE) return true;
+
+	return ((int32_t) (uiDeadline_A - uiDeadline_B) < 0);
+}
+
+
+uint32_t I2C_Scheduler_Acquire(uint32_t uiBus, uint32_t uiPriority, uint32_t uiDeadline_Ticks)
+{
+	// uiDeadline_Ticks is relative, I2C_NO_DEADLINE if the caller does not care
+
+	if (uiBus >= I2C_MAX_BUSES) return I2C_SCHEDULER_ERR_INVALID_BUS;
+
+	I2C_Bus* pBus = &a_sI2C_Bus[uiBus];
+	Task_Handle hSelf = Task_self();
+
+	uint32_t uiDeadline = I2C_NO_DEADLINE;
+	if (uiDeadline_Ticks != I2C_NO_DEADLINE)
+	{
+		uiDeadline = I2C_HAL_Get_Ticks() + uiDeadline_Ticks;
+		if (uiDeadline == I2C_NO_DEADLINE) uiDeadline = 1;
+	}
+
+	if (uiPriority >= I2C_MAX_PRIORITIES) uiPriority = I2C_PRIORITY_BULK;
+
+
+	UInt uiKey = Hwi_disable();
+
+	// already ours?  (inside a batch)
+	if (pBus->uiBusy && (pBus->hOwner == hSelf))
+	{
+		if (pBus->uiBatch_Counted == false)
+		{
+			pBus->sCounters.ui32Batches++;
+			pBus->uiBatch_Counted = true;
+		}
+
+		pBus->uiNesting++;
+		Hwi_restore(uiKey);
+		return I2C_MASTER_ERR_NONE;
+	}
+
+	// free?  go right through...
+	if (pBus->uiBusy == false)
+	{
+		pBus->uiBusy = true;
+		pBus->hOwner = hSelf;
+		pBus->uiNesting = 1;
+		Hwi_restore(uiKey);
+		return I2C_MASTER_ERR_NONE;
+	}
+
+
+	// busy, get in line
+	I2C_Waiter* pWaiter = NULL;
+	uint32_t i;
+	for (i = 0; i < I2C_SCHEDULER_MAX_WAITERS; i++)
+	{
+		if (pBus->a_sWaiters[i].uiInUse == false)
+		{
+			pWaiter = &pBus->a_sWaiters[i];
+			break;
+		}
+	}
+
+	if (pWaiter == NULL)
+	{
+		pBus->sCounters.ui32Errors++;
+		Hwi_restore(uiKey);
+		return I2C_SCHEDULER_ERR_QUEUE_FULL;
+	}
+
+	pWaiter->uiInUse = true;
+	pWaiter->uiPriority = uiPriority;
+	pWaiter->uiDeadline = uiDeadline;
+	pWaiter->uiSequence = pBus->uiSequence++;
+
+	pBus->sCounters.ui32Queue_Depth++;
+	if (pBus->sCounters.ui32Queue_Depth > pBus->sCounters.ui32Max_Queue_Depth)
+	{
+		pBus->sCounters.ui32Max_Queue_Depth = pBus->sCounters.ui32Queue_Depth;
+	}
+
+	Hwi_restore(uiKey);
+
+
+	// I2C_Scheduler_Release() hands the bus straight to us, it stays busy in between.
+	Semaphore_pend(Semaphore_handle(&pWaiter->sSemaphore), BIOS_WAIT_FOREVER);
+
+
+	uiKey = Hwi_disable();
+
+	pBus->hOwner = hSelf;
+	pBus->uiNesting = 1;
+	pWaiter->uiInUse = false;
+
+	if ((uiDeadline != I2C_NO_DEADLINE) && I2C_Scheduler_Deadline_Before(uiDeadline, I2C_HAL_Get_Ticks()))
+	{
+		pBus->sCounters.ui32Deadline_Misses++;
+	}
+
+	Hwi_restore(uiKey);
+
+	return I2C_MASTER_ERR_NONE;
+}
+
+
+void I2C_Scheduler_Release(uint32_t uiBus)
+{
+	if (uiBus >= I2C_MAX_BUSES) return;
+
+	I2C_Bus* pBus = &a_sI2C_Bus[uiBus];
+
+	UInt uiKey = Hwi_disable();
+
+	// only the owner gives the bus back... anyone else would hand a bus they never had to the next waiter
+	if ((pBus->uiBusy == false) || (pBus->hOwner != Task_self()))
+	{
+		pBus->sCounters.ui32Errors++;
+		Hwi_restore(uiKey);
+		return;
+	}
+
+	if (pBus->uiNesting > 1)
+	{
+		pBus->uiNesting--;
+		Hwi_restore(uiKey);
+		return;
+	}
+
+
+	// pick the next one... priority, then deadline, then arrival
+	I2C_Waiter* pNext = NULL;
+	I2C_Waiter* pOldest = NULL;
+	uint32_t i;
+	for (i = 0; i < I2C_SCHEDULER_MAX_WAITERS; i++)
+	{
+		I2C_Waiter* pWaiter = &pBus->a_sWaiters[i];
+
+		if (pWaiter->uiInUse == false) continue;
+
+		if ((pOldest == NULL) || ((int32_t) (pWaiter->uiSequence - pOldest->uiSequence) < 0))
+		{
+			pOldest = pWaiter;
+		}
+
+		if (pNext == NULL)
+		{
+			pNext = pWaiter;
+		}
+		else if (pWaiter->uiPriority < pNext->uiPriority)
+		{
+			pNext = pWaiter;
+		}
+		else if (pWaiter->uiPriority == pNext->uiPriority)
+		{
+			if (I2C_Scheduler_Deadline_Before(pWaiter->uiDeadline, pNext->uiDeadline))
+			{
+				pNext = pWaiter;
+			}
+			else if ((pWaiter->uiDeadline == pNext->uiDeadline) && ((int32_t) (pWaiter->uiSequence - pNext->uiSequence) < 0))
+			{
+				pNext = pWaiter;
+			}
+		}
+	}
+
+
+	pBus->uiNesting = 0;
+	pBus->uiBatch_Counted = false;
+	pBus->hOwner = NULL;
+
+	if (pNext == NULL)
+	{
+		pBus->uiBusy = false;
+		Hwi_restore(uiKey);
+		return;
+	}
+
+	if (pNext != pOldest)
+	{
+		pBus->sCounters.ui32Preemptions++;
+	}
+
+	pBus->sCounters.ui32Queue_Depth--;
+
+	Hwi_restore(uiKey);
+
+	Semaphore_post(Semaphore_handle(&pNext->sSemaphore));
+}
+
+
+uint32_t I2C_Scheduler_Transfer(uint32_t uiBus, uint32_t uiPriority, uint32_t uiDeadline_Ticks, I2C_Transaction* pTransaction)
+{
+	// Same result as the old I2C_transfer() / I2C_control() pair...
+	// I2C_MASTER_ERR_NONE on success, otherwise whatever I2C_control() reports.
+
+	uint32_t ui32ErrorCode = I2C_Scheduler_Acquire(uiBus, uiPriority, uiDeadline_Ticks);
+	if (ui32ErrorCode != I2C_MASTER_ERR_NONE)
+	{
+		return ui32ErrorCode;
+	}
+
+	I2C_Bus* pBus = &a_sI2C_Bus[uiBus];
+
+	if (pBus->hHandle == NULL)
+	{
+		I2C_Scheduler_Release(uiBus);
+		return I2C_SCHEDULER_ERR_NO_HANDLE;
+	}
+
+
+	uint32_t ui32Start = I2C_HAL_Timestamp();
+
+	bool bTransferOK = I2C_HAL_Transfer(uiBus, pBus->hHandle, pTransaction);
+
+	uint32_t ui32Elapsed = I2C_HAL_Timestamp() - ui32Start;
+
+
+	pBus->sCounters.ui32Transactions++;
+	pBus->sCounters.ui32Busy_us += ui32Elapsed / g_uiI2C_Cycles_Per_us;
+
+	if (bTransferOK == false)
+	{
+		pBus->sCounters.ui32Errors++;
+		ui32ErrorCode = I2C_HAL_Error(uiBus, pBus->hHandle);
+	}
+
+	I2C_TRACE_RECORD(uiBus, pTransaction, ui32Start, ui32ErrorCode);
+
+	I2C_Scheduler_Check_Bus_Speed(pBus, (bTransferOK == false));
+
+	I2C_Scheduler_Release(uiBus);
+
+	return ui32ErrorCode;
+}
+
+
+void I2C_Scheduler_Sample_Utilization(void)
+{
+	// call this at a steady rate (the one second timer) so the utilization means something.
+	uint32_t i;
+
+	for (i = 0; i < I2C_MAX_BUSES; i++)
+	{
+		I2C_Bus* pBus = &a_sI2C_Bus[i];
+
+		uint32_t uiNow = I2C_HAL_Get_Ticks();
+		uint32_t uiElapsed_us = (uiNow - pBus->uiSample_Ticks) * 1000;
+		uint32_t uiBusy_us = pBus->sCounters.ui32Busy_us - pBus->uiSample_Busy_us;
+
+		if (uiElapsed_us)
+		{
+			pBus->sCounters.ui32Utilization_bp = (uint32_t) (((uint64_t) uiBusy_us * 10000) / uiElapsed_us);
+		}
+
+		pBus->uiSample_Ticks = uiNow;
+		pBus->uiSample_Busy_us = pBus->sCounters.ui32Busy_us;
+	}
+}
+
+
+void I2C_Scheduler_Get_Counters(uint32_t uiBus, I2C_Bus_Counters* pCounters)
+{
+	if (uiBus >= I2C_MAX_BUSES) return;
+
+	UInt uiKey = Hwi_disable();
+	*pCounters = a_sI2C_Bus[uiBus].sCounters;
+	Hwi_restore(uiKey);
+}
+
+
+void I2C_Scheduler_Report_Telemetry(void)
+{
+	uint32_t i;
+	I2C_Bus_Counters sCounters;
+
+	for (i = 0; i < I2C_MAX_BUSES; i++)
+	{
+		I2C_Scheduler_Get_Counters(i, &sCounters);
+
+		Telemetry_Send_Output_Value("I2C Bus: ", i);
+		Telemetry_Send_Output_Value("    Speed (kHz): ", sCounters.ui32Bit_Rate_kHz);
+		Telemetry_Send_Output_Value("    Error Rate (ppm): ", sCounters.ui32Error_Rate_ppm);
+		Telemetry_Send_Output_Value("    Fallbacks: ", sCounters.ui32Fallbacks);
+		Telemetry_Send_Output_Value("    Utilization (1/100 %): ", sCounters.ui32Utilization_bp);
+		Telemetry_Send_Output_Value("    Max Queue Depth: ", sCounters.ui32Max_Queue_Depth);
+		Telemetry_Send_Output_Value("    Deadline Misses: ", sCounters.ui32Deadline_Misses);
+	}
+}
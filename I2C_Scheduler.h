@@ -0,0 +1,78 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// I2C Scheduler - per bus arbitration for the Temperature and ADC clients.
+//
+//*****************************************************************************
+
+#ifndef I2C_SCHEDULER_H_
+#define I2C_SCHEDULER_H_
+
+#include <stdint.h>
+
+#include <ti/drivers/I2C.h>
+
+
+// Buses
+#define I2C_BUS_TEMPERATURE_0_7				0
+#define I2C_BUS_TEMPERATURE_8_15			1
+#define I2C_BUS_ADC							2
+#define I2C_MAX_BUSES						3
+
+// Priorities - lower is more important
+#define I2C_PRIORITY_CRITICAL				0      // latency critical, ADC reads
+#define I2C_PRIORITY_NORMAL					1      // DS2482 commands and status polling
+#define I2C_PRIORITY_BULK					2      // scratchpad / ROM reads
+#define I2C_MAX_PRIORITIES					3
+
+#define I2C_NO_DEADLINE						0
+
+// Bus speed at boot - 1 opens the bus at 400 kHz, 0 at 100 kHz.  These belong in the EEPROM data, but that
+// layout lives in globals.h with the EEPROM utilities, so until a field is added there they are compile time.
+// A fast bus still drops back to 100 kHz on its own when the error rate climbs.
+#define I2C_FAST_MODE_TEMPERATURE_0_7		1      // DS2482-800, good to 400 kHz
+#define I2C_FAST_MODE_TEMPERATURE_8_15		1
+#define I2C_FAST_MODE_ADC					1      // LTC2309, good to 400 kHz
+
+// Errors - kept clear of the I2C_MASTER_ERR_ bits returned by I2C_control()
+#define I2C_SCHEDULER_ERR_QUEUE_FULL		8192
+#define I2C_SCHEDULER_ERR_INVALID_BUS		8193
+#define I2C_SCHEDULER_ERR_NO_HANDLE			8194
+
+
+typedef struct
+{
+	uint32_t ui32Transactions;
+	uint32_t ui32Errors;
+	uint32_t ui32Busy_us;               // time spent inside I2C_transfer()
+	uint32_t ui32Utilization_bp;        // basis points (1/100 %) over the last sample period
+	uint32_t ui32Queue_Depth;           // waiting right now
+	uint32_t ui32Max_Queue_Depth;
+	uint32_t ui32Deadline_Misses;
+	uint32_t ui32Preemptions;           // a higher priority waiter went ahead of an older one
+	uint32_t ui32Batches;
+	uint32_t ui32Bit_Rate_kHz;          // 100 or 400
+	uint32_t ui32Error_Rate_ppm;        // errors per million transactions, last completed window
+	uint32_t ui32Fallbacks;             // times the bus dropped out of fast mode
+} I2C_Bus_Counters;
+
+
+void I2C_Scheduler_Initialize(void);
+void I2C_Scheduler_Register_Bus(uint32_t uiBus, I2C_Handle hHandle);
+
+void I2C_Scheduler_Configure_Bus_Speed(uint32_t uiBus, uint32_t uiFast_Mode);
+I2C_Handle I2C_Scheduler_Open_Bus(uint32_t uiBus, uint32_t uiBoard_Index);
+I2C_Handle I2C_Scheduler_Get_Handle(uint32_t uiBus);
+void I2C_Scheduler_Report_Error(uint32_t uiBus);
+
+uint32_t I2C_Scheduler_Acquire(uint32_t uiBus, uint32_t uiPriority, uint32_t uiDeadline_Ticks);
+void I2C_Scheduler_Release(uint32_t uiBus);
+
+uint32_t I2C_Scheduler_Transfer(uint32_t uiBus, uint32_t uiPriority, uint32_t uiDeadline_Ticks, I2C_Transaction* pTransaction);
+
+void I2C_Scheduler_Sample_Utilization(void);
+void I2C_Scheduler_Get_Counters(uint32_t uiBus, I2C_Bus_Counters* pCounters);
+void I2C_Scheduler_Report_Telemetry(void);
+
+#endif /* I2C_SCHEDULER_H_ */
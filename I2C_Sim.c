@@ -0,0 +1,833 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Nothing in the acquisition path could run off the board... I2C_Scheduler.c and Temperature_Interface.c
+// called I2C_transfer(), SysCtlDelay() and Clock_getTicks() directly.  They now go through I2C_HAL.h,
+// and with I2C_HAL_SIMULATOR defined that lands here.  This is a PC module, it is not part of the board
+// build.
+//
+// Simulated parts:
+//     DS2482-800 - the register pointer, status (1WB, PPD, SD, RST), read data, configuration and channel
+//                  select registers, device reset, 1-Wire reset / write byte / read byte.  A 1-Wire
+//                  command holds 1WB set for as long as it takes on the wire, 1-Wire commands sent while
+//                  1WB is set are not acknowledged.
+//     DS18B20    - skip ROM, read ROM, convert, read / write / copy scratchpad.  The conversion takes
+//                  94 / 188 / 375 / 750ms for 9 - 12 bits, a read before then returns the old value.
+//                  The scratchpad and ROM CRCs are real.
+//     LTC2309    - the config byte written starts a conversion at the stop, the read returns the
+//                  conversion from the stop before.  The channel is decoded from the config byte.
+//
+// Timing:
+//     A transfer costs a start, 9 bits for the address and each data byte, a repeated start if it
+//     reads after writing, and a stop, at the bit rate the bus was opened at (100 or 400 kHz), plus an
+//     optional fixed overhead for the driver.  A 1-Wire reset is 1148us, a byte is 8 x 70us slots.
+//     I2C_Sim_Delay() counts like SysCtlDelay(), 3 CPU cycles a count.
+//
+// The per bus counters (wire time, 1-Wire time, transfers, bytes, NACKs, busy polls) are what the bench
+// reports for each acquisition cycle.
+//
+// Replay:
+//     I2C_Sim_Load_Trace() reads a console capture of I2C_Trace_Dump().  From then on a transfer that
+//     matches the next record (bus, address, counts, write bytes) is answered with the recorded read
+//     bytes and result, whatever the parts above would have said.  The same driver code that ran on the
+//     board then sees the same status bytes, busy polls, NACKs and temperatures, every run.  The first
+//     transfer that doesn't match ends the replay (the order is lost from there on), the parts answer
+//     from then on and I2C_Sim_Get_Replay_Counters() says where.  A capture has to start where the replay
+//     run starts, the top of an acquisition cycle.
+//
+//*****************************************************************************
+
+#ifdef I2C_HAL_SIMULATOR
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "I2C_Sim.h"
+#include "I2C_Trace.h"
+
+
+
+#define I2C_SIM_DS2482_ADDRESS				0x18
+#define I2C_SIM_LTC2309_ADDRESS				0x08
+#define I2C_SIM_ADC_BUS						2
+
+#define I2C_SIM_ONE_WIRE_RESET_NS			1148000    // tRSTL + tRSTH, standard speed
+#define I2C_SIM_ONE_WIRE_BYTE_NS			560000     // 8 x 70us time slots
+#define I2C_SIM_CONVERT_12_BIT_NS			750000000  // halves for each bit less
+
+// DS2482 commands and register pointer codes
+#define SIM_DS2482_DEVICE_RESET				0xF0
+#define SIM_DS2482_SET_READ_POINTER			0xE1
+#define SIM_DS2482_WRITE_CONFIGURATION		0xD2
+#define SIM_DS2482_CHANNEL_SELECT			0xC3
+#define SIM_DS2482_ONE_WIRE_RESET			0xB4
+#define SIM_DS2482_ONE_WIRE_WRITE_BYTE		0xA5
+#define SIM_DS2482_ONE_WIRE_READ_BYTE		0x96
+
+#define SIM_DS2482_STATUS_REGISTER			0xF0
+#define SIM_DS2482_DATA_REGISTER			0xE1
+#define SIM_DS2482_CHANNEL_REGISTER			0xD2
+#define SIM_DS2482_CONFIGURATION_REGISTER	0xC3
+
+#define SIM_DS2482_STATUS_1WB				0x01
+#define SIM_DS2482_STATUS_PPD				0x02
+#define SIM_DS2482_STATUS_SD				0x04
+#define SIM_DS2482_STATUS_RST				0x10
+
+// DS18B20 commands
+#define SIM_DS18B20_READ_ROM				0x33
+#define SIM_DS18B20_SKIP_ROM				0xCC
+#define SIM_DS18B20_CONVERT_TEMP			0x44
+#define SIM_DS18B20_READ_SCRATCHPAD			0xBE
+#define SIM_DS18B20_WRITE_SCRATCHPAD		0x4E
+#define SIM_DS18B20_COPY_SCRATCHPAD			0x48
+#define SIM_DS18B20_READ_POWER_SUPPLY		0xB4
+
+// DS18B20 1-Wire states
+#define SIM_PROBE_IDLE						0      // waiting for a reset
+#define SIM_PROBE_ROM_COMMAND				1
+#define SIM_PROBE_FUNCTION_COMMAND			2
+#define SIM_PROBE_WRITE_SCRATCHPAD			3
+#define SIM_PROBE_READ						4
+
+#define SIM_DS18B20_POWER_UP_TEMPERATURE	0x0550     // 85C
+
+
+typedef struct
+{
+	uint32_t uiPresent;
+	uint32_t uiState;
+	uint8_t a_ui8ROM[8];
+	uint8_t a_ui8Scratchpad[9];
+	uint8_t a_ui8EEPROM[3];             // TH, TL, configuration
+	uint8_t a_ui8Out[9];
+	uint32_t uiOut_Count;
+	uint32_t uiOut_Index;
+	uint32_t uiWrite_Index;
+	int16_t i16Temperature_16ths;       // what the probe is sitting in
+	uint32_t uiConverting;
+	uint64_t ui64Convert_Done_ns;
+} I2C_Sim_DS18B20;
+
+
+typedef struct
+{
+	uint8_t ui8Pointer;
+	uint8_t ui8Status;                  // PPD, SD, RST... 1WB comes from ui64Busy_Until_ns
+	uint8_t ui8Data;
+	uint8_t ui8Configuration;
+	uint32_t uiChannel;
+	uint64_t ui64Busy_Until_ns;
+	I2C_Sim_DS18B20 a_sProbe[I2C_SIM_CHANNELS];
+} I2C_Sim_DS2482;
+
+
+typedef struct
+{
+	uint8_t ui8Config;                  // the config byte of the conversion in progress
+	uint16_t ui16Result;                // 12 bits, from the conversion before
+	uint16_t a_ui16Code[I2C_SIM_CHANNELS];
+} I2C_Sim_LTC2309;
+
+
+typedef struct
+{
+	uint32_t uiOpen;
+	uint32_t uiError;
+	I2C_Sim_Counters sCounters;
+} I2C_Sim_Bus;
+
+
+typedef struct
+{
+	I2C_Trace_Record* pRecords;
+	uint32_t uiNext;
+	uint32_t uiCycles_Per_us;           // the board's Timestamp rate, from the dump
+	uint64_t ui64First_ns;              // simulated time of the first replayed transfer
+	I2C_Sim_Replay_Counters sCounters;
+} I2C_Sim_Replay;
+
+
+I2C_Sim_Bus a_sSim_Bus[I2C_SIM_MAX_BUSES];
+I2C_Sim_DS2482 a_sSim_DS2482[I2C_SIM_ADC_BUS];    // buses 0 and 1
+I2C_Sim_LTC2309 g_sSim_LTC2309;
+
+I2C_Sim_Replay g_sSim_Replay;
+
+uint64_t g_ui64Sim_Now_ns;
+uint32_t g_ui32Sim_Transfer_Overhead_ns;
+
+// channel select codes, written and read back
+const uint8_t a_ui8Sim_Channel_Write[I2C_SIM_CHANNELS]  = {0xF0, 0xE1, 0xD2, 0xC3, 0xB4, 0xA5, 0x96, 0x87};
+const uint8_t a_ui8Sim_Channel_Verify[I2C_SIM_CHANNELS] = {0xB8, 0xB1, 0xAA, 0xA3, 0x9C, 0x95, 0x8E, 0x87};
+
+
+
+static uint8_t I2C_Sim_CRC8(const uint8_t* pData, uint32_t uiLength)
+{
+	// Dallas / Maxim 1-Wire CRC, the same one Temperature_Interface.c checks
+	uint8_t ui8CRC = 0;
+	uint32_t i, j;
+
+	for (i = 0; i < uiLength; i++)
+	{
+		uint8_t ui8Byte = pData[i];
+
+		for (j = 0; j < 8; j++)
+		{
+			uint8_t ui8Mix = (ui8CRC ^ ui8Byte) & 0x01;
+			ui8CRC >>= 1;
+			if (ui8Mix) ui8CRC ^= 0x8C;
+			ui8Byte >>= 1;
+		}
+	}
+
+	return ui8CRC;
+}
+
+
+static void I2C_Sim_Probe_Power_Up(I2C_Sim_DS18B20* pProbe, uint32_t uiBus, uint32_t uiChannel)
+{
+	pProbe->uiState = SIM_PROBE_IDLE;
+	pProbe->uiConverting = false;
+
+	pProbe->a_ui8ROM[0] = 0x28;                         // DS18B20 family code
+	pProbe->a_ui8ROM[1] = (uint8_t) uiChannel;
+	pProbe->a_ui8ROM[2] = (uint8_t) uiBus;
+	pProbe->a_ui8ROM[3] = 0x5A;
+	pProbe->a_ui8ROM[4] = 0x1E;
+	pProbe->a_ui8ROM[5] = 0x00;
+	pProbe->a_ui8ROM[6] = 0x00;
+	pProbe->a_ui8ROM[7] = I2C_Sim_CRC8(pProbe->a_ui8ROM, 7);
+
+	// factory EEPROM and the power up scratchpad
+	pProbe->a_ui8EEPROM[0] = 0x4B;
+	pProbe->a_ui8EEPROM[1] = 0x46;
+	pProbe->a_ui8EEPROM[2] = 0x7F;
+
+	pProbe->a_ui8Scratchpad[0] = SIM_DS18B20_POWER_UP_TEMPERATURE & 0xFF;
+	pProbe->a_ui8Scratchpad[1] = SIM_DS18B20_POWER_UP_TEMPERATURE >> 8;
+	pProbe->a_ui8Scratchpad[2] = pProbe->a_ui8EEPROM[0];
+	pProbe->a_ui8Scratchpad[3] = pProbe->a_ui8EEPROM[1];
+	pProbe->a_ui8Scratchpad[4] = pProbe->a_ui8EEPROM[2];
+	pProbe->a_ui8Scratchpad[5] = 0xFF;
+	pProbe->a_ui8Scratchpad[6] = 0x0C;
+	pProbe->a_ui8Scratchpad[7] = 0x10;
+	pProbe->a_ui8Scratchpad[8] = I2C_Sim_CRC8(pProbe->a_ui8Scratchpad, 8);
+}
+
+
+static void I2C_Sim_Probe_Finish_Conversion(I2C_Sim_DS18B20* pProbe)
+{
+	if ((pProbe->uiConverting == false) || (g_ui64Sim_Now_ns < pProbe->ui64Convert_Done_ns)) return;
+
+	// the undefined low bits of a short conversion read back as 0
+	uint32_t uiResolution = (pProbe->a_ui8Scratchpad[4] >> 5) & 0x03;
+	uint16_t ui16Raw = (uint16_t) pProbe->i16Temperature_16ths & (uint16_t) (0xFFFF << (3 - uiResolution));
+
+	pProbe->a_ui8Scratchpad[0] = ui16Raw & 0xFF;
+	pProbe->a_ui8Scratchpad[1] = ui16Raw >> 8;
+	pProbe->a_ui8Scratchpad[8] = I2C_Sim_CRC8(pProbe->a_ui8Scratchpad, 8);
+
+	pProbe->uiConverting = false;
+}
+
+
+static uint32_t I2C_Sim_Probe_Reset(I2C_Sim_DS18B20* pProbe)
+{
+	// returns the presence pulse
+	if (pProbe->uiPresent == false) return false;
+
+	pProbe->uiState = SIM_PROBE_ROM_COMMAND;
+	return true;
+}
+
+
+static void I2C_Sim_Probe_Load_Out(I2C_Sim_DS18B20* pProbe, const uint8_t* pData, uint32_t uiCount)
+{
+	memcpy(pProbe->a_ui8Out, pData, uiCount);
+	pProbe->uiOut_Count = uiCount;
+	pProbe->uiOut_Index = 0;
+	pProbe->uiState = SIM_PROBE_READ;
+}
+
+
+static void I2C_Sim_Probe_Write_Byte(I2C_Sim_DS18B20* pProbe, uint8_t ui8Byte)
+{
+	uint8_t ui8Power = 0xFF;   // externally powered
+
+	if (pProbe->uiPresent == false) return;
+
+	switch (pProbe->uiState)
+	{
+		case SIM_PROBE_ROM_COMMAND:
+			if (ui8Byte == SIM_DS18B20_SKIP_ROM) pProbe->uiState = SIM_PROBE_FUNCTION_COMMAND;
+			else if (ui8Byte == SIM_DS18B20_READ_ROM) I2C_Sim_Probe_Load_Out(pProbe, pProbe->a_ui8ROM, 8);
+			else pProbe->uiState = SIM_PROBE_IDLE;
+			break;
+
+		case SIM_PROBE_FUNCTION_COMMAND:
+			pProbe->uiState = SIM_PROBE_IDLE;
+
+			if (ui8Byte == SIM_DS18B20_CONVERT_TEMP)
+			{
+				uint32_t uiResolution = (pProbe->a_ui8Scratchpad[4] >> 5) & 0x03;
+
+				pProbe->uiConverting = true;
+				pProbe->ui64Convert_Done_ns = g_ui64Sim_Now_ns + (I2C_SIM_CONVERT_12_BIT_NS >> (3 - uiResolution));
+			}
+			else if (ui8Byte == SIM_DS18B20_READ_SCRATCHPAD)
+			{
+				I2C_Sim_Probe_Finish_Conversion(pProbe);
+				I2C_Sim_Probe_Load_Out(pProbe, pProbe->a_ui8Scratchpad, 9);
+			}
+			else if (ui8Byte == SIM_DS18B20_WRITE_SCRATCHPAD)
+			{
+				pProbe->uiWrite_Index = 0;
+				pProbe->uiState = SIM_PROBE_WRITE_SCRATCHPAD;
+			}
+			else if (ui8Byte == SIM_DS18B20_COPY_SCRATCHPAD)
+			{
+				memcpy(pProbe->a_ui8EEPROM, &pProbe->a_ui8Scratchpad[2], 3);
+			}
+			else if (ui8Byte == SIM_DS18B20_READ_POWER_SUPPLY)
+			{
+				I2C_Sim_Probe_Load_Out(pProbe, &ui8Power, 1);
+			}
+			break;
+
+		case SIM_PROBE_WRITE_SCRATCHPAD:
+			// TH, TL, then the configuration... only the R1 R0 bits are writable
+			if (pProbe->uiWrite_Index == 2) ui8Byte = (ui8Byte & 0x60) | 0x1F;
+
+			pProbe->a_ui8Scratchpad[2 + pProbe->uiWrite_Index] = ui8Byte;
+			pProbe->uiWrite_Index++;
+
+			if (pProbe->uiWrite_Index >= 3)
+			{
+				pProbe->a_ui8Scratchpad[8] = I2C_Sim_CRC8(pProbe->a_ui8Scratchpad, 8);
+				pProbe->uiState = SIM_PROBE_IDLE;
+			}
+			break;
+
+		default:
+			break;
+	}
+}
+
+
+static uint8_t I2C_Sim_Probe_Read_Byte(I2C_Sim_DS18B20* pProbe)
+{
+	// nobody driving the line reads back as all 1's
+	if ((pProbe->uiPresent == false) || (pProbe->uiState != SIM_PROBE_READ)) return 0xFF;
+
+	if (pProbe->uiOut_Index >= pProbe->uiOut_Count) return 0xFF;
+
+	return pProbe->a_ui8Out[pProbe->uiOut_Index++];
+}
+
+
+static uint32_t I2C_Sim_DS2482_Write(I2C_Sim_Bus* pBus, I2C_Sim_DS2482* pChip, const uint8_t* pWrite, uint32_t uiWrite_Count)
+{
+	// returns I2C_SIM_ERR_NONE or the NACK
+	uint32_t uiBusy = (g_ui64Sim_Now_ns < pChip->ui64Busy_Until_ns);
+	uint32_t i;
+
+	if (uiWrite_Count == 0) return I2C_SIM_ERR_NONE;
+
+	uint8_t ui8Command = pWrite[0];
+	uint8_t ui8Parameter = (uiWrite_Count > 1) ? pWrite[1] : 0;
+
+	I2C_Sim_DS18B20* pProbe = &pChip->a_sProbe[pChip->uiChannel];
+
+	switch (ui8Command)
+	{
+		case SIM_DS2482_DEVICE_RESET:
+			pChip->ui8Status = SIM_DS2482_STATUS_RST;
+			pChip->ui8Configuration = 0;
+			pChip->ui8Data = 0;
+			pChip->uiChannel = 0;
+			pChip->ui64Busy_Until_ns = 0;
+			pChip->ui8Pointer = SIM_DS2482_STATUS_REGISTER;
+			return I2C_SIM_ERR_NONE;
+
+		case SIM_DS2482_SET_READ_POINTER:
+			if ((uiWrite_Count < 2) || ((ui8Parameter != SIM_DS2482_STATUS_REGISTER) && (ui8Parameter != SIM_DS2482_DATA_REGISTER) &&
+					(ui8Parameter != SIM_DS2482_CHANNEL_REGISTER) && (ui8Parameter != SIM_DS2482_CONFIGURATION_REGISTER)))
+			{
+				return I2C_SIM_ERR_DATA_NACK;
+			}
+
+			pChip->ui8Pointer = ui8Parameter;
+			return I2C_SIM_ERR_NONE;
+
+		case SIM_DS2482_WRITE_CONFIGURATION:
+			if ((uiWrite_Count < 2) || uiBusy) return I2C_SIM_ERR_DATA_NACK;
+
+			// the upper nibble has to be the complement of the lower
+			if ((uint8_t) ((ui8Parameter >> 4) ^ 0x0F) == (ui8Parameter & 0x0F))
+			{
+				pChip->ui8Configuration = ui8Parameter & 0x0F;
+				pChip->ui8Status &= ~SIM_DS2482_STATUS_RST;
+			}
+
+			pChip->ui8Pointer = SIM_DS2482_CONFIGURATION_REGISTER;
+			return I2C_SIM_ERR_NONE;
+
+		case SIM_DS2482_CHANNEL_SELECT:
+			if ((uiWrite_Count < 2) || uiBusy) return I2C_SIM_ERR_DATA_NACK;
+
+			for (i = 0; i < I2C_SIM_CHANNELS; i++)
+			{
+				if (a_ui8Sim_Channel_Write[i] == ui8Parameter) pChip->uiChannel = i;
+			}
+
+			pChip->ui8Pointer = SIM_DS2482_CHANNEL_REGISTER;
+			return I2C_SIM_ERR_NONE;
+
+		case SIM_DS2482_ONE_WIRE_RESET:
+			if (uiBusy) return I2C_SIM_ERR_DATA_NACK;
+
+			pChip->ui8Status &= ~(SIM_DS2482_STATUS_PPD | SIM_DS2482_STATUS_SD);
+			if (I2C_Sim_Probe_Reset(pProbe)) pChip->ui8Status |= SIM_DS2482_STATUS_PPD;
+
+			pChip->ui64Busy_Until_ns = g_ui64Sim_Now_ns + I2C_SIM_ONE_WIRE_RESET_NS;
+			pBus->sCounters.ui64One_Wire_ns += I2C_SIM_ONE_WIRE_RESET_NS;
+			pChip->ui8Pointer = SIM_DS2482_STATUS_REGISTER;
+			return I2C_SIM_ERR_NONE;
+
+		case SIM_DS2482_ONE_WIRE_WRITE_BYTE:
+			if ((uiWrite_Count < 2) || uiBusy) return I2C_SIM_ERR_DATA_NACK;
+
+			I2C_Sim_Probe_Write_Byte(pProbe, ui8Parameter);
+
+			pChip->ui64Busy_Until_ns = g_ui64Sim_Now_ns + I2C_SIM_ONE_WIRE_BYTE_NS;
+			pBus->sCounters.ui64One_Wire_ns += I2C_SIM_ONE_WIRE_BYTE_NS;
+			pChip->ui8Pointer = SIM_DS2482_STATUS_REGISTER;
+			return I2C_SIM_ERR_NONE;
+
+		case SIM_DS2482_ONE_WIRE_READ_BYTE:
+			if (uiBusy) return I2C_SIM_ERR_DATA_NACK;
+
+			pChip->ui8Data = I2C_Sim_Probe_Read_Byte(pProbe);
+
+			pChip->ui64Busy_Until_ns = g_ui64Sim_Now_ns + I2C_SIM_ONE_WIRE_BYTE_NS;
+			pBus->sCounters.ui64One_Wire_ns += I2C_SIM_ONE_WIRE_BYTE_NS;
+			pChip->ui8Pointer = SIM_DS2482_STATUS_REGISTER;
+			return I2C_SIM_ERR_NONE;
+
+		default:
+			// single bit and triplet aren't used by the firmware
+			return I2C_SIM_ERR_DATA_NACK;
+	}
+}
+
+
+static uint8_t I2C_Sim_DS2482_Read(I2C_Sim_Bus* pBus, I2C_Sim_DS2482* pChip)
+{
+	switch (pChip->ui8Pointer)
+	{
+		case SIM_DS2482_DATA_REGISTER:
+			return pChip->ui8Data;
+
+		case SIM_DS2482_CONFIGURATION_REGISTER:
+			return pChip->ui8Configuration;
+
+		case SIM_DS2482_CHANNEL_REGISTER:
+			return a_ui8Sim_Channel_Verify[pChip->uiChannel];
+
+		default:
+			if (g_ui64Sim_Now_ns < pChip->ui64Busy_Until_ns)
+			{
+				pBus->sCounters.ui32Busy_Polls++;
+				return pChip->ui8Status | SIM_DS2482_STATUS_1WB;
+			}
+
+			return pChip->ui8Status;
+	}
+}
+
+
+static void I2C_Sim_LTC2309_Stop(void)
+{
+	// D_IN single ended channel select: S/D O/S S1 S0 -> channel (S1 S0 O/S)
+	uint8_t ui8Config = g_sSim_LTC2309.ui8Config;
+	uint32_t uiChannel = (((ui8Config >> 4) & 0x03) << 1) | ((ui8Config >> 6) & 0x01);
+
+	g_sSim_LTC2309.ui16Result = g_sSim_LTC2309.a_ui16Code[uiChannel] & 0x0FFF;
+}
+
+
+static uint64_t I2C_Sim_Transfer_ns(I2C_Sim_Bus* pBus, uint32_t uiWrite_Count, uint32_t uiRead_Count)
+{
+	// start, address + data at 9 bits a byte, repeated start, stop
+	uint64_t ui64Bits = 1;
+
+	if (uiWrite_Count) ui64Bits += 9 * (1 + uiWrite_Count);
+	if (uiRead_Count) ui64Bits += 9 * (1 + uiRead_Count) + (uiWrite_Count ? 1 : 0);
+	ui64Bits += 1;
+
+	pBus->sCounters.ui32Bytes += (uiWrite_Count ? 1 + uiWrite_Count : 0) + (uiRead_Count ? 1 + uiRead_Count : 0);
+
+	return (ui64Bits * 1000000) / pBus->sCounters.ui32Bit_Rate_kHz;
+}
+
+
+static uint32_t I2C_Sim_Replay_Transfer(uint32_t uiBus, uint8_t ui8Address, const uint8_t* pWrite, uint32_t uiWrite_Count,
+										uint8_t* pRead, uint32_t uiRead_Count, uint32_t uiError)
+{
+	// the recorded answer for this transfer if it is the next one in the trace, otherwise the simulated one
+	I2C_Sim_Replay* pReplay = &g_sSim_Replay;
+
+	if ((pReplay->pRecords == NULL) || pReplay->sCounters.ui32Diverged || (pReplay->uiNext >= pReplay->sCounters.ui32Records))
+	{
+		return uiError;
+	}
+
+	I2C_Trace_Record* pRecord = &pReplay->pRecords[pReplay->uiNext];
+
+	uint32_t uiWrite_Kept = (uiWrite_Count < I2C_TRACE_DATA_BYTES) ? uiWrite_Count : I2C_TRACE_DATA_BYTES;
+	uint32_t uiCounts = ((uiWrite_Count > 15 ? 15 : uiWrite_Count) << 4) | (uiRead_Count > 15 ? 15 : uiRead_Count);
+
+	if ((pRecord->ui8Bus != uiBus) || (pRecord->ui8Address != ui8Address) || (pRecord->ui8Counts != uiCounts) ||
+		(uiWrite_Kept && (memcmp(pRecord->a_ui8Data, pWrite, uiWrite_Kept) != 0)))
+	{
+		pReplay->sCounters.ui32Diverged = true;
+		pReplay->sCounters.ui32Diverged_At = pReplay->uiNext;
+		return uiError;
+	}
+
+
+	// the read bytes the capture kept, the rest stay as the parts left them
+	if (pRecord->ui8Result == I2C_SIM_ERR_NONE)
+	{
+		uint32_t uiRead_Kept = I2C_TRACE_DATA_BYTES - uiWrite_Kept;
+		if (uiRead_Kept > uiRead_Count) uiRead_Kept = uiRead_Count;
+
+		if (uiRead_Kept) memcpy(pRead, &pRecord->a_ui8Data[uiWrite_Kept], uiRead_Kept);
+	}
+
+	if (pReplay->uiNext == 0) pReplay->ui64First_ns = g_ui64Sim_Now_ns;
+
+	pReplay->sCounters.ui32Replayed++;
+	pReplay->sCounters.ui64Recorded_ns = ((uint64_t) (pRecord->ui32Timestamp - pReplay->pRecords[0].ui32Timestamp) * 1000) / pReplay->uiCycles_Per_us;
+	pReplay->sCounters.ui64Replayed_ns = g_ui64Sim_Now_ns - pReplay->ui64First_ns;
+	pReplay->uiNext++;
+
+	if (pRecord->ui8Result == I2C_TRACE_RESULT_OTHER) return I2C_SIM_ERR_ADDR_NACK;
+
+	return pRecord->ui8Result;
+}
+
+
+bool I2C_Sim_Transfer(uint32_t uiBus, uint8_t ui8Address, const void* pWrite, uint32_t uiWrite_Count, void* pRead, uint32_t uiRead_Count)
+{
+	uint8_t* pRead_Bytes = (uint8_t *) pRead;
+	uint32_t uiError = I2C_SIM_ERR_NONE;
+	uint64_t ui64Wire_ns;
+	uint32_t i;
+
+	if ((uiBus >= I2C_SIM_MAX_BUSES) || (a_sSim_Bus[uiBus].uiOpen == false)) return false;
+
+	I2C_Sim_Bus* pBus = &a_sSim_Bus[uiBus];
+
+	pBus->sCounters.ui32Transfers++;
+
+
+	uint32_t uiDS2482 = (uiBus < I2C_SIM_ADC_BUS) && (ui8Address == I2C_SIM_DS2482_ADDRESS);
+	uint32_t uiLTC2309 = (uiBus == I2C_SIM_ADC_BUS) && (ui8Address == I2C_SIM_LTC2309_ADDRESS);
+
+	if ((uiDS2482 == false) && (uiLTC2309 == false))
+	{
+		// nobody home, only the address goes out
+		ui64Wire_ns = I2C_Sim_Transfer_ns(pBus, 0, 0) + ((9 * 1000000ULL) / pBus->sCounters.ui32Bit_Rate_kHz);
+		uiError = I2C_SIM_ERR_ADDR_NACK;
+	}
+	else
+	{
+		ui64Wire_ns = I2C_Sim_Transfer_ns(pBus, uiWrite_Count, uiRead_Count);
+	}
+
+	// the bytes are acted on once they're on the wire, the 1-Wire busy time starts after the stop
+	g_ui64Sim_Now_ns += ui64Wire_ns + g_ui32Sim_Transfer_Overhead_ns;
+	pBus->sCounters.ui64Wire_ns += ui64Wire_ns;
+
+
+	if (uiDS2482)
+	{
+		I2C_Sim_DS2482* pChip = &a_sSim_DS2482[uiBus];
+
+		uiError = I2C_Sim_DS2482_Write(pBus, pChip, (const uint8_t *) pWrite, uiWrite_Count);
+
+		for (i = 0; (uiError == I2C_SIM_ERR_NONE) && (i < uiRead_Count); i++)
+		{
+			pRead_Bytes[i] = I2C_Sim_DS2482_Read(pBus, pChip);
+		}
+	}
+	else if (uiLTC2309)
+	{
+		// the read is the conversion from the last stop, the new config takes effect at this stop
+		uint16_t ui16Result = g_sSim_LTC2309.ui16Result;
+
+		if (uiRead_Count > 0) pRead_Bytes[0] = (uint8_t) (ui16Result >> 4);
+		if (uiRead_Count > 1) pRead_Bytes[1] = (uint8_t) ((ui16Result & 0x0F) << 4);
+		for (i = 2; i < uiRead_Count; i++) pRead_Bytes[i] = 0;
+
+		if (uiWrite_Count > 0) g_sSim_LTC2309.ui8Config = ((const uint8_t *) pWrite)[0];
+		I2C_Sim_LTC2309_Stop();
+	}
+
+	uiError = I2C_Sim_Replay_Transfer(uiBus, ui8Address, (const uint8_t *) pWrite, uiWrite_Count, pRead_Bytes, uiRead_Count, uiError);
+
+
+	pBus->uiError = uiError;
+	if (uiError != I2C_SIM_ERR_NONE)
+	{
+		pBus->sCounters.ui32NACKs++;
+		return false;
+	}
+
+	return true;
+}
+
+
+uint32_t I2C_Sim_Get_Error(uint32_t uiBus)
+{
+	if (uiBus >= I2C_SIM_MAX_BUSES) return I2C_SIM_ERR_ADDR_NACK;
+
+	return a_sSim_Bus[uiBus].uiError;
+}
+
+
+void* I2C_Sim_Open(uint32_t uiBus, uint32_t uiBit_Rate_kHz)
+{
+	if (uiBus >= I2C_SIM_MAX_BUSES) return NULL;
+
+	a_sSim_Bus[uiBus].uiOpen = true;
+	a_sSim_Bus[uiBus].uiError = I2C_SIM_ERR_NONE;
+	a_sSim_Bus[uiBus].sCounters.ui32Bit_Rate_kHz = uiBit_Rate_kHz ? uiBit_Rate_kHz : 100;
+
+	// any non NULL handle will do, it is only ever handed back
+	return &a_sSim_Bus[uiBus];
+}
+
+
+void I2C_Sim_Close(uint32_t uiBus)
+{
+	if (uiBus >= I2C_SIM_MAX_BUSES) return;
+
+	a_sSim_Bus[uiBus].uiOpen = false;
+}
+
+
+void I2C_Sim_Delay(uint32_t ui32Count)
+{
+	// SysCtlDelay() is 3 cycles a count
+	g_ui64Sim_Now_ns += ((uint64_t) ui32Count * 3 * 1000000000ULL) / I2C_SIM_CPU_HZ;
+}
+
+
+uint32_t I2C_Sim_Get_Ticks(void)
+{
+	// 1ms Clock ticks, the same as the board
+	return (uint32_t) (g_ui64Sim_Now_ns / 1000000);
+}
+
+
+uint32_t I2C_Sim_Get_Cycles(void)
+{
+	// a Timestamp_get32() stand in, wraps the same way
+	return (uint32_t) ((g_ui64Sim_Now_ns * (I2C_SIM_CPU_HZ / 1000000)) / 1000);
+}
+
+
+void I2C_Sim_Reset(void)
+{
+	uint32_t i, j;
+
+	memset(a_sSim_Bus, 0, sizeof(a_sSim_Bus));
+	memset(a_sSim_DS2482, 0, sizeof(a_sSim_DS2482));
+	memset(&g_sSim_LTC2309, 0, sizeof(g_sSim_LTC2309));
+
+	free(g_sSim_Replay.pRecords);
+	memset(&g_sSim_Replay, 0, sizeof(g_sSim_Replay));
+
+	g_ui64Sim_Now_ns = 0;
+	g_ui32Sim_Transfer_Overhead_ns = 0;
+
+	// every probe present, 20C and up by 1.5C a probe... the dish inputs at mid scale
+	for (i = 0; i < I2C_SIM_ADC_BUS; i++)
+	{
+		a_sSim_DS2482[i].ui8Pointer = SIM_DS2482_STATUS_REGISTER;
+		a_sSim_DS2482[i].ui8Status = SIM_DS2482_STATUS_RST;
+
+		for (j = 0; j < I2C_SIM_CHANNELS; j++)
+		{
+			I2C_Sim_DS18B20* pProbe = &a_sSim_DS2482[i].a_sProbe[j];
+
+			I2C_Sim_Probe_Power_Up(pProbe, i, j);
+			pProbe->uiPresent = true;
+			pProbe->i16Temperature_16ths = (int16_t) ((20 * 16) + ((((i * I2C_SIM_CHANNELS) + j) * 3 * 16) / 2));
+		}
+	}
+
+	for (j = 0; j < I2C_SIM_CHANNELS; j++)
+	{
+		g_sSim_LTC2309.a_ui16Code[j] = 0x0800;
+	}
+}
+
+
+void I2C_Sim_Advance_ns(uint64_t ui64Nanoseconds)
+{
+	g_ui64Sim_Now_ns += ui64Nanoseconds;
+}
+
+
+uint64_t I2C_Sim_Get_Time_ns(void)
+{
+	return g_ui64Sim_Now_ns;
+}
+
+
+void I2C_Sim_Set_Transfer_Overhead_ns(uint32_t ui32Nanoseconds)
+{
+	// the driver's own time for each transfer (interrupts, semaphore), take it from Perf_Instrument on the board
+	g_ui32Sim_Transfer_Overhead_ns = ui32Nanoseconds;
+}
+
+
+void I2C_Sim_Set_Probe(uint32_t uiBus, uint32_t uiChannel, uint32_t uiPresent, int16_t i16Temperature_16ths)
+{
+	if ((uiBus >= I2C_SIM_ADC_BUS) || (uiChannel >= I2C_SIM_CHANNELS)) return;
+
+	a_sSim_DS2482[uiBus].a_sProbe[uiChannel].uiPresent = uiPresent;
+	a_sSim_DS2482[uiBus].a_sProbe[uiChannel].i16Temperature_16ths = i16Temperature_16ths;
+}
+
+
+void I2C_Sim_Set_ADC(uint32_t uiChannel, uint16_t ui16Code)
+{
+	if (uiChannel >= I2C_SIM_CHANNELS) return;
+
+	g_sSim_LTC2309.a_ui16Code[uiChannel] = ui16Code & 0x0FFF;
+}
+
+
+void I2C_Sim_Get_Counters(uint32_t uiBus, I2C_Sim_Counters* pCounters)
+{
+	if (uiBus >= I2C_SIM_MAX_BUSES)
+	{
+		memset(pCounters, 0, sizeof(I2C_Sim_Counters));
+		return;
+	}
+
+	*pCounters = a_sSim_Bus[uiBus].sCounters;
+}
+
+
+void I2C_Sim_Reset_Counters(void)
+{
+	// keeps the bit rates
+	uint32_t i;
+
+	for (i = 0; i < I2C_SIM_MAX_BUSES; i++)
+	{
+		uint32_t uiBit_Rate_kHz = a_sSim_Bus[i].sCounters.ui32Bit_Rate_kHz;
+
+		memset(&a_sSim_Bus[i].sCounters, 0, sizeof(I2C_Sim_Counters));
+		a_sSim_Bus[i].sCounters.ui32Bit_Rate_kHz = uiBit_Rate_kHz;
+	}
+}
+
+
+void I2C_Sim_Report(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < I2C_SIM_MAX_BUSES; i++)
+	{
+		I2C_Sim_Counters* pCounters = &a_sSim_Bus[i].sCounters;
+
+		printf("Bus %u (%u kHz): Wire %llu us  1-Wire %llu us  Transfers %u  Bytes %u  NACKs %u  Busy Polls %u\n",
+				i, pCounters->ui32Bit_Rate_kHz,
+				(unsigned long long) (pCounters->ui64Wire_ns / 1000), (unsigned long long) (pCounters->ui64One_Wire_ns / 1000),
+				pCounters->ui32Transfers, pCounters->ui32Bytes, pCounters->ui32NACKs, pCounters->ui32Busy_Polls);
+	}
+}
+
+
+uint32_t I2C_Sim_Load_Trace(const char* szFile)
+{
+	// the console capture as saved, anything that isn't a record line is skipped... 0 if nothing loaded
+	char szLine[256];
+	I2C_Trace_Record sRecord;
+	uint32_t uiCapacity = 0;
+
+	FILE* pFile = fopen(szFile, "r");
+	if (pFile == NULL) return 0;
+
+	free(g_sSim_Replay.pRecords);
+	memset(&g_sSim_Replay, 0, sizeof(g_sSim_Replay));
+	g_sSim_Replay.uiCycles_Per_us = I2C_SIM_CPU_HZ / 1000000;
+
+	while (fgets(szLine, sizeof(szLine), pFile) != NULL)
+	{
+		char* pRecord_Line = strstr(szLine, I2C_TRACE_LINE_PREFIX);
+		char* pRate = strstr(szLine, "I2CT Cycles Per us:");
+
+		if (pRate != NULL)
+		{
+			uint32_t uiCycles_Per_us = (uint32_t) strtoul(pRate + strlen("I2CT Cycles Per us:"), NULL, 10);
+			if (uiCycles_Per_us) g_sSim_Replay.uiCycles_Per_us = uiCycles_Per_us;
+			continue;
+		}
+
+		if ((pRecord_Line == NULL) || (I2C_Trace_Parse_Line(pRecord_Line, &sRecord) == false)) continue;
+
+		if (g_sSim_Replay.sCounters.ui32Records == uiCapacity)
+		{
+			uiCapacity = uiCapacity ? (uiCapacity * 2) : I2C_TRACE_MAX_RECORDS;
+
+			I2C_Trace_Record* pGrown = (I2C_Trace_Record *) realloc(g_sSim_Replay.pRecords, uiCapacity * sizeof(I2C_Trace_Record));
+			if (pGrown == NULL) break;
+
+			g_sSim_Replay.pRecords = pGrown;
+		}
+
+		g_sSim_Replay.pRecords[g_sSim_Replay.sCounters.ui32Records++] = sRecord;
+	}
+
+	fclose(pFile);
+
+	return g_sSim_Replay.sCounters.ui32Records;
+}
+
+
+void I2C_Sim_Get_Replay_Counters(I2C_Sim_Replay_Counters* pCounters)
+{
+	*pCounters = g_sSim_Replay.sCounters;
+}
+
+
+void I2C_Sim_Replay_Report(void)
+{
+	I2C_Sim_Replay_Counters* pCounters = &g_sSim_Replay.sCounters;
+
+	printf("Replay: %u of %u records  Recorded %llu us  Simulated %llu us",
+			pCounters->ui32Replayed, pCounters->ui32Records,
+			(unsigned long long) (pCounters->ui64Recorded_ns / 1000), (unsigned long long) (pCounters->ui64Replayed_ns / 1000));
+
+	if (pCounters->ui32Diverged)
+	{
+		printf("  Diverged at record %u", pCounters->ui32Diverged_At);
+	}
+
+	printf("\n");
+}
+
+#endif
@@ -0,0 +1,85 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// I2C Sim - PC simulation of the acquisition buses, behind I2C_HAL.h when I2C_HAL_SIMULATOR is defined.
+//
+//     Bus 0  DS2482-800 at 0x18, a DS18B20 on each of the 8 channels (probes 0-7)
+//     Bus 1  DS2482-800 at 0x18, a DS18B20 on each of the 8 channels (probes 8-15)
+//     Bus 2  LTC2309 at 0x08
+//
+// Time is simulated.  Transfers, 1-Wire slots, DS18B20 conversions and the busy wait delays all move it
+// forward, nothing here depends on how fast the PC is.
+//
+// I2C_Sim_Load_Trace() replays a capture from the board (I2C_Trace.h) instead: each transfer that matches
+// the next record gets the recorded read bytes and result, the parts above only fill in the time.
+//
+//*****************************************************************************
+
+#ifndef I2C_SIM_H_
+#define I2C_SIM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+#define I2C_SIM_MAX_BUSES					3
+#define I2C_SIM_CHANNELS					8
+
+#define I2C_SIM_CPU_HZ						120000000  // what I2C_Sim_Get_Cycles() and I2C_Sim_Delay() count in
+
+// Errors from I2C_Sim_Get_Error() - the same bits as the TivaWare I2C_MASTER_ERR_ codes
+#define I2C_SIM_ERR_NONE					0x00
+#define I2C_SIM_ERR_ADDR_NACK				0x04
+#define I2C_SIM_ERR_DATA_NACK				0x08
+
+
+typedef struct
+{
+	uint64_t ui64Wire_ns;               // SCL running... start, address, data, stop
+	uint64_t ui64One_Wire_ns;           // 1-Wire resets and slots on the DS2482 channels
+	uint32_t ui32Transfers;
+	uint32_t ui32Bytes;                 // address bytes included
+	uint32_t ui32NACKs;
+	uint32_t ui32Busy_Polls;            // status reads that came back with 1WB set
+	uint32_t ui32Bit_Rate_kHz;
+} I2C_Sim_Counters;
+
+
+typedef struct
+{
+	uint32_t ui32Records;               // loaded from the trace
+	uint32_t ui32Replayed;              // transfers answered from the trace
+	uint32_t ui32Diverged;              // the driver asked for something other than the next record
+	uint32_t ui32Diverged_At;           // that record
+	uint64_t ui64Recorded_ns;           // first to last replayed record, by the board's Timestamp
+	uint64_t ui64Replayed_ns;           // the same transfers, simulated time
+} I2C_Sim_Replay_Counters;
+
+
+// HAL side
+bool I2C_Sim_Transfer(uint32_t uiBus, uint8_t ui8Address, const void* pWrite, uint32_t uiWrite_Count, void* pRead, uint32_t uiRead_Count);
+uint32_t I2C_Sim_Get_Error(uint32_t uiBus);
+void* I2C_Sim_Open(uint32_t uiBus, uint32_t uiBit_Rate_kHz);
+void I2C_Sim_Close(uint32_t uiBus);
+void I2C_Sim_Delay(uint32_t ui32Count);
+uint32_t I2C_Sim_Get_Ticks(void);
+uint32_t I2C_Sim_Get_Cycles(void);
+
+// bench side
+void I2C_Sim_Reset(void);
+void I2C_Sim_Advance_ns(uint64_t ui64Nanoseconds);
+uint64_t I2C_Sim_Get_Time_ns(void);
+void I2C_Sim_Set_Transfer_Overhead_ns(uint32_t ui32Nanoseconds);
+void I2C_Sim_Set_Probe(uint32_t uiBus, uint32_t uiChannel, uint32_t uiPresent, int16_t i16Temperature_16ths);
+void I2C_Sim_Set_ADC(uint32_t uiChannel, uint16_t ui16Code);
+void I2C_Sim_Get_Counters(uint32_t uiBus, I2C_Sim_Counters* pCounters);
+void I2C_Sim_Reset_Counters(void);
+void I2C_Sim_Report(void);
+
+// replay of an I2C_Trace_Dump() from the board
+uint32_t I2C_Sim_Load_Trace(const char* szFile);
+void I2C_Sim_Get_Replay_Counters(I2C_Sim_Replay_Counters* pCounters);
+void I2C_Sim_Replay_Report(void);
+
+#endif /* I2C_SIM_H_ */
@@ -0,0 +1,216 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// A timing problem on the acquisition buses could only be looked at on the board... the bus simulator
+// (I2C_Sim.c) only knows what the parts are supposed to do, not what one particular installation did.
+//
+// With I2C_TRACE defined, I2C_Scheduler_Transfer() files every transaction (the temperature and the ADC
+// paths both go through it) as a 12 byte I2C_Trace_Record: the Timestamp at the start, the bus, the
+// address, the write / read counts, the result and up to 4 data bytes (write bytes, then read bytes).
+// Every transaction in this controller fits in 4... a channel select is 2 + 1, an ADC read is 1 + 2.
+//
+// I2C_Trace_Start() clears the buffer and captures until it is full (I2C_TRACE_MAX_RECORDS), so a capture
+// started at the top of an acquisition cycle holds that cycle and the ones after it from the beginning.
+// I2C_Trace_Dump() prints the records on the console as "I2CT " + 24 hex digits, one per line.  Saved
+// from the console, that file is what I2C_Sim_Load_Trace() replays on the PC.
+//
+// I2C_Trace_Format_Record() / I2C_Trace_Parse_Line() are always compiled, they have no TI dependencies.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef I2C_TRACE
+#include <xdc/std.h>
+#include <ti/sysbios/hal/Hwi.h>
+
+#include "Telemetry.h"
+#include "Static_Footprint.h"
+#endif
+
+#include "I2C_Trace.h"
+
+
+
+static const char a_cTrace_Hex[16] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
+
+
+
+static uint32_t I2C_Trace_Hex_Value(char cDigit)
+{
+	if ((cDigit >= '0') && (cDigit <= '9')) return cDigit - '0';
+	if ((cDigit >= 'A') && (cDigit <= 'F')) return cDigit - 'A' + 10;
+	if ((cDigit >= 'a') && (cDigit <= 'f')) return cDigit - 'a' + 10;
+
+	return 0xFF;
+}
+
+
+void I2C_Trace_Format_Record(const I2C_Trace_Record* pRecord, char* szLine)
+{
+	// the bytes in wire order... timestamp least significant byte first, then the rest as they are
+	uint8_t a_ui8Bytes[sizeof(I2C_Trace_Record)];
+	uint32_t i;
+
+	a_ui8Bytes[0] = (uint8_t) pRecord->ui32Timestamp;
+	a_ui8Bytes[1] = (uint8_t) (pRecord->ui32Timestamp >> 8);
+	a_ui8Bytes[2] = (uint8_t) (pRecord->ui32Timestamp >> 16);
+	a_ui8Bytes[3] = (uint8_t) (pRecord->ui32Timestamp >> 24);
+	a_ui8Bytes[4] = pRecord->ui8Bus;
+	a_ui8Bytes[5] = pRecord->ui8Address;
+	a_ui8Bytes[6] = pRecord->ui8Counts;
+	a_ui8Bytes[7] = pRecord->ui8Result;
+	memcpy(&a_ui8Bytes[8], pRecord->a_ui8Data, I2C_TRACE_DATA_BYTES);
+
+	strcpy(szLine, I2C_TRACE_LINE_PREFIX);
+	szLine += strlen(I2C_TRACE_LINE_PREFIX);
+
+	for (i = 0; i < sizeof(a_ui8Bytes); i++)
+	{
+		*szLine++ = a_cTrace_Hex[a_ui8Bytes[i] >> 4];
+		*szLine++ = a_cTrace_Hex[a_ui8Bytes[i] & 0x0F];
+	}
+
+	*szLine++ = '\n';
+	*szLine = 0;
+}
+
+
+uint32_t I2C_Trace_Parse_Line(const char* szLine, I2C_Trace_Record* pRecord)
+{
+	// true for a record line, anything else on the console is skipped
+	uint8_t a_ui8Bytes[sizeof(I2C_Trace_Record)];
+	uint32_t i;
+
+	if (strncmp(szLine, I2C_TRACE_LINE_PREFIX, strlen(I2C_TRACE_LINE_PREFIX)) != 0) return false;
+	szLine += strlen(I2C_TRACE_LINE_PREFIX);
+
+	for (i = 0; i < sizeof(a_ui8Bytes); i++)
+	{
+		uint32_t uiHigh = I2C_Trace_Hex_Value(szLine[0]);
+		uint32_t uiLow = (uiHigh == 0xFF) ? 0xFF : I2C_Trace_Hex_Value(szLine[1]);
+
+		if ((uiHigh == 0xFF) || (uiLow == 0xFF)) return false;
+
+		a_ui8Bytes[i] = (uint8_t) ((uiHigh << 4) | uiLow);
+		szLine += 2;
+	}
+
+	if ((*szLine != 0) && (*szLine != '\n') && (*szLine != '\r')) return false;
+
+	pRecord->ui32Timestamp = (uint32_t) a_ui8Bytes[0] | ((uint32_t) a_ui8Bytes[1] << 8) |
+							 ((uint32_t) a_ui8Bytes[2] << 16) | ((uint32_t) a_ui8Bytes[3] << 24);
+	pRecord->ui8Bus = a_ui8Bytes[4];
+	pRecord->ui8Address = a_ui8Bytes[5];
+	pRecord->ui8Counts = a_ui8Bytes[6];
+	pRecord->ui8Result = a_ui8Bytes[7];
+	memcpy(pRecord->a_ui8Data, &a_ui8Bytes[8], I2C_TRACE_DATA_BYTES);
+
+	return true;
+}
+
+
+
+#ifdef I2C_TRACE
+
+I2C_Trace_Record a_sI2C_Trace[I2C_TRACE_MAX_RECORDS];
+
+uint32_t g_uiI2C_Trace_Count;
+uint32_t g_uiI2C_Trace_Capturing;
+uint32_t g_uiI2C_Trace_Missed;          // transactions after the buffer filled
+
+STATIC_FOOTPRINT_CHECK(sizeof(a_sI2C_Trace) <= STATIC_BUDGET_I2C_TRACE, I2C_Trace);
+
+// from I2C_Scheduler.c
+extern uint32_t g_uiI2C_Cycles_Per_us;
+
+
+
+void I2C_Trace_Capture(uint32_t uiBus, uint8_t ui8Address, const void* pWrite, uint32_t uiWrite_Count,
+					   const void* pRead, uint32_t uiRead_Count, uint32_t ui32Timestamp, uint32_t ui32Result)
+{
+	if (g_uiI2C_Trace_Capturing == false) return;
+
+	// the temperature and ADC tasks both transfer, only the slot is claimed with interrupts off
+	UInt uiKey = Hwi_disable();
+
+	if (g_uiI2C_Trace_Count >= I2C_TRACE_MAX_RECORDS)
+	{
+		g_uiI2C_Trace_Capturing = false;
+		g_uiI2C_Trace_Missed++;
+		Hwi_restore(uiKey);
+		return;
+	}
+
+	I2C_Trace_Record* pRecord = &a_sI2C_Trace[g_uiI2C_Trace_Count++];
+
+	Hwi_restore(uiKey);
+
+
+	pRecord->ui32Timestamp = ui32Timestamp;
+	pRecord->ui8Bus = (uint8_t) uiBus;
+	pRecord->ui8Address = ui8Address;
+	pRecord->ui8Counts = (uint8_t) (((uiWrite_Count > 15 ? 15 : uiWrite_Count) << 4) | (uiRead_Count > 15 ? 15 : uiRead_Count));
+	pRecord->ui8Result = (ui32Result > 0xFF) ? I2C_TRACE_RESULT_OTHER : (uint8_t) ui32Result;
+
+	// write bytes first, the read bytes in what's left... a failed read has nothing worth keeping
+	uint32_t uiWrite_Kept = (uiWrite_Count < I2C_TRACE_DATA_BYTES) ? uiWrite_Count : I2C_TRACE_DATA_BYTES;
+	uint32_t uiRead_Kept = (ui32Result == 0) ? uiRead_Count : 0;
+	if (uiRead_Kept > I2C_TRACE_DATA_BYTES - uiWrite_Kept) uiRead_Kept = I2C_TRACE_DATA_BYTES - uiWrite_Kept;
+
+	memset(pRecord->a_ui8Data, 0, I2C_TRACE_DATA_BYTES);
+	if (uiWrite_Kept) memcpy(pRecord->a_ui8Data, pWrite, uiWrite_Kept);
+	if (uiRead_Kept) memcpy(&pRecord->a_ui8Data[uiWrite_Kept], pRead, uiRead_Kept);
+}
+
+
+void I2C_Trace_Start(void)
+{
+	UInt uiKey = Hwi_disable();
+
+	g_uiI2C_Trace_Count = 0;
+	g_uiI2C_Trace_Missed = 0;
+	g_uiI2C_Trace_Capturing = true;
+
+	Hwi_restore(uiKey);
+}
+
+
+void I2C_Trace_Stop(void)
+{
+	g_uiI2C_Trace_Capturing = false;
+}
+
+
+uint32_t I2C_Trace_Get_Count(void)
+{
+	return g_uiI2C_Trace_Count;
+}
+
+
+void I2C_Trace_Dump(void)
+{
+	// stops the capture first, the records can't change under the dump
+	char szLine[I2C_TRACE_LINE_SIZE];
+	uint32_t i;
+
+	I2C_Trace_Stop();
+
+	Telemetry_Send_Output("I2CT Begin\n");
+	Telemetry_Send_Output_Value("I2CT Cycles Per us: ", g_uiI2C_Cycles_Per_us);
+	Telemetry_Send_Output_Value("I2CT Records: ", g_uiI2C_Trace_Count);
+	Telemetry_Send_Output_Value("I2CT Missed: ", g_uiI2C_Trace_Missed);
+
+	for (i = 0; i < g_uiI2C_Trace_Count; i++)
+	{
+		I2C_Trace_Format_Record(&a_sI2C_Trace[i], szLine);
+		Telemetry_Send_Output(szLine);
+	}
+
+	Telemetry_Send_Output("I2CT End\n");
+}
+
+#endif
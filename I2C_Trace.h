@@ -0,0 +1,69 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// I2C Trace - a capture of every transaction through the I2C Scheduler, for replay on the PC.
+//
+// Build with I2C_TRACE defined to turn capture on.  Without it I2C_TRACE_RECORD() is empty and only the
+// record format / parse helpers are compiled (the PC replay uses those).
+//
+//     I2C_Trace_Start();       // from the console, capture until the buffer is full
+//     I2C_Trace_Dump();        // to the console, one "I2CT " line per record
+//
+//*****************************************************************************
+
+#ifndef I2C_TRACE_H_
+#define I2C_TRACE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+#define I2C_TRACE_MAX_RECORDS				2048   // a whole cycle at 16 probes is ~1850
+#define I2C_TRACE_DATA_BYTES				4      // write bytes then read bytes, anything past this isn't kept
+#define I2C_TRACE_RESULT_OTHER				0xFF   // a scheduler error, not an I2C_MASTER_ERR_ code
+
+#define I2C_TRACE_LINE_PREFIX				"I2CT "
+#define I2C_TRACE_LINE_SIZE					32     // prefix, 24 hex digits, newline, terminator
+
+
+// 12 bytes, no padding
+typedef struct
+{
+	uint32_t ui32Timestamp;             // Timestamp counts at the start of the transfer
+	uint8_t ui8Bus;
+	uint8_t ui8Address;
+	uint8_t ui8Counts;                  // write count << 4 | read count, the real counts even if truncated
+	uint8_t ui8Result;                  // I2C_MASTER_ERR_NONE, the error bits, or I2C_TRACE_RESULT_OTHER
+	uint8_t a_ui8Data[I2C_TRACE_DATA_BYTES];
+} I2C_Trace_Record;
+
+
+#define I2C_TRACE_WRITE_COUNT(pRecord)		((pRecord)->ui8Counts >> 4)
+#define I2C_TRACE_READ_COUNT(pRecord)		((pRecord)->ui8Counts & 0x0F)
+
+
+void I2C_Trace_Format_Record(const I2C_Trace_Record* pRecord, char* szLine);
+uint32_t I2C_Trace_Parse_Line(const char* szLine, I2C_Trace_Record* pRecord);
+
+
+#ifdef I2C_TRACE
+
+void I2C_Trace_Capture(uint32_t uiBus, uint8_t ui8Address, const void* pWrite, uint32_t uiWrite_Count,
+					   const void* pRead, uint32_t uiRead_Count, uint32_t ui32Timestamp, uint32_t ui32Result);
+
+#define I2C_TRACE_RECORD(uiBus, pTransaction, ui32Timestamp, ui32Result)	I2C_Trace_Capture((uiBus), (pTransaction)->slaveAddress, (pTransaction)->writeBuf, (pTransaction)->writeCount, \
+																						  (pTransaction)->readBuf, (pTransaction)->readCount, (ui32Timestamp), (ui32Result))
+
+void I2C_Trace_Start(void);
+void I2C_Trace_Stop(void);
+uint32_t I2C_Trace_Get_Count(void);
+void I2C_Trace_Dump(void);
+
+#else
+
+#define I2C_TRACE_RECORD(uiBus, pTransaction, ui32Timestamp, ui32Result)
+
+#endif
+
+#endif /* I2C_TRACE_H_ */
@@ -0,0 +1,455 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Driver_Setup.c used to create a separate RTOS Clock for each timed thing... the temperature one shot,
+// the one second system timer and the LED blink.  Each one ran whenever its own Clock said so, there was
+// no way to keep two of them off the same tick, and nothing measured them.  Create_Timer_LED_Blink() also
+// stored its handle in g_Clock_One_Second_Timer_Handle, so the one second timer's handle was lost.
+//
+// Now there is one periodic Clock (every tick) and it drives a timer wheel.  Jobs are defined once with a
+// fixed id (JOB_ in Job_Scheduler.h), a name, a function and either:
+//     Periodic - a period and a phase.  Every periodic job starts on the same grid (tick % period == phase),
+//                so jobs can be placed on different ticks on purpose.
+//     One Shot - a delay, armed with Job_Scheduler_Start().  The temperature conversion hold is one.
+//
+// Timer wheel - JOB_WHEEL_SLOTS lists, a job sits in slot (due tick % JOB_WHEEL_SLOTS).  Each tick only
+//     looks at its own slot, a job whose due tick is a later lap stays where it is.
+//
+// Jobs run to completion in the Clock Swi, one after the other, the same as the Clock functions they
+// replace.  Keep them short... post a semaphore and let the task do the work.
+//
+// Measured per job:
+//     Late - the tick it ran on vs. the tick it was due (the Clock Swi was held off).
+//     Run time, and Overruns - ran longer than its budget, or longer than a whole tick with no budget.
+//     Jitter - periodic jobs, start to start time vs. the period.
+//
+// Most jobs only post a semaphore, the run time above is the Swi and says nothing about the work.  A task
+// that calls Job_Scheduler_Work_Done() when it has finished the work a job started turns on work tracking
+// for that job:
+//     Work time     - the job's start to Job_Scheduler_Work_Done().
+//     Work Overruns - the job came due again with the last run's work still not done.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <xdc/std.h>
+#include <xdc/runtime/Types.h>
+#include <xdc/runtime/Timestamp.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#include "Telemetry.h"
+#include "Job_Scheduler.h"
+#include "Static_Footprint.h"
+
+
+
+#define JOB_WHEEL_SLOTS						64     // power of 2
+#define JOB_WHEEL_MASK						(JOB_WHEEL_SLOTS - 1)
+#define JOB_NONE							0xFF
+
+
+typedef struct
+{
+	const char* szName;
+	Job_Function pfnJob;
+	uint32_t uiPeriod;                  // ticks, 0 for a one shot
+	uint32_t uiDelay;                   // ticks, one shot
+	uint32_t uiPhase;
+	uint32_t uiBudget_us;
+	uint32_t uiDue;                     // absolute Clock tick
+	uint32_t uiQueued;
+	uint8_t ui8Next;                    // next job in the same wheel slot
+	uint32_t uiHas_Run;                 // since the last Job_Scheduler_Start(), for the jitter
+	uint32_t ui32Last_Start;            // Timestamp
+	uint32_t uiWork_Tracked;            // its task calls Job_Scheduler_Work_Done()
+	uint32_t uiWork_Pending;
+	uint32_t ui32Work_Start;            // Timestamp
+	Job_Counters sCounters;
+} Job;
+
+
+Job a_sJob[JOB_MAX_JOBS];
+uint8_t a_ui8Job_Wheel[JOB_WHEEL_SLOTS];    // first job in each slot
+
+Clock_Struct g_sJob_Scheduler_Clock;              // constructed in place, nothing from the heap
+Clock_Handle g_hJob_Scheduler_Clock;
+uint32_t g_uiJob_Wheel_Tick;                // last tick processed
+uint32_t g_uiJob_Wheel_Catch_Up;            // ticks processed late
+uint32_t g_uiJob_Max_Tick_us;
+uint32_t g_uiJob_Cycles_Per_us = 1;
+
+const uint32_t g_uiJob_Scheduler_Static_Bytes = sizeof(a_sJob) + sizeof(a_ui8Job_Wheel) + sizeof(g_sJob_Scheduler_Clock);
+STATIC_FOOTPRINT_CHECK((sizeof(a_sJob) + sizeof(a_ui8Job_Wheel) + sizeof(g_sJob_Scheduler_Clock)) <= STATIC_BUDGET_JOB_SCHEDULER, Job_Scheduler);
+
+
+
+static void Job_Scheduler_Insert(uint32_t uiJob)
+{
+	// interrupts are off when this is called
+	uint32_t uiSlot = a_sJob[uiJob].uiDue & JOB_WHEEL_MASK;
+
+	a_sJob[uiJob].ui8Next = a_ui8Job_Wheel[uiSlot];
+	a_sJob[uiJob].uiQueued = true;
+	a_ui8Job_Wheel[uiSlot] = (uint8_t) uiJob;
+}
+
+
+static void Job_Scheduler_Remove(uint32_t uiJob)
+{
+	// interrupts are off when this is called
+	uint8_t* pLink = &a_ui8Job_Wheel[a_sJob[uiJob].uiDue & JOB_WHEEL_MASK];
+
+	while (*pLink != JOB_NONE)
+	{
+		if (*pLink == uiJob)
+		{
+			*pLink = a_sJob[uiJob].ui8Next;
+			break;
+		}
+
+		pLink = &a_sJob[*pLink].ui8Next;
+	}
+
+	a_sJob[uiJob].uiQueued = false;
+}
+
+
+static uint32_t Job_Scheduler_Take_Due(uint32_t ui32Tick)
+{
+	// unlink the first job in this tick's slot that is due on this lap
+	uint32_t uiJob = JOB_NONE;
+	UInt uiKey = Hwi_disable();
+
+	uint32_t uiCandidate = a_ui8Job_Wheel[ui32Tick & JOB_WHEEL_MASK];
+
+	while (uiCandidate != JOB_NONE)
+	{
+		if (a_sJob[uiCandidate].uiDue == ui32Tick)
+		{
+			Job_Scheduler_Remove(uiCandidate);
+			uiJob = uiCandidate;
+			break;
+		}
+
+		uiCandidate = a_sJob[uiCandidate].ui8Next;
+	}
+
+	Hwi_restore(uiKey);
+
+	return uiJob;
+}
+
+
+static void Job_Scheduler_Run(uint32_t uiJob, uint32_t ui32Tick, uint32_t ui32Now)
+{
+	Job* pJob = &a_sJob[uiJob];
+	Job_Counters* pCounters = &pJob->sCounters;
+
+	uint32_t ui32Late = ui32Now - ui32Tick;
+	if (ui32Late)
+	{
+		pCounters->ui32Late_Runs++;
+		if (ui32Late > pCounters->ui32Max_Late_Ticks) pCounters->ui32Max_Late_Ticks = ui32Late;
+	}
+
+	uint32_t ui32Start = Timestamp_get32();
+
+	// the work from the last run is still going... the task is behind
+	if (pJob->uiWork_Tracked)
+	{
+		if (pJob->uiWork_Pending) pCounters->ui32Work_Overruns++;
+
+		pJob->uiWork_Pending = true;
+		pJob->ui32Work_Start = ui32Start;
+	}
+
+	pJob->pfnJob();
+
+	uint32_t ui32Run_us = (Timestamp_get32() - ui32Start) / g_uiJob_Cycles_Per_us;
+
+	pCounters->ui32Runs++;
+	pCounters->ui32Last_Run_us = ui32Run_us;
+	if (ui32Run_us > pCounters->ui32Max_Run_us) pCounters->ui32Max_Run_us = ui32Run_us;
+
+	uint32_t uiBudget_us = pJob->uiBudget_us ? pJob->uiBudget_us : Clock_tickPeriod;
+	if (ui32Run_us > uiBudget_us) pCounters->ui32Overruns++;
+
+	if (pJob->uiPeriod)
+	{
+		if (pJob->uiHas_Run)
+		{
+			int32_t i32Jitter_us = (int32_t) ((ui32Start - pJob->ui32Last_Start) / g_uiJob_Cycles_Per_us) - (int32_t) (pJob->uiPeriod * Clock_tickPeriod);
+			if (i32Jitter_us < 0) i32Jitter_us = -i32Jitter_us;
+
+			if ((uint32_t) i32Jitter_us > pCounters->ui32Max_Jitter_us) pCounters->ui32Max_Jitter_us = i32Jitter_us;
+		}
+
+		pJob->uiHas_Run = true;
+		pJob->ui32Last_Start = ui32Start;
+
+		// next lap, unless the job stopped or restarted itself
+		UInt uiKey = Hwi_disable();
+
+		if (pJob->uiQueued == false)
+		{
+			pJob->uiDue = ui32Tick + pJob->uiPeriod;
+			Job_Scheduler_Insert(uiJob);
+		}
+
+		Hwi_restore(uiKey);
+	}
+}
+
+
+static void Job_Scheduler_Tick(UArg arg)
+{
+	// the Clock function, every tick
+	uint32_t ui32Tick_Start = Timestamp_get32();
+	uint32_t ui32Now = Clock_getTicks();
+	uint32_t uiJob;
+
+	// normally one tick... more if this Swi was held off
+	while ((int32_t) (ui32Now - g_uiJob_Wheel_Tick) > 0)
+	{
+		g_uiJob_Wheel_Tick++;
+		if (g_uiJob_Wheel_Tick != ui32Now) g_uiJob_Wheel_Catch_Up++;
+
+		while ((uiJob = Job_Scheduler_Take_Due(g_uiJob_Wheel_Tick)) != JOB_NONE)
+		{
+			Job_Scheduler_Run(uiJob, g_uiJob_Wheel_Tick, ui32Now);
+		}
+	}
+
+	uint32_t ui32Tick_us = (Timestamp_get32() - ui32Tick_Start) / g_uiJob_Cycles_Per_us;
+	if (ui32Tick_us > g_uiJob_Max_Tick_us) g_uiJob_Max_Tick_us = ui32Tick_us;
+}
+
+
+
+uint32_t Job_Scheduler_Initialize(void)
+{
+	// 17000's
+	uint32_t i;
+
+	memset(a_sJob, 0, sizeof(a_sJob));
+	memset(a_ui8Job_Wheel, JOB_NONE, sizeof(a_ui8Job_Wheel));
+
+	for (i = 0; i < JOB_MAX_JOBS; i++) a_sJob[i].ui8Next = JOB_NONE;
+
+	g_uiJob_Wheel_Catch_Up = 0;
+	g_uiJob_Max_Tick_us = 0;
+
+	Types_FreqHz sFrequency;
+	Timestamp_getFreq(&sFrequency);
+
+	g_uiJob_Cycles_Per_us = sFrequency.lo / 1000000;
+	if (g_uiJob_Cycles_Per_us == 0) g_uiJob_Cycles_Per_us = 1;
+
+	g_uiJob_Wheel_Tick = Clock_getTicks();
+
+	Clock_Params clockParams;
+
+	Clock_Params_init(&clockParams);
+	clockParams.period = 1;
+	clockParams.startFlag = TRUE;
+	Clock_construct(&g_sJob_Scheduler_Clock, (Clock_FuncPtr) Job_Scheduler_Tick, 1, &clockParams);
+	g_hJob_Scheduler_Clock = Clock_handle(&g_sJob_Scheduler_Clock);
+	if (!g_hJob_Scheduler_Clock)
+	{
+		Telemetry_Send_Output("Job_Scheduler_Initialize()  Error: Unable To Construct The Clock!...\n");
+		return JOB_SCHEDULER_ERR_CLOCK;
+	}
+
+	return 0;
+}
+
+
+uint32_t Job_Scheduler_Define_Periodic(uint32_t uiJob, const char* szName, Job_Function pfnJob, uint32_t uiPeriod_Ticks, uint32_t uiPhase_Ticks, uint32_t uiBudget_us)
+{
+	if ((uiJob >= JOB_MAX_JOBS) || (pfnJob == NULL) || (uiPeriod_Ticks == 0)) return JOB_SCHEDULER_ERR_INVALID_JOB;
+
+	Job_Scheduler_Stop(uiJob);
+
+	a_sJob[uiJob].szName = szName;
+	a_sJob[uiJob].pfnJob = pfnJob;
+	a_sJob[uiJob].uiPeriod = uiPeriod_Ticks;
+	a_sJob[uiJob].uiDelay = 0;
+	a_sJob[uiJob].uiPhase = uiPhase_Ticks % uiPeriod_Ticks;
+	a_sJob[uiJob].uiBudget_us = uiBudget_us;
+
+	return 0;
+}
+
+
+uint32_t Job_Scheduler_Define_One_Shot(uint32_t uiJob, const char* szName, Job_Function pfnJob, uint32_t uiDelay_Ticks, uint32_t uiBudget_us)
+{
+	if ((uiJob >= JOB_MAX_JOBS) || (pfnJob == NULL)) return JOB_SCHEDULER_ERR_INVALID_JOB;
+
+	Job_Scheduler_Stop(uiJob);
+
+	a_sJob[uiJob].szName = szName;
+	a_sJob[uiJob].pfnJob = pfnJob;
+	a_sJob[uiJob].uiPeriod = 0;
+	a_sJob[uiJob].uiDelay = uiDelay_Ticks ? uiDelay_Ticks : 1;
+	a_sJob[uiJob].uiPhase = 0;
+	a_sJob[uiJob].uiBudget_us = uiBudget_us;
+
+	return 0;
+}
+
+
+uint32_t Job_Scheduler_Set_Period(uint32_t uiJob, uint32_t uiTicks)
+{
+	// the period of a periodic job or the delay of a one shot... used from the next start / lap
+	if ((uiJob >= JOB_MAX_JOBS) || (uiTicks == 0)) return JOB_SCHEDULER_ERR_INVALID_JOB;
+	if (a_sJob[uiJob].pfnJob == NULL) return JOB_SCHEDULER_ERR_NOT_DEFINED;
+
+	if (a_sJob[uiJob].uiPeriod)
+	{
+		a_sJob[uiJob].uiPeriod = uiTicks;
+		a_sJob[uiJob].uiPhase %= uiTicks;
+	}
+	else
+	{
+		a_sJob[uiJob].uiDelay = uiTicks;
+	}
+
+	return 0;
+}
+
+
+uint32_t Job_Scheduler_Get_Period(uint32_t uiJob)
+{
+	if (uiJob >= JOB_MAX_JOBS) return 0;
+
+	return a_sJob[uiJob].uiPeriod ? a_sJob[uiJob].uiPeriod : a_sJob[uiJob].uiDelay;
+}
+
+
+uint32_t Job_Scheduler_Start(uint32_t uiJob)
+{
+	// (re)arm a job... a one shot that is already waiting starts its delay over
+	if (uiJob >= JOB_MAX_JOBS) return JOB_SCHEDULER_ERR_INVALID_JOB;
+
+	Job* pJob = &a_sJob[uiJob];
+
+	if (pJob->pfnJob == NULL) return JOB_SCHEDULER_ERR_NOT_DEFINED;
+
+	UInt uiKey = Hwi_disable();
+
+	if (pJob->uiQueued) Job_Scheduler_Remove(uiJob);
+
+	if (pJob->uiPeriod)
+	{
+		// the first tick after now that is on the job's phase
+		uint32_t ui32Next = g_uiJob_Wheel_Tick + 1;
+
+		pJob->uiDue = ui32Next - (ui32Next % pJob->uiPeriod) + pJob->uiPhase;
+		if ((int32_t) (pJob->uiDue - ui32Next) < 0) pJob->uiDue += pJob->uiPeriod;
+	}
+	else
+	{
+		pJob->uiDue = g_uiJob_Wheel_Tick + pJob->uiDelay;
+	}
+
+	pJob->uiHas_Run = false;
+	Job_Scheduler_Insert(uiJob);
+
+	Hwi_restore(uiKey);
+
+	return 0;
+}
+
+
+uint32_t Job_Scheduler_Stop(uint32_t uiJob)
+{
+	if (uiJob >= JOB_MAX_JOBS) return JOB_SCHEDULER_ERR_INVALID_JOB;
+
+	UInt uiKey = Hwi_disable();
+
+	if (a_sJob[uiJob].uiQueued) Job_Scheduler_Remove(uiJob);
+
+	Hwi_restore(uiKey);
+
+	return 0;
+}
+
+
+void Job_Scheduler_Work_Done(uint32_t uiJob)
+{
+	// from the task, the work the job's last run started is finished
+	if (uiJob >= JOB_MAX_JOBS) return;
+
+	Job* pJob = &a_sJob[uiJob];
+	uint32_t ui32Now = Timestamp_get32();
+
+	UInt uiKey = Hwi_disable();
+
+	if (pJob->uiWork_Pending)
+	{
+		uint32_t ui32Work_us = (ui32Now - pJob->ui32Work_Start) / g_uiJob_Cycles_Per_us;
+
+		pJob->sCounters.ui32Last_Work_us = ui32Work_us;
+		if (ui32Work_us > pJob->sCounters.ui32Max_Work_us) pJob->sCounters.ui32Max_Work_us = ui32Work_us;
+	}
+
+	pJob->uiWork_Tracked = true;
+	pJob->uiWork_Pending = false;
+
+	Hwi_restore(uiKey);
+}
+
+
+void Job_Scheduler_Get_Counters(uint32_t uiJob, Job_Counters* pCounters)
+{
+	if (uiJob >= JOB_MAX_JOBS)
+	{
+		memset(pCounters, 0, sizeof(Job_Counters));
+		return;
+	}
+
+	UInt uiKey = Hwi_disable();
+	*pCounters = a_sJob[uiJob].sCounters;
+	Hwi_restore(uiKey);
+}
+
+
+void Job_Scheduler_Report_Telemetry(void)
+{
+	uint32_t i;
+	Job_Counters sCounters;
+
+	Telemetry_Send_Output_Value("Job Scheduler Catch Up Ticks: ", g_uiJob_Wheel_Catch_Up);
+	Telemetry_Send_Output_Value("Job Scheduler Max Tick (us): ", g_uiJob_Max_Tick_us);
+
+	for (i = 0; i < JOB_MAX_JOBS; i++)
+	{
+		if (a_sJob[i].pfnJob == NULL) continue;
+
+		Job_Scheduler_Get_Counters(i, &sCounters);
+
+		Telemetry_Send_Output("Job: ");
+		Telemetry_Send_Output((char *) a_sJob[i].szName);
+		Telemetry_Send_Output("\n");
+		Telemetry_Send_Output_Value("    Period / Delay (ticks): ", Job_Scheduler_Get_Period(i));
+		Telemetry_Send_Output_Value("    Runs: ", sCounters.ui32Runs);
+		Telemetry_Send_Output_Value("    Overruns: ", sCounters.ui32Overruns);
+		Telemetry_Send_Output_Value("    Late Runs: ", sCounters.ui32Late_Runs);
+		Telemetry_Send_Output_Value("    Max Late (ticks): ", sCounters.ui32Max_Late_Ticks);
+		Telemetry_Send_Output_Value("    Max Run (us): ", sCounters.ui32Max_Run_us);
+		Telemetry_Send_Output_Value("    Max Jitter (us): ", sCounters.ui32Max_Jitter_us);
+
+		if (a_sJob[i].uiWork_Tracked == false) continue;
+
+		Telemetry_Send_Output_Value("    Work Overruns: ", sCounters.ui32Work_Overruns);
+		Telemetry_Send_Output_Value("    Last Work (us): ", sCounters.ui32Last_Work_us);
+		Telemetry_Send_Output_Value("    Max Work (us): ", sCounters.ui32Max_Work_us);
+	}
+}
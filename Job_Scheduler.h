@@ -0,0 +1,72 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Job Scheduler - one periodic Clock driving a timer wheel of named jobs.
+//
+//*****************************************************************************
+
+#ifndef JOB_SCHEDULER_H_
+#define JOB_SCHEDULER_H_
+
+#include <stdint.h>
+
+
+// Jobs
+#define JOB_TEMPERATURE_HOLD				0      // one shot, conversion time for the resolution
+#define JOB_ONE_SECOND_SYSTEM				1
+#define JOB_LED_BLINK						2
+#define JOB_EVENT_LOG_DRAIN					3
+#define JOB_FLASH_DATALOGGER				4
+#define JOB_TELEMETRY_PUBLISHER				5
+#define JOB_MAX_JOBS						8
+
+// Phases (ticks into the period) - keeps periodic jobs off the same tick
+#define JOB_PHASE_ONE_SECOND_SYSTEM			0
+#define JOB_PHASE_LED_BLINK					125
+#define JOB_PHASE_EVENT_LOG_DRAIN			50     // between the one second and LED blink ticks
+#define JOB_PHASE_FLASH_DATALOGGER			75     // off the event log drain's ticks as well
+#define JOB_PHASE_TELEMETRY_PUBLISHER		100    // after the one second system tick has had time to run
+
+#define JOB_NO_BUDGET						0
+
+// Errors
+#define JOB_SCHEDULER_ERR_INVALID_JOB		17001
+#define JOB_SCHEDULER_ERR_NOT_DEFINED		17002
+#define JOB_SCHEDULER_ERR_CLOCK				17003
+
+
+typedef void (*Job_Function)(void);
+
+
+typedef struct
+{
+	uint32_t ui32Runs;
+	uint32_t ui32Overruns;              // ran past its budget (or a whole tick with no budget)
+	uint32_t ui32Late_Runs;             // started one or more ticks after it was due
+	uint32_t ui32Max_Late_Ticks;
+	uint32_t ui32Last_Run_us;
+	uint32_t ui32Max_Run_us;
+	uint32_t ui32Max_Jitter_us;         // periodic jobs, start to start vs. the period
+	uint32_t ui32Work_Overruns;         // came due again before its task said the work was done
+	uint32_t ui32Last_Work_us;          // job start to Job_Scheduler_Work_Done()
+	uint32_t ui32Max_Work_us;
+} Job_Counters;
+
+
+uint32_t Job_Scheduler_Initialize(void);
+
+uint32_t Job_Scheduler_Define_Periodic(uint32_t uiJob, const char* szName, Job_Function pfnJob, uint32_t uiPeriod_Ticks, uint32_t uiPhase_Ticks, uint32_t uiBudget_us);
+uint32_t Job_Scheduler_Define_One_Shot(uint32_t uiJob, const char* szName, Job_Function pfnJob, uint32_t uiDelay_Ticks, uint32_t uiBudget_us);
+uint32_t Job_Scheduler_Set_Period(uint32_t uiJob, uint32_t uiTicks);
+uint32_t Job_Scheduler_Get_Period(uint32_t uiJob);
+
+uint32_t Job_Scheduler_Start(uint32_t uiJob);
+uint32_t Job_Scheduler_Stop(uint32_t uiJob);
+
+void Job_Scheduler_Work_Done(uint32_t uiJob);
+
+void Job_Scheduler_Get_Counters(uint32_t uiJob, Job_Counters* pCounters);
+void Job_Scheduler_Report_Telemetry(void);
+
+#endif /* JOB_SCHEDULER_H_ */
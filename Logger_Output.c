@@ -0,0 +1,116 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// The logger UARTs are opened with UART_MODE_BLOCKING writes at 57600 baud.  At that rate a 100
+// character line is ~17ms on the wire, and the task that writes it sits in UART_write() for all of it.
+//
+// So the acquisition tasks don't write them.  The temperature and ADC paths (and the I2C scheduler and
+// the degrade steps they call) push to Event_Log, and the drain task formats and sends those.  The
+// frames go out from the publisher task and the datalogger's boot dump.  The drain, the publisher and
+// the datalogger all run at priority 1, below every acquisition task, so the wait on the wire lands on
+// them and never on a sensor read.
+//
+// A queued writer with the UARTs in callback mode was tried here and taken back out.  Telemetry_Send_Output()
+// (Telemetry.c) calls UART_write() on the same handles itself, and on a callback mode handle that write
+// fails while a queued chunk is going out.  Until Telemetry.c writes through Logger_Output_Write() a
+// queue could never be switched on, and 4KB of rings nobody can use isn't worth keeping.
+//
+// What goes through here is written straight out and counted, a failed write is counted as dropped.
+// Anything written before Logger_Output_Attach() is dropped and counted too... no frame is sent that
+// early, the first ones are the datalogger's boot dump after the UARTs are open.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <xdc/std.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/drivers/UART.h>
+
+#include "Logger_Output.h"
+#include "Static_Footprint.h"
+
+
+
+typedef struct
+{
+	UART_Handle hHandle;
+	Logger_Output_Counters sCounters;
+} Logger_Port;
+
+
+Logger_Port a_sLogger_Port[LOGGER_MAX_PORTS];
+
+const uint32_t g_uiLogger_Output_Static_Bytes = sizeof(a_sLogger_Port);
+STATIC_FOOTPRINT_CHECK((sizeof(a_sLogger_Port)) <= STATIC_BUDGET_LOGGER_OUTPUT, Logger_Output);
+
+
+
+void Logger_Output_Initialize(void)
+{
+	memset(a_sLogger_Port, 0, sizeof(a_sLogger_Port));
+}
+
+
+void Logger_Output_Attach(uint32_t uiPort, UART_Handle hHandle)
+{
+	// a blocking write handle, called once during Driver_Setup()
+	if (uiPort >= LOGGER_MAX_PORTS) return;
+
+	a_sLogger_Port[uiPort].hHandle = hHandle;
+}
+
+
+uint32_t Logger_Output_Write(uint32_t uiPort, const char* pData, uint32_t uiLength)
+{
+	// returns the number of bytes sent... 0 if the message was dropped.  The caller waits on the wire.
+
+	if (uiPort >= LOGGER_MAX_PORTS) return 0;
+	if (uiLength == 0) return 0;
+
+	Logger_Port* pPort = &a_sLogger_Port[uiPort];
+
+	int iWritten = UART_ERROR;
+	if (pPort->hHandle != NULL) iWritten = UART_write(pPort->hHandle, pData, uiLength);
+
+	// the counters are read from other tasks
+	UInt uiKey = Hwi_disable();
+
+	if (iWritten == UART_ERROR)
+	{
+		pPort->sCounters.ui32Bytes_Dropped += uiLength;
+		pPort->sCounters.ui32Messages_Dropped++;
+		uiLength = 0;
+	}
+	else
+	{
+		pPort->sCounters.ui32Bytes_Sent += uiLength;
+	}
+
+	Hwi_restore(uiKey);
+
+	return uiLength;
+}
+
+
+uint32_t Logger_Output_Write_String(uint32_t uiPort, const char* szData)
+{
+	return Logger_Output_Write(uiPort, szData, strlen(szData));
+}
+
+
+void Logger_Output_Get_Counters(uint32_t uiPort, Logger_Output_Counters* pCounters)
+{
+	if (uiPort >= LOGGER_MAX_PORTS) return;
+
+	UInt uiKey = Hwi_disable();
+
+	*pCounters = a_sLogger_Port[uiPort].sCounters;
+
+	Hwi_restore(uiKey);
+}
@@ -0,0 +1,40 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Logger Output - counted, blocking writes to the logger UARTs.
+//
+//*****************************************************************************
+
+#ifndef LOGGER_OUTPUT_H_
+#define LOGGER_OUTPUT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <ti/drivers/UART.h>
+
+
+// Ports
+#define LOGGER_PORT_LOGGER					0
+#define LOGGER_PORT_TEST					1
+#define LOGGER_MAX_PORTS					2
+
+
+typedef struct
+{
+	uint32_t ui32Bytes_Sent;
+	uint32_t ui32Bytes_Dropped;         // a failed write, or one before the attach, is dropped whole
+	uint32_t ui32Messages_Dropped;
+} Logger_Output_Counters;
+
+
+void Logger_Output_Initialize(void);
+void Logger_Output_Attach(uint32_t uiPort, UART_Handle hHandle);
+
+uint32_t Logger_Output_Write(uint32_t uiPort, const char* pData, uint32_t uiLength);
+uint32_t Logger_Output_Write_String(uint32_t uiPort, const char* szData);
+
+void Logger_Output_Get_Counters(uint32_t uiPort, Logger_Output_Counters* pCounters);
+
+#endif /* LOGGER_OUTPUT_H_ */
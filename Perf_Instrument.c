@@ -0,0 +1,147 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// There was no timing visibility in the I2C / 1-Wire paths... the only trace was a commented out
+// g_HighestWaitCounter in Temperature_Get().
+//
+// With PERF_INSTRUMENT defined, the PERF_START / PERF_STOP pairs around the hot paths read the DWT cycle
+// counter (120 MHz on the TM4C129, ~8.3ns a count) and Perf_Record() files the difference in a
+// histogram for that operation and probe / channel.  On the PC the counter is the monotonic clock in ns.
+//
+// Each histogram is fixed memory: count, min, max, sum and PERF_BUCKETS log2 buckets.  Recording is a
+// count leading zeros and a few adds, no locks... each operation is only recorded from one task (the
+// temperature task or the ADC task), so there's nothing to race with.
+//
+// The DWT counter wraps every ~35s at 120 MHz.  A whole pass is well under that, a wrapped difference
+// is still right as long as the operation is.
+//
+// Without PERF_INSTRUMENT this file compiles to nothing and the macros in Perf_Instrument.h are empty.
+//
+//*****************************************************************************
+
+#ifdef PERF_INSTRUMENT
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Telemetry.h"
+#include "Static_Footprint.h"
+#include "Perf_Instrument.h"
+
+
+#if defined(__TI_COMPILER_VERSION__)
+#define PERF_CLZ(x)							_norm(x)
+#define PERF_DEMCR							(*(volatile uint32_t *) 0xE000EDFC)
+#define PERF_DEMCR_TRCENA					0x01000000
+#define PERF_DWT_CTRL						(*(volatile uint32_t *) 0xE0001000)
+#define PERF_DWT_CTRL_CYCCNTENA				0x00000001
+#else
+#define PERF_CLZ(x)							__builtin_clz(x)
+#endif
+
+
+Perf_Histogram a_sPerf_Histogram[PERF_MAX_OPS][PERF_MAX_SLOTS];
+
+STATIC_FOOTPRINT_CHECK(sizeof(a_sPerf_Histogram) <= STATIC_BUDGET_PERF_INSTRUMENT, Perf_Instrument);
+
+const char* a_szPerf_Operation[PERF_MAX_OPS] = { "I2C Send Command (cycles)",
+												 "I2C Receive (cycles)",
+												 "1-Wire Busy Polls (count)",
+												 "ADC Channel (cycles)",
+												 "Temperature Initiate (cycles)",
+												 "Temperature Get (cycles)",
+												 "ADC Get Data (cycles)" };
+
+
+
+void Perf_Instrument_Initialize(void)
+{
+#if defined(__TI_COMPILER_VERSION__)
+	// turn the DWT on and start the cycle counter
+	PERF_DEMCR |= PERF_DEMCR_TRCENA;
+	PERF_DWT_CYCCNT = 0;
+	PERF_DWT_CTRL |= PERF_DWT_CTRL_CYCCNTENA;
+#endif
+
+	Perf_Instrument_Reset();
+}
+
+
+void Perf_Instrument_Reset(void)
+{
+	uint32_t i, j;
+
+	memset(a_sPerf_Histogram, 0, sizeof(a_sPerf_Histogram));
+
+	for (i = 0; i < PERF_MAX_OPS; i++)
+	{
+		for (j = 0; j < PERF_MAX_SLOTS; j++) a_sPerf_Histogram[i][j].ui32Min = 0xFFFFFFFF;
+	}
+}
+
+
+void Perf_Record(uint32_t uiOperation, uint32_t uiSlot, uint32_t ui32Value)
+{
+	if ((uiOperation >= PERF_MAX_OPS) || (uiSlot >= PERF_MAX_SLOTS)) return;
+
+	Perf_Histogram* pHistogram = &a_sPerf_Histogram[uiOperation][uiSlot];
+
+	// bucket 0 is a value of 0, otherwise the number of significant bits
+	uint32_t uiBucket = ui32Value ? (32 - PERF_CLZ(ui32Value)) : 0;
+	if (uiBucket >= PERF_BUCKETS) uiBucket = PERF_BUCKETS - 1;
+
+	if (pHistogram->a_ui16Buckets[uiBucket] != 0xFFFF) pHistogram->a_ui16Buckets[uiBucket]++;
+
+	pHistogram->ui32Count++;
+	pHistogram->ui64Sum += ui32Value;
+	if (ui32Value < pHistogram->ui32Min) pHistogram->ui32Min = ui32Value;
+	if (ui32Value > pHistogram->ui32Max) pHistogram->ui32Max = ui32Value;
+}
+
+
+void Perf_Instrument_Get(uint32_t uiOperation, uint32_t uiSlot, Perf_Histogram* pHistogram)
+{
+	if ((uiOperation >= PERF_MAX_OPS) || (uiSlot >= PERF_MAX_SLOTS))
+	{
+		memset(pHistogram, 0, sizeof(Perf_Histogram));
+		return;
+	}
+
+	*pHistogram = a_sPerf_Histogram[uiOperation][uiSlot];
+}
+
+
+void Perf_Instrument_Report(void)
+{
+	uint32_t i, j, k;
+
+	for (i = 0; i < PERF_MAX_OPS; i++)
+	{
+		for (j = 0; j < PERF_MAX_SLOTS; j++)
+		{
+			Perf_Histogram* pHistogram = &a_sPerf_Histogram[i][j];
+
+			if (pHistogram->ui32Count == 0) continue;
+
+			Telemetry_Send_Output((char *) a_szPerf_Operation[i]);
+			Telemetry_Send_Output_Value("  Slot: ", j);
+			Telemetry_Send_Output_Value("    Count: ", pHistogram->ui32Count);
+			Telemetry_Send_Output_Value("    Min: ", pHistogram->ui32Min);
+			Telemetry_Send_Output_Value("    Mean: ", (uint32_t) (pHistogram->ui64Sum / pHistogram->ui32Count));
+			Telemetry_Send_Output_Value("    Max: ", pHistogram->ui32Max);
+
+			// only the buckets with something in them, "< 2^k: count"
+			for (k = 0; k < PERF_BUCKETS; k++)
+			{
+				if (pHistogram->a_ui16Buckets[k] == 0) continue;
+
+				Telemetry_Send_Output_Value("    Bucket (< 2^n) n: ", k);
+				Telemetry_Send_Output_Value("        Count: ", pHistogram->a_ui16Buckets[k]);
+			}
+		}
+	}
+}
+
+#endif
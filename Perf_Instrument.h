@@ -0,0 +1,97 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Perf Instrument - cycle counts for the I2C / 1-Wire hot paths, kept as log2 histograms.
+//
+// Build with PERF_INSTRUMENT defined to turn it on.  Without it every PERF_ macro is empty and nothing
+// here is compiled in.
+//
+//     PERF_START(ui32Perf);                                          // at the start of the operation
+//     PERF_STOP(PERF_OP_I2C_SEND_COMMAND, uiProbe, ui32Perf);        // at the end
+//     PERF_COUNT(PERF_OP_BUSY_POLLS, uiProbe, uiCounter);            // a count instead of a time
+//
+//*****************************************************************************
+
+#ifndef PERF_INSTRUMENT_H_
+#define PERF_INSTRUMENT_H_
+
+#include <stdint.h>
+
+
+// Operations
+#define PERF_OP_I2C_SEND_COMMAND			0      // DS2482 command transfer
+#define PERF_OP_I2C_RECEIVE					1      // DS2482 status / data byte
+#define PERF_OP_BUSY_POLLS					2      // 1-Wire busy polls per command (a count, not cycles)
+#define PERF_OP_ADC_CHANNEL					3      // one LTC2309 write + read, slot is the channel
+#define PERF_OP_TEMPERATURE_INITIATE		4      // whole pass
+#define PERF_OP_TEMPERATURE_GET				5      // whole pass
+#define PERF_OP_ADC_GET_DATA				6      // whole sample set
+#define PERF_MAX_OPS						7
+
+#define PERF_MAX_SLOTS						17     // a probe (0-15) or channel, or PERF_NO_SLOT
+#define PERF_NO_SLOT						16
+#define PERF_BUCKETS						32     // bucket n holds values from 2^(n-1) to 2^n - 1
+
+
+typedef struct
+{
+	uint32_t ui32Count;
+	uint32_t ui32Min;
+	uint32_t ui32Max;
+	uint64_t ui64Sum;
+	uint16_t a_ui16Buckets[PERF_BUCKETS];   // saturate at 0xFFFF
+} Perf_Histogram;
+
+
+#ifdef PERF_INSTRUMENT
+
+#if defined(__TI_COMPILER_VERSION__)
+
+// Cortex-M4 DWT cycle counter
+#define PERF_DWT_CYCCNT						(*(volatile uint32_t *) 0xE0001004)
+
+static inline uint32_t Perf_Cycles(void)
+{
+	return PERF_DWT_CYCCNT;
+}
+
+#else
+
+// on the PC, nanoseconds from the monotonic clock
+#include <time.h>
+
+static inline uint32_t Perf_Cycles(void)
+{
+	struct timespec sNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &sNow);
+	return (uint32_t) ((sNow.tv_sec * 1000000000ULL) + sNow.tv_nsec);
+}
+
+#endif
+
+void Perf_Record(uint32_t uiOperation, uint32_t uiSlot, uint32_t ui32Value);
+
+#define PERF_START(ui32Start)						uint32_t ui32Start = Perf_Cycles()
+#define PERF_STOP(uiOperation, uiSlot, ui32Start)	Perf_Record((uiOperation), (uiSlot), Perf_Cycles() - (ui32Start))
+#define PERF_COUNT(uiOperation, uiSlot, ui32Value)	Perf_Record((uiOperation), (uiSlot), (ui32Value))
+
+void Perf_Instrument_Initialize(void);
+void Perf_Instrument_Reset(void);
+void Perf_Instrument_Get(uint32_t uiOperation, uint32_t uiSlot, Perf_Histogram* pHistogram);
+void Perf_Instrument_Report(void);
+
+#else
+
+#define PERF_START(ui32Start)
+#define PERF_STOP(uiOperation, uiSlot, ui32Start)
+#define PERF_COUNT(uiOperation, uiSlot, ui32Value)
+
+#define Perf_Instrument_Initialize()
+#define Perf_Instrument_Reset()
+#define Perf_Instrument_Report()
+
+#endif
+
+#endif /* PERF_INSTRUMENT_H_ */
@@ -0,0 +1,363 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// This module predicts where the sun is from the time of day and the site coordinates.
+//
+// Tracking used to rely only on the 8 photo-resistor channels from the LTC2309.  Clouds make those
+// readings noisy and every read costs I2C time.  With a known site and time, the sun position is
+// computed here and becomes the primary target for the dish.  The photo-resistor H/V error is then
+// only a slow correction term that is added to the model (mounting errors, clock drift, etc.).
+//
+// Everything is integer / fixed point.  Angles are centi-degrees, sin/cos are Q15 and the inverse
+// functions use a 16 step CORDIC.  Against the same formulas in floating point the elevation stays
+// within about 0.05 degrees, zenith included, and the azimuth within about 0.1 degrees up to 70 degrees
+// of elevation.  Closer to the zenith the azimuth wanders more (0.3 degrees at 85, more above that), but
+// the pointing error that makes is the azimuth error times cos(elevation), so it stays under 0.05 degrees
+// as well.  Refraction is ignored.  That is all well inside what the photo-resistors correct.
+//
+// Time is seconds since 1970 (UTC).  The formulas are all relative to the J2000 epoch.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "Solar_Position.h"
+
+
+
+#define SOLAR_J2000_UNIX_SECONDS			946728000LL   // 2000-01-01 12:00:00 UTC
+#define SOLAR_SECONDS_PER_DAY				86400LL
+#define SOLAR_FULL_CIRCLE_CDEG				36000
+#define SOLAR_Q15_ONE						32767
+
+#define SOLAR_OBLIQUITY_CDEG				2344          // 23.44 degrees
+
+#define SOLAR_MIN_ELEVATION_CDEG			0             // below the horizon, the model is not used
+
+// Photo-resistor Correction
+#define SOLAR_CORRECTION_GAIN_NUM			1             // centi-degrees per H/V count = NUM / DEN
+#define SOLAR_CORRECTION_GAIN_DEN			8
+#define SOLAR_CORRECTION_LIMIT_CDEG			500           // never correct the model more than 5 degrees
+#define SOLAR_CORRECTION_MAX_ERROR			400           // bigger errors are clouds or edges, not model error
+
+
+												// sin(0..90 degrees) Q15
+int16_t a_i16Solar_Sin_Table[91] = {
+	    0,   572,  1144,  1715,  2286,  2856,  3425,  3993,  4560,  5126,
+	 5690,  6252,  6813,  7371,  7927,  8481,  9032,  9580, 10126, 10668,
+	11207, 11743, 12275, 12803, 13328, 13848, 14364, 14876, 15383, 15886,
+	16383, 16876, 17364, 17846, 18323, 18794, 19260, 19720, 20173, 20621,
+	21062, 21497, 21925, 22347, 22762, 23170, 23571, 23964, 24351, 24730,
+	25101, 25465, 25821, 26169, 26509, 26841, 27165, 27481, 27788, 28087,
+	28377, 28659, 28932, 29196, 29451, 29697, 29934, 30162, 30381, 30591,
+	30791, 30982, 31163, 31335, 31498, 31650, 31794, 31927, 32051, 32165,
+	32269, 32364, 32448, 32523, 32587, 32642, 32687, 32722, 32747, 32762,
+	32767 };
+
+												// atan(2^-i) in milli-degrees
+int32_t a_i32Solar_Cordic_Table[16] = { 45000, 26565, 14036, 7125, 3576, 1790, 895, 448, 224, 112, 56, 28, 14, 7, 3, 2 };
+
+
+int32_t g_i32Solar_Latitude_cdeg = 0;
+int32_t g_i32Solar_Longitude_cdeg = 0;
+uint32_t g_uiSolar_Site_Set = false;
+uint32_t g_uiSolar_Time_Set = false;
+
+int32_t g_i32Solar_Azimuth_cdeg = 0;
+int32_t g_i32Solar_Elevation_cdeg = 0;
+
+int32_t g_i32Solar_Azimuth_Offset_cdeg = 0;
+int32_t g_i32Solar_Elevation_Offset_cdeg = 0;
+
+
+
+int32_t Solar_Normalize_cdeg(int64_t i64Angle_cdeg)
+{
+	int32_t i32Angle = (int32_t) (i64Angle_cdeg % SOLAR_FULL_CIRCLE_CDEG);
+
+	if (i32Angle < 0) i32Angle += SOLAR_FULL_CIRCLE_CDEG;
+
+	return i32Angle;
+}
+
+
+int32_t Solar_Sin_Q15(int32_t i32Angle_cdeg)
+{
+	int32_t i32Sign = 1;
+	int32_t i32Angle = Solar_Normalize_cdeg(i32Angle_cdeg);
+
+	// fold everything down to the first quadrant
+	if (i32Angle >= 18000)
+	{
+		i32Angle -= 18000;
+		i32Sign = -1;
+	}
+
+	if (i32Angle > 9000) i32Angle = 18000 - i32Angle;
+
+
+	int32_t i32Index = i32Angle / 100;
+	int32_t i32Fraction = i32Angle % 100;
+
+	int32_t i32Value = a_i16Solar_Sin_Table[i32Index];
+	if (i32Fraction)
+	{
+		i32Value += ((a_i16Solar_Sin_Table[i32Index + 1] - a_i16Solar_Sin_Table[i32Index]) * i32Fraction) / 100;
+	}
+
+	return i32Sign * i32Value;
+}
+
+
+int32_t Solar_Cos_Q15(int32_t i32Angle_cdeg)
+{
+	return Solar_Sin_Q15(i32Angle_cdeg + 9000);
+}
+
+
+int32_t Solar_Atan2_cdeg(int32_t i32Y, int32_t i32X)
+{
+	// CORDIC vectoring - returns -18000 to 18000
+
+	int32_t i32Angle = 0;  // milli-degrees while we work
+	int32_t i32Temp;
+	int32_t i;
+
+	if ((i32X == 0) && (i32Y == 0)) return 0;
+
+	// Q15 inputs, give the shifts some room to work with
+	i32X <<= 10;
+	i32Y <<= 10;
+
+	// rotate into the right half plane, CORDIC only converges there
+	if (i32X < 0)
+	{
+		if (i32Y >= 0)
+		{
+			i32Temp = i32X;
+			i32X = i32Y;
+			i32Y = -i32Temp;
+			i32Angle = 90000;
+		}
+		else
+		{
+			i32Temp = i32X;
+			i32X = -i32Y;
+			i32Y = i32Temp;
+			i32Angle = -90000;
+		}
+	}
+
+
+	for (i = 0; i < 16; i++)
+	{
+		if (i32Y > 0)
+		{
+			i32Temp = i32X + (i32Y >> i);
+			i32Y = i32Y - (i32X >> i);
+			i32Angle += a_i32Solar_Cordic_Table[i];
+		}
+		else
+		{
+			i32Temp = i32X - (i32Y >> i);
+			i32Y = i32Y + (i32X >> i);
+			i32Angle -= a_i32Solar_Cordic_Table[i];
+		}
+
+		i32X = i32Temp;
+	}
+
+
+	if (i32Angle >= 0) return (i32Angle + 5) / 10;
+
+	return (i32Angle - 5) / 10;
+}
+
+
+uint32_t Solar_Square_Root(uint32_t ui32Value)
+{
+	uint32_t ui32Result = 0;
+	uint32_t ui32Bit = 1UL << 30;
+
+	while (ui32Bit > ui32Value) ui32Bit >>= 2;
+
+	while (ui32Bit)
+	{
+		if (ui32Value >= ui32Result + ui32Bit)
+		{
+			ui32Value -= ui32Result + ui32Bit;
+			ui32Result = (ui32Result >> 1) + ui32Bit;
+		}
+		else
+		{
+			ui32Result >>= 1;
+		}
+
+		ui32Bit >>= 2;
+	}
+
+	return ui32Result;
+}
+
+
+int32_t Solar_Asin_cdeg(int32_t i32Value_Q15)
+{
+	if (i32Value_Q15 > SOLAR_Q15_ONE) i32Value_Q15 = SOLAR_Q15_ONE;
+	if (i32Value_Q15 < -SOLAR_Q15_ONE) i32Value_Q15 = -SOLAR_Q15_ONE;
+
+	// asin(v) = atan2(v, sqrt(1 - v^2))
+	int32_t i32Cos = (int32_t) Solar_Square_Root((uint32_t) (SOLAR_Q15_ONE * SOLAR_Q15_ONE) - (uint32_t) (i32Value_Q15 * i32Value_Q15));
+
+	return Solar_Atan2_cdeg(i32Value_Q15, i32Cos);
+}
+
+
+
+void Solar_Position_Calculate(uint32_t ui32UTC_Seconds, int32_t i32Latitude_cdeg, int32_t i32Longitude_cdeg,
+								int32_t* pi32Azimuth_cdeg, int32_t* pi32Elevation_cdeg)
+{
+	int64_t i64Seconds = (int64_t) ui32UTC_Seconds - SOLAR_J2000_UNIX_SECONDS;
+
+	int64_t i64Days = i64Seconds / SOLAR_SECONDS_PER_DAY;
+	int64_t i64Remainder = i64Seconds - (i64Days * SOLAR_SECONDS_PER_DAY);
+
+
+	// Mean Longitude and Mean Anomaly - 280.460 + 0.9856474 * d  and  357.528 + 0.9856003 * d
+	int32_t i32MeanLongitude = Solar_Normalize_cdeg(28046 + (i64Seconds * 9856474LL) / (SOLAR_SECONDS_PER_DAY * 100000LL));
+	int32_t i32MeanAnomaly = Solar_Normalize_cdeg(35753 + (i64Seconds * 9856003LL) / (SOLAR_SECONDS_PER_DAY * 100000LL));
+
+	// Ecliptic Longitude - L + 1.915 sin(g) + 0.020 sin(2g)
+	int32_t i32Ecliptic = i32MeanLongitude +
+							(1915 * Solar_Sin_Q15(i32MeanAnomaly)) / (10 * SOLAR_Q15_ONE) +
+							(2 * Solar_Sin_Q15(2 * i32MeanAnomaly)) / SOLAR_Q15_ONE;
+
+
+	int32_t i32SinEcliptic = Solar_Sin_Q15(i32Ecliptic);
+	int32_t i32CosEcliptic = Solar_Cos_Q15(i32Ecliptic);
+	int32_t i32SinObliquity = Solar_Sin_Q15(SOLAR_OBLIQUITY_CDEG);
+	int32_t i32CosObliquity = Solar_Cos_Q15(SOLAR_OBLIQUITY_CDEG);
+
+
+	// Right Ascension and Declination
+	int32_t i32RightAscension = Solar_Atan2_cdeg((i32CosObliquity * i32SinEcliptic) >> 15, i32CosEcliptic);
+	int32_t i32Declination = Solar_Asin_cdeg((i32SinObliquity * i32SinEcliptic) >> 15);
+
+
+	// Greenwich Mean Sidereal Time - 280.46061837 + 360.98564736629 * d
+	// whole days only add the 0.98564736629 part, the rest of the day is a full rotation plus a little.
+	int32_t i32Sidereal = Solar_Normalize_cdeg(28046 +
+								(i64Days * 98564736629LL) / 1000000000LL +
+								(i64Remainder * 36098564737LL) / (SOLAR_SECONDS_PER_DAY * 1000000LL));
+
+	int32_t i32HourAngle = i32Sidereal + i32Longitude_cdeg - i32RightAscension;
+
+
+	int32_t i32SinLatitude = Solar_Sin_Q15(i32Latitude_cdeg);
+	int32_t i32CosLatitude = Solar_Cos_Q15(i32Latitude_cdeg);
+	int32_t i32SinDeclination = Solar_Sin_Q15(i32Declination);
+	int32_t i32CosDeclination = Solar_Cos_Q15(i32Declination);
+	int32_t i32SinHourAngle = Solar_Sin_Q15(i32HourAngle);
+	int32_t i32CosHourAngle = Solar_Cos_Q15(i32HourAngle);
+
+
+	// Azimuth (from North, clockwise) - atan2(-cos(dec) sin(H), sin(dec) cos(lat) - cos(dec) cos(H) sin(lat))
+	int32_t i32AzimuthY = -((i32CosDeclination * i32SinHourAngle) >> 15);
+	int32_t i32AzimuthX = ((i32SinDeclination * i32CosLatitude) -
+								(((i32CosDeclination * i32CosHourAngle) >> 15) * i32SinLatitude)) >> 15;
+
+	*pi32Azimuth_cdeg = Solar_Normalize_cdeg(Solar_Atan2_cdeg(i32AzimuthY, i32AzimuthX));
+
+
+	// Elevation - asin(sin(lat) sin(dec) + cos(lat) cos(dec) cos(H))
+	int32_t i32SinElevation = ((i32SinLatitude * i32SinDeclination) +
+								(((i32CosLatitude * i32CosDeclination) >> 15) * i32CosHourAngle)) >> 15;
+
+	// Not through Solar_Asin_cdeg() though... near the zenith sin(elevation) is within a few Q15 counts of 1
+	// and one count is most of a degree there.  The azimuth X / Y above are the horizontal part of the same
+	// vector, so their length is cos(elevation) measured directly, with full Q15 resolution.
+	int32_t i32CosElevation = (int32_t) Solar_Square_Root((uint32_t) (i32AzimuthX * i32AzimuthX) + (uint32_t) (i32AzimuthY * i32AzimuthY));
+
+	*pi32Elevation_cdeg = Solar_Atan2_cdeg(i32SinElevation, i32CosElevation);
+}
+
+
+
+void Solar_Position_Set_Site(int32_t i32Latitude_cdeg, int32_t i32Longitude_cdeg)
+{
+	g_i32Solar_Latitude_cdeg = i32Latitude_cdeg;
+	g_i32Solar_Longitude_cdeg = i32Longitude_cdeg;
+	g_uiSolar_Site_Set = true;
+
+	// a new site means the old correction means nothing
+	Solar_Position_Reset_Correction();
+}
+
+
+void Solar_Position_Update(uint32_t ui32UTC_Seconds)
+{
+	// called from the one second timer...
+	if (g_uiSolar_Site_Set == false) return;
+
+	Solar_Position_Calculate(ui32UTC_Seconds, g_i32Solar_Latitude_cdeg, g_i32Solar_Longitude_cdeg,
+								&g_i32Solar_Azimuth_cdeg, &g_i32Solar_Elevation_cdeg);
+
+	g_uiSolar_Time_Set = true;
+}
+
+
+uint32_t Solar_Position_Is_Valid(void)
+{
+	if (g_uiSolar_Site_Set == false) return false;
+	if (g_uiSolar_Time_Set == false) return false;
+
+	if (g_i32Solar_Elevation_cdeg <= SOLAR_MIN_ELEVATION_CDEG) return false;
+
+	return true;
+}
+
+
+uint32_t Solar_Position_Get_Target(int32_t* pi32Azimuth_cdeg, int32_t* pi32Elevation_cdeg)
+{
+	*pi32Azimuth_cdeg = Solar_Normalize_cdeg(g_i32Solar_Azimuth_cdeg + g_i32Solar_Azimuth_Offset_cdeg);
+	*pi32Elevation_cdeg = g_i32Solar_Elevation_cdeg + g_i32Solar_Elevation_Offset_cdeg;
+
+	return Solar_Position_Is_Valid();
+}
+
+
+void Solar_Position_Reset_Correction(void)
+{
+	g_i32Solar_Azimuth_Offset_cdeg = 0;
+	g_i32Solar_Elevation_Offset_cdeg = 0;
+}
+
+
+int32_t Solar_Clamp_Correction(int32_t i32Offset_cdeg)
+{
+	if (i32Offset_cdeg > SOLAR_CORRECTION_LIMIT_CDEG) return SOLAR_CORRECTION_LIMIT_CDEG;
+	if (i32Offset_cdeg < -SOLAR_CORRECTION_LIMIT_CDEG) return -SOLAR_CORRECTION_LIMIT_CDEG;
+
+	return i32Offset_cdeg;
+}
+
+
+void Solar_Position_Apply_Correction(int iH_Error, int iV_Error)
+{
+	// The H/V error is the same MT_iH_ResultCalc / MT_iV_ResultCalc the dish motor code chases.
+	// Positive H moves the azimuth up, positive V moves the elevation up.
+
+	if (Solar_Position_Is_Valid() == false) return;
+
+	// big swings are clouds passing or the sun on the edge of the sensors, don't chase them.
+	if (abs(iH_Error) > SOLAR_CORRECTION_MAX_ERROR) return;
+	if (abs(iV_Error) > SOLAR_CORRECTION_MAX_ERROR) return;
+
+	g_i32Solar_Azimuth_Offset_cdeg = Solar_Clamp_Correction(g_i32Solar_Azimuth_Offset_cdeg +
+											(iH_Error * SOLAR_CORRECTION_GAIN_NUM) / SOLAR_CORRECTION_GAIN_DEN);
+
+	g_i32Solar_Elevation_Offset_cdeg = Solar_Clamp_Correction(g_i32Solar_Elevation_Offset_cdeg +
+											(iV_Error * SOLAR_CORRECTION_GAIN_NUM) / SOLAR_CORRECTION_GAIN_DEN);
+}
@@ -0,0 +1,29 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Solar Position - integer/fixed-point sun ephemeris for the dish.
+//
+// All angles are in centi-degrees (1/100 of a degree).
+//
+//*****************************************************************************
+
+#ifndef SOLAR_POSITION_H_
+#define SOLAR_POSITION_H_
+
+#include <stdint.h>
+
+
+void Solar_Position_Set_Site(int32_t i32Latitude_cdeg, int32_t i32Longitude_cdeg);
+void Solar_Position_Update(uint32_t ui32UTC_Seconds);
+
+uint32_t Solar_Position_Is_Valid(void);
+uint32_t Solar_Position_Get_Target(int32_t* pi32Azimuth_cdeg, int32_t* pi32Elevation_cdeg);
+
+void Solar_Position_Apply_Correction(int iH_Error, int iV_Error);
+void Solar_Position_Reset_Correction(void);
+
+void Solar_Position_Calculate(uint32_t ui32UTC_Seconds, int32_t i32Latitude_cdeg, int32_t i32Longitude_cdeg,
+								int32_t* pi32Azimuth_cdeg, int32_t* pi32Elevation_cdeg);
+
+#endif /* SOLAR_POSITION_H_ */
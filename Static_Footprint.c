@@ -0,0 +1,60 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// The long lived objects in this controller (clocks, semaphores, rings, histories) are all allocated
+// statically and constructed in place (Clock_construct(), Semaphore_construct()).  Nothing is created
+// from the heap after boot, so a board that runs for months can't fragment it.  The UART, I2C and PWM
+// driver objects are already static, they come from the Board configuration tables.
+//
+// Each module exports the size of its static objects (g_ui<Module>_Static_Bytes) and checks it against
+// its budget in Static_Footprint.h when it is compiled.  This checks the budgets add up to no more than
+// STATIC_FOOTPRINT_RAM_BUDGET, and Static_Footprint_Report() lists the sizes at boot.
+//
+// The linker map (.bss / .data per object file) has the same numbers for the whole image.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Telemetry.h"
+#include "Static_Footprint.h"
+
+
+STATIC_FOOTPRINT_CHECK((STATIC_BUDGET_LOGGER_OUTPUT + STATIC_BUDGET_EVENT_LOG + STATIC_BUDGET_FLASH_DATALOGGER +
+						STATIC_BUDGET_I2C_SCHEDULER + STATIC_BUDGET_JOB_SCHEDULER + STATIC_BUDGET_TEMPERATURE_HISTORY +
+						STATIC_BUDGET_TEMPERATURE_SNAPSHOT + STATIC_BUDGET_TEMPERATURE_ESTIMATOR + STATIC_BUDGET_TELEMETRY_PUBLISHER) <= STATIC_FOOTPRINT_RAM_BUDGET, Total);
+
+
+// from each module
+extern const uint32_t g_uiLogger_Output_Static_Bytes;
+extern const uint32_t g_uiEvent_Log_Static_Bytes;
+extern const uint32_t g_uiFlash_Datalogger_Static_Bytes;
+extern const uint32_t g_uiI2C_Scheduler_Static_Bytes;
+extern const uint32_t g_uiJob_Scheduler_Static_Bytes;
+extern const uint32_t g_uiTemperature_History_Static_Bytes;
+extern const uint32_t g_uiTemperature_Snapshot_Static_Bytes;
+extern const uint32_t g_uiTemperature_Estimator_Static_Bytes;
+extern const uint32_t g_uiTelemetry_Publisher_Static_Bytes;
+
+
+void Static_Footprint_Report(void)
+{
+	uint32_t uiTotal = g_uiLogger_Output_Static_Bytes + g_uiEvent_Log_Static_Bytes + g_uiFlash_Datalogger_Static_Bytes +
+					   g_uiI2C_Scheduler_Static_Bytes + g_uiJob_Scheduler_Static_Bytes + g_uiTemperature_History_Static_Bytes +
+					   g_uiTemperature_Snapshot_Static_Bytes + g_uiTemperature_Estimator_Static_Bytes + g_uiTelemetry_Publisher_Static_Bytes;
+
+	Telemetry_Send_Output("Static RAM (bytes)\n");
+	Telemetry_Send_Output_Value("    Logger Output: ", g_uiLogger_Output_Static_Bytes);
+	Telemetry_Send_Output_Value("    Event Log: ", g_uiEvent_Log_Static_Bytes);
+	Telemetry_Send_Output_Value("    Flash Datalogger: ", g_uiFlash_Datalogger_Static_Bytes);
+	Telemetry_Send_Output_Value("    I2C Scheduler: ", g_uiI2C_Scheduler_Static_Bytes);
+	Telemetry_Send_Output_Value("    Job Scheduler: ", g_uiJob_Scheduler_Static_Bytes);
+	Telemetry_Send_Output_Value("    Temperature History: ", g_uiTemperature_History_Static_Bytes);
+	Telemetry_Send_Output_Value("    Temperature Snapshot: ", g_uiTemperature_Snapshot_Static_Bytes);
+	Telemetry_Send_Output_Value("    Temperature Estimator: ", g_uiTemperature_Estimator_Static_Bytes);
+	Telemetry_Send_Output_Value("    Telemetry Publisher: ", g_uiTelemetry_Publisher_Static_Bytes);
+	Telemetry_Send_Output_Value("    Total: ", uiTotal);
+	Telemetry_Send_Output_Value("    Budget: ", STATIC_FOOTPRINT_RAM_BUDGET);
+}
@@ -0,0 +1,40 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Static Footprint - RAM budgets for the statically allocated module objects.
+//
+// Every module that owns a large static object checks it against its budget here with
+// STATIC_FOOTPRINT_CHECK().  Going over a budget stops the build with an error that names the module.
+//
+//*****************************************************************************
+
+#ifndef STATIC_FOOTPRINT_H_
+#define STATIC_FOOTPRINT_H_
+
+#include <stdint.h>
+
+
+// compile time check... the array size goes negative and the build stops when the condition is false
+#define STATIC_FOOTPRINT_CHECK(bCondition, Module)		typedef char Static_Footprint_Over_Budget_##Module[(bCondition) ? 1 : -1]
+
+
+// Budgets, bytes
+#define STATIC_BUDGET_LOGGER_OUTPUT				64     // 2 handles + counters
+#define STATIC_BUDGET_EVENT_LOG					5376   // 2 x 64 records + the drain task's stack
+#define STATIC_BUDGET_FLASH_DATALOGGER			2048   // RAM page + tail index + the logging task's stack
+#define STATIC_BUDGET_I2C_SCHEDULER				1280
+#define STATIC_BUDGET_JOB_SCHEDULER				1024
+#define STATIC_BUDGET_TEMPERATURE_HISTORY		6144   // 16 probes x 3 windows of 124 bytes
+#define STATIC_BUDGET_TEMPERATURE_SNAPSHOT		768
+#define STATIC_BUDGET_TEMPERATURE_ESTIMATOR		640    // 16 probes
+#define STATIC_BUDGET_TELEMETRY_PUBLISHER		1152   // the published values + the publishing task's stack
+#define STATIC_BUDGET_PERF_INSTRUMENT			12288  // only with PERF_INSTRUMENT, not in the total
+#define STATIC_BUDGET_I2C_TRACE					24576  // only with I2C_TRACE, not in the total
+
+#define STATIC_FOOTPRINT_RAM_BUDGET				32768  // all of the above, of 256KB SRAM
+
+
+void Static_Footprint_Report(void);
+
+#endif /* STATIC_FOOTPRINT_H_ */
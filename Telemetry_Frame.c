@@ -0,0 +1,286 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Telemetry used to leave the board only as text at 57600 baud, roughly 40 characters per probe, so
+// only a throttled subset of the readings could be sent.  This module packs the temperature and the
+// dish movement telemetry into small binary frames (layout in Telemetry_Frame.h).
+//     Temperature - 16 probes in 61 bytes on the wire (was ~650 bytes of text)
+//     Dish        - 34 bytes on the wire
+// That is small enough to send every reading.
+//
+// Values are fixed point (1/10 degree C) and every probe carries its status bits, so the host can tell
+// a good reading from a held one.  Frames are COBS encoded and end in 0x00, with a CRC-16 inside.
+// The probes come from Temperature_Snapshot, never the live table.
+//
+// The Build routines only fill a buffer, so the same frame can go out the logger UART or over UDP.  They
+// build from the copy they are given (Temperature_Snapshot_Read(), Telemetry_Frame_Get_Dish()), so a
+// caller that also keeps the values, like Telemetry_Publisher, has exactly what went out.
+// Telemetry_Publisher uses the Get / Encode routines to send only what changed.
+// The host side decoder is tools/Telemetry_Decode.c.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <xdc/std.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#include "constants.h"
+#include "globals.h"
+
+#include "Solar_Position.h"
+#include "Logger_Output.h"
+#include "Telemetry_Frame.h"
+#include "I2C_HAL.h"
+
+
+#define TELEMETRY_STALE_TICKS				10000  // ms
+
+
+// from ADC_Interface.c
+extern uint32_t g_uiADC_Sample_Mode;
+
+
+uint16_t g_ui16Telemetry_Sequence;
+uint32_t g_uiTelemetry_Frame_Port = LOGGER_PORT_TEST;
+
+
+
+uint16_t Telemetry_Frame_CRC16(const uint8_t* pData, uint32_t uiLength)
+{
+	// CRC-16/CCITT-FALSE  poly 0x1021, init 0xFFFF... a nibble at a time, 16 entry table
+	static const uint16_t a_ui16CRC_Table[16] = {0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+												 0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF};
+
+	uint16_t ui16CRC = 0xFFFF;
+	uint32_t i;
+
+	for (i = 0; i < uiLength; i++)
+	{
+		ui16CRC = (ui16CRC << 4) ^ a_ui16CRC_Table[(ui16CRC >> 12) ^ (pData[i] >> 4)];
+		ui16CRC = (ui16CRC << 4) ^ a_ui16CRC_Table[(ui16CRC >> 12) ^ (pData[i] & 0x0F)];
+	}
+
+	return ui16CRC;
+}
+
+
+uint32_t Telemetry_Frame_COBS_Encode(const uint8_t* pData, uint32_t uiLength, uint8_t* pEncoded)
+{
+	// Consistent Overhead Byte Stuffing... no 0x00 in the output except the trailing delimiter.
+	// returns the encoded length including the delimiter.
+
+	uint32_t uiRead = 0;
+	uint32_t uiWrite = 1;
+	uint32_t uiCode_Index = 0;
+	uint8_t ui8Code = 1;
+
+	while (uiRead < uiLength)
+	{
+		if (pData[uiRead] == 0)
+		{
+			pEncoded[uiCode_Index] = ui8Code;
+			uiCode_Index = uiWrite++;
+			ui8Code = 1;
+		}
+		else
+		{
+			pEncoded[uiWrite++] = pData[uiRead];
+			ui8Code++;
+
+			if (ui8Code == 0xFF)
+			{
+				pEncoded[uiCode_Index] = ui8Code;
+				uiCode_Index = uiWrite++;
+				ui8Code = 1;
+			}
+		}
+
+		uiRead++;
+	}
+
+	pEncoded[uiCode_Index] = ui8Code;
+	pEncoded[uiWrite++] = 0x00;
+
+	return uiWrite;
+}
+
+
+static uint32_t Telemetry_Frame_Put_Header(uint8_t* pRaw, uint32_t uiType)
+{
+	uint32_t ui32Ticks = I2C_HAL_Get_Ticks();
+
+	g_ui16Telemetry_Sequence++;
+
+	pRaw[0] = TELEMETRY_FRAME_VERSION;
+	pRaw[1] = (uint8_t) uiType;
+	pRaw[2] = (uint8_t) g_ui16Telemetry_Sequence;
+	pRaw[3] = (uint8_t) (g_ui16Telemetry_Sequence >> 8);
+	pRaw[4] = (uint8_t) ui32Ticks;
+	pRaw[5] = (uint8_t) (ui32Ticks >> 8);
+	pRaw[6] = (uint8_t) (ui32Ticks >> 16);
+	pRaw[7] = (uint8_t) (ui32Ticks >> 24);
+
+	return TELEMETRY_FRAME_HEADER_SIZE;
+}
+
+
+static uint32_t Telemetry_Frame_Finish(uint8_t* pRaw, uint32_t uiLength, uint8_t* pEncoded)
+{
+	uint16_t ui16CRC = Telemetry_Frame_CRC16(pRaw, uiLength);
+
+	pRaw[uiLength++] = (uint8_t) ui16CRC;
+	pRaw[uiLength++] = (uint8_t) (ui16CRC >> 8);
+
+	return Telemetry_Frame_COBS_Encode(pRaw, uiLength, pEncoded);
+}
+
+
+void Telemetry_Frame_Put_16(uint8_t* pRaw, uint32_t* puiIndex, uint16_t ui16Value)
+{
+	pRaw[(*puiIndex)++] = (uint8_t) ui16Value;
+	pRaw[(*puiIndex)++] = (uint8_t) (ui16Value >> 8);
+}
+
+
+void Telemetry_Frame_Get_Probe(const Temperature_Snapshot* pSnapshot, uint32_t uiTemperatureIndex, int16_t* pi16Tenths, uint8_t* pui8Status)
+{
+	// value and status bits of one probe, as they go into a frame
+
+	const Temperature_Probe_Snapshot* pProbe = &pSnapshot->a_sProbe[uiTemperatureIndex];
+	uint8_t ui8Status = 0;
+
+	if (pProbe->ui8Valid)
+	{
+		ui8Status |= TELEMETRY_PROBE_VALID;
+		if ((I2C_HAL_Get_Ticks() - pProbe->ui32Last_Good_Ticks) > TELEMETRY_STALE_TICKS) ui8Status |= TELEMETRY_PROBE_STALE;
+	}
+
+	if ((pProbe->ui32Error_Flag != NO_ERRORS) && (pProbe->ui32Error_Flag != TEMPERATURE_ERROR_NOT_DUE)) ui8Status |= TELEMETRY_PROBE_ERROR;
+	if (pProbe->ui8ROM_Flag) ui8Status |= TELEMETRY_PROBE_ROM;
+	if (pProbe->ui8Configured) ui8Status |= TELEMETRY_PROBE_CONFIGURED;
+	ui8Status |= (uint8_t) ((pProbe->ui8Health << TELEMETRY_PROBE_HEALTH_SHIFT) & TELEMETRY_PROBE_HEALTH_MASK);
+
+	*pi16Tenths = pProbe->i16Tenths_C;
+	*pui8Status = ui8Status;
+}
+
+
+void Telemetry_Frame_Get_Dish(uint16_t* pui16Channels, uint8_t* pui8Mode, uint8_t* pui8Flags)
+{
+	// pui16Channels holds TELEMETRY_DISH_CHANNELS values... H[4], V[4], H result, V result
+	uint32_t i;
+
+	for (i = 0; i < 4; i++) pui16Channels[i] = (uint16_t) g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_H_Data[i];
+	for (i = 0; i < 4; i++) pui16Channels[4 + i] = (uint16_t) g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_V_Data[i];
+
+	pui16Channels[8] = (uint16_t) (int16_t) g_s_Dish_Movement_Telemetry.MT_iH_ResultCalc;
+	pui16Channels[9] = (uint16_t) (int16_t) g_s_Dish_Movement_Telemetry.MT_iV_ResultCalc;
+
+	*pui8Mode = (uint8_t) g_uiADC_Sample_Mode;
+	*pui8Flags = Solar_Position_Is_Valid() ? TELEMETRY_DISH_SOLAR_VALID : 0;
+}
+
+
+uint32_t Telemetry_Frame_Encode(uint32_t uiType, const uint8_t* pPayload, uint32_t uiLength, uint8_t* pEncoded)
+{
+	// header + payload + CRC, COBS encoded... returns the number of bytes to send
+
+	uint8_t a_ui8Raw[TELEMETRY_FRAME_MAX_RAW];
+
+	if (uiLength > TELEMETRY_FRAME_MAX_PAYLOAD) return 0;
+
+	uint32_t uiIndex = Telemetry_Frame_Put_Header(a_ui8Raw, uiType);
+
+	memcpy(&a_ui8Raw[uiIndex], pPayload, uiLength);
+
+	return Telemetry_Frame_Finish(a_ui8Raw, uiIndex + uiLength, pEncoded);
+}
+
+
+uint32_t Telemetry_Frame_Build_Temperature(const Temperature_Snapshot* pSnapshot, uint8_t* pEncoded)
+{
+	// pEncoded must hold TELEMETRY_FRAME_MAX_ENCODED bytes... returns the number of bytes to send
+
+	uint8_t a_ui8Payload[TELEMETRY_FRAME_MAX_PAYLOAD];
+	uint32_t uiIndex = 0;
+	uint32_t i;
+
+	a_ui8Payload[uiIndex++] = MAX_TEMPERATURE_PROBES;
+
+	for (i = 0; i < MAX_TEMPERATURE_PROBES; i++)
+	{
+		int16_t i16Tenths;
+		uint8_t ui8Status;
+
+		Telemetry_Frame_Get_Probe(pSnapshot, i, &i16Tenths, &ui8Status);
+
+		Telemetry_Frame_Put_16(a_ui8Payload, &uiIndex, (uint16_t) i16Tenths);
+		a_ui8Payload[uiIndex++] = ui8Status;
+	}
+
+	return Telemetry_Frame_Encode(TELEMETRY_FRAME_TYPE_TEMPERATURE, a_ui8Payload, uiIndex, pEncoded);
+}
+
+
+uint32_t Telemetry_Frame_Build_Dish(const uint16_t* pui16Channels, uint8_t ui8Mode, uint8_t ui8Flags, uint8_t* pEncoded)
+{
+	// pEncoded must hold TELEMETRY_FRAME_MAX_ENCODED bytes, pui16Channels TELEMETRY_DISH_CHANNELS... returns the number of bytes to send
+
+	uint8_t a_ui8Payload[TELEMETRY_FRAME_MAX_PAYLOAD];
+	uint32_t uiIndex = 0;
+	uint32_t i;
+
+	for (i = 0; i < TELEMETRY_DISH_CHANNELS; i++) Telemetry_Frame_Put_16(a_ui8Payload, &uiIndex, pui16Channels[i]);
+
+	a_ui8Payload[uiIndex++] = ui8Mode;
+	a_ui8Payload[uiIndex++] = ui8Flags;
+
+	return Telemetry_Frame_Encode(TELEMETRY_FRAME_TYPE_DISH, a_ui8Payload, uiIndex, pEncoded);
+}
+
+
+void Telemetry_Frame_Set_Port(uint32_t uiPort)
+{
+	if (uiPort < LOGGER_MAX_PORTS) g_uiTelemetry_Frame_Port = uiPort;
+}
+
+
+uint32_t Telemetry_Frame_Write(const uint8_t* pEncoded, uint32_t uiLength)
+{
+	return Logger_Output_Write(g_uiTelemetry_Frame_Port, (const char *) pEncoded, uiLength);
+}
+
+
+uint32_t Telemetry_Frame_Send_Temperature(void)
+{
+	uint8_t a_ui8Encoded[TELEMETRY_FRAME_MAX_ENCODED];
+	Temperature_Snapshot sSnapshot;
+
+	// one consistent copy of all the probes
+	Temperature_Snapshot_Read(&sSnapshot);
+
+	uint32_t uiLength = Telemetry_Frame_Build_Temperature(&sSnapshot, a_ui8Encoded);
+
+	return Telemetry_Frame_Write(a_ui8Encoded, uiLength);
+}
+
+
+uint32_t Telemetry_Frame_Send_Dish(void)
+{
+	uint8_t a_ui8Encoded[TELEMETRY_FRAME_MAX_ENCODED];
+	uint16_t a_ui16Channels[TELEMETRY_DISH_CHANNELS];
+	uint8_t ui8Mode;
+	uint8_t ui8Flags;
+
+	Telemetry_Frame_Get_Dish(a_ui16Channels, &ui8Mode, &ui8Flags);
+
+	uint32_t uiLength = Telemetry_Frame_Build_Dish(a_ui16Channels, ui8Mode, ui8Flags, a_ui8Encoded);
+
+	return Telemetry_Frame_Write(a_ui8Encoded, uiLength);
+}
@@ -0,0 +1,104 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Telemetry Frame - compact binary frames for the temperature and dish movement telemetry.
+//
+// This header is also used by tools/Telemetry_Decode.c on the host, keep it free of TI includes.
+//
+// Frame (before COBS encoding), all values little endian:
+//     [0]     version             TELEMETRY_FRAME_VERSION
+//     [1]     type                TELEMETRY_FRAME_TYPE_
+//     [2-3]   sequence            increments on every frame sent
+//     [4-7]   time                Clock ticks (ms)
+//     [8-n]   payload
+//     [n+1-2] CRC-16/CCITT-FALSE  over version through the end of the payload
+// The frame is COBS encoded and ends with a single 0x00, so a receiver can always resync on the next 0x00.
+//
+// Temperature payload:
+//     [0]     probe count
+//     per probe (3 bytes):
+//         int16   temperature, 1/10 degree C
+//         uint8   status - TELEMETRY_PROBE_
+//
+// Dish movement payload:
+//     uint16  H[4]                photo-resistor averages
+//     uint16  V[4]
+//     int16   H result, V result
+//     uint8   ADC sample mode
+//     uint8   flags - TELEMETRY_DISH_
+//
+// Temperature delta payload (Telemetry_Publisher, only the probes that changed):
+//     [0]     probe count
+//     per probe (4 bytes):
+//         uint8   probe index
+//         int16   temperature, 1/10 degree C
+//         uint8   status
+//
+// Dish delta payload (Telemetry_Publisher, only the channels that changed):
+//     uint16  channel mask        bit 0-3 H[], bit 4-7 V[], bit 8 H result, bit 9 V result
+//     uint16  value               for each set bit, lowest bit first
+//     uint8   ADC sample mode
+//     uint8   flags
+//
+// The full frames are the keyframes... a receiver starts from one and applies the deltas after it.
+//
+//*****************************************************************************
+
+#ifndef TELEMETRY_FRAME_H_
+#define TELEMETRY_FRAME_H_
+
+#include <stdint.h>
+
+#include "Temperature_Snapshot.h"
+
+
+#define TELEMETRY_FRAME_VERSION				1
+
+#define TELEMETRY_FRAME_TYPE_TEMPERATURE	1
+#define TELEMETRY_FRAME_TYPE_DISH			2
+#define TELEMETRY_FRAME_TYPE_TEMPERATURE_DELTA	3
+#define TELEMETRY_FRAME_TYPE_DISH_DELTA		4
+
+#define TELEMETRY_FRAME_HEADER_SIZE			8
+#define TELEMETRY_FRAME_CRC_SIZE			2
+#define TELEMETRY_FRAME_MAX_PAYLOAD			72
+#define TELEMETRY_FRAME_MAX_RAW				(TELEMETRY_FRAME_HEADER_SIZE + TELEMETRY_FRAME_MAX_PAYLOAD + TELEMETRY_FRAME_CRC_SIZE)
+#define TELEMETRY_FRAME_MAX_ENCODED			(TELEMETRY_FRAME_MAX_RAW + (TELEMETRY_FRAME_MAX_RAW / 254) + 2)
+
+#define TELEMETRY_PROBE_BYTES				3
+#define TELEMETRY_DISH_BYTES				22
+#define TELEMETRY_DISH_CHANNELS				10
+#define TELEMETRY_DELTA_PROBE_BYTES			4
+
+// per probe status bits
+#define TELEMETRY_PROBE_VALID				0x01   // there has been at least one good reading
+#define TELEMETRY_PROBE_ERROR				0x02   // the last attempt failed, the value is the last good one
+#define TELEMETRY_PROBE_ROM					0x04   // ROM code has been read
+#define TELEMETRY_PROBE_CONFIGURED			0x08   // resolution is set
+#define TELEMETRY_PROBE_HEALTH_MASK			0x30   // PROBE_HEALTHY / SUSPECT / QUARANTINED
+#define TELEMETRY_PROBE_HEALTH_SHIFT		4
+#define TELEMETRY_PROBE_STALE				0x40   // the reading is older than TELEMETRY_STALE_TICKS
+
+// dish flags
+#define TELEMETRY_DISH_SOLAR_VALID			0x01   // the sun position model is driving the dish
+
+
+uint16_t Telemetry_Frame_CRC16(const uint8_t* pData, uint32_t uiLength);
+uint32_t Telemetry_Frame_COBS_Encode(const uint8_t* pData, uint32_t uiLength, uint8_t* pEncoded);
+
+void Telemetry_Frame_Put_16(uint8_t* pRaw, uint32_t* puiIndex, uint16_t ui16Value);
+uint32_t Telemetry_Frame_Encode(uint32_t uiType, const uint8_t* pPayload, uint32_t uiLength, uint8_t* pEncoded);
+
+void Telemetry_Frame_Get_Probe(const Temperature_Snapshot* pSnapshot, uint32_t uiTemperatureIndex, int16_t* pi16Tenths, uint8_t* pui8Status);
+void Telemetry_Frame_Get_Dish(uint16_t* pui16Channels, uint8_t* pui8Mode, uint8_t* pui8Flags);
+
+uint32_t Telemetry_Frame_Build_Temperature(const Temperature_Snapshot* pSnapshot, uint8_t* pEncoded);
+uint32_t Telemetry_Frame_Build_Dish(const uint16_t* pui16Channels, uint8_t ui8Mode, uint8_t ui8Flags, uint8_t* pEncoded);
+
+void Telemetry_Frame_Set_Port(uint32_t uiPort);
+uint32_t Telemetry_Frame_Write(const uint8_t* pEncoded, uint32_t uiLength);
+uint32_t Telemetry_Frame_Send_Temperature(void);
+uint32_t Telemetry_Frame_Send_Dish(void);
+
+#endif /* TELEMETRY_FRAME_H_ */
@@ -0,0 +1,322 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Every probe and every ADC channel used to be reported each time, changed or not.  Most of the time
+// nothing moves... the ground and outside air probes change a tenth of a degree every few minutes and
+// a settled dish reads the same counts all afternoon.
+//
+// Telemetry_Publisher_Publish() keeps the last value SENT for each channel and only sends the channels
+// that are now more than the deadband away from it (layout of the delta frames in Telemetry_Frame.h).
+// Comparing against the last sent value, not the last reading, means a slow drift still goes out once
+// it adds up to the deadband.  A change in a probe's status bits always goes out.
+//
+// A keyframe (the full temperature and dish frames) goes out every keyframe interval, on the first call
+// and after Telemetry_Publisher_Force_Keyframe(), so a receiver that missed a frame resyncs.
+// When so many probes changed that the delta frame would be as big as the full one, the full one is sent.
+// A keyframe is built from the same copy the baselines are taken from, a publish of the snapshot in
+// between can't make the receiver's values and the ones kept here differ.
+//
+// Publishing is the JOB_TELEMETRY_PUBLISHER job, once a second on its own low priority task like the
+// datalogger... the frames go out the logger port and the acquisition tasks never wait on it.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <xdc/std.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/knl/Task.h>
+#include <ti/sysbios/knl/Semaphore.h>
+
+#include "constants.h"
+#include "globals.h"
+
+#include "Telemetry_Frame.h"
+#include "Telemetry_Publisher.h"
+#include "I2C_HAL.h"
+#include "Job_Scheduler.h"
+#include "Static_Footprint.h"
+
+
+
+#define PUBLISHER_TEMPERATURE_DEADBAND		2      // 1/10 degree C
+#define PUBLISHER_ADC_DEADBAND				8      // counts
+#define PUBLISHER_KEYFRAME_TICKS			30000  // ms
+#define PUBLISHER_DISH_RESULT_CHANNEL		8      // channels 8 and 9 are signed
+#define PUBLISHER_TASK_STACK				1024   // bytes, a snapshot, a delta and a keyframe frame
+
+
+uint32_t g_uiPublisher_Temperature_Deadband = PUBLISHER_TEMPERATURE_DEADBAND;
+uint32_t g_uiPublisher_ADC_Deadband = PUBLISHER_ADC_DEADBAND;
+uint32_t g_uiPublisher_Keyframe_Ticks = PUBLISHER_KEYFRAME_TICKS;
+
+uint32_t g_uiPublisher_Keyframe_Due = true;
+uint32_t g_uiPublisher_Last_Keyframe;
+
+int16_t a_i16Published_Tenths[MAX_TEMPERATURE_PROBES];
+uint8_t a_ui8Published_Status[MAX_TEMPERATURE_PROBES];
+
+uint16_t a_ui16Published_Dish[TELEMETRY_DISH_CHANNELS];
+uint8_t g_ui8Published_Mode;
+uint8_t g_ui8Published_Flags;
+
+Telemetry_Publisher_Counters g_sPublisher_Counters;
+
+Task_Struct g_sPublisher_Task;
+Semaphore_Struct g_sPublisher_Semaphore;
+uint64_t a_ui64Publisher_Stack[PUBLISHER_TASK_STACK / sizeof(uint64_t)];   // 8 byte aligned
+
+const uint32_t g_uiTelemetry_Publisher_Static_Bytes = sizeof(a_i16Published_Tenths) + sizeof(a_ui8Published_Status) + sizeof(a_ui16Published_Dish) + sizeof(g_sPublisher_Counters) + sizeof(a_ui64Publisher_Stack);
+STATIC_FOOTPRINT_CHECK((sizeof(a_i16Published_Tenths) + sizeof(a_ui8Published_Status) + sizeof(a_ui16Published_Dish) + sizeof(g_sPublisher_Counters) + sizeof(a_ui64Publisher_Stack)) <= STATIC_BUDGET_TELEMETRY_PUBLISHER, Telemetry_Publisher);
+
+
+
+void Telemetry_Publisher_Set_Deadbands(uint32_t uiTemperature_Tenths, uint32_t uiADC_Counts)
+{
+	g_uiPublisher_Temperature_Deadband = uiTemperature_Tenths;
+	g_uiPublisher_ADC_Deadband = uiADC_Counts;
+}
+
+
+void Telemetry_Publisher_Set_Keyframe_Interval(uint32_t uiTicks)
+{
+	g_uiPublisher_Keyframe_Ticks = uiTicks;
+}
+
+
+void Telemetry_Publisher_Force_Keyframe(void)
+{
+	g_uiPublisher_Keyframe_Due = true;
+}
+
+
+static uint32_t Telemetry_Publisher_Send(const uint8_t* pEncoded, uint32_t uiLength)
+{
+	uint32_t uiSent = Telemetry_Frame_Write(pEncoded, uiLength);
+
+	g_sPublisher_Counters.ui32Bytes += uiSent;
+
+	return uiSent;
+}
+
+
+static uint32_t Telemetry_Publisher_Keyframe_Temperature(const Temperature_Snapshot* pSnapshot)
+{
+	// the baseline and the frame both come from pSnapshot
+	uint8_t a_ui8Encoded[TELEMETRY_FRAME_MAX_ENCODED];
+	uint32_t i;
+
+	for (i = 0; i < MAX_TEMPERATURE_PROBES; i++)
+	{
+		Telemetry_Frame_Get_Probe(pSnapshot, i, &a_i16Published_Tenths[i], &a_ui8Published_Status[i]);
+	}
+
+	g_sPublisher_Counters.ui32Keyframes++;
+
+	return Telemetry_Publisher_Send(a_ui8Encoded, Telemetry_Frame_Build_Temperature(pSnapshot, a_ui8Encoded));
+}
+
+
+static uint32_t Telemetry_Publisher_Keyframe_Dish(void)
+{
+	uint8_t a_ui8Encoded[TELEMETRY_FRAME_MAX_ENCODED];
+
+	// the frame is built from the baseline, not a second read
+	Telemetry_Frame_Get_Dish(a_ui16Published_Dish, &g_ui8Published_Mode, &g_ui8Published_Flags);
+
+	g_sPublisher_Counters.ui32Keyframes++;
+
+	return Telemetry_Publisher_Send(a_ui8Encoded, Telemetry_Frame_Build_Dish(a_ui16Published_Dish, g_ui8Published_Mode, g_ui8Published_Flags, a_ui8Encoded));
+}
+
+
+static uint32_t Telemetry_Publisher_Delta_Temperature(void)
+{
+	uint8_t a_ui8Payload[TELEMETRY_FRAME_MAX_PAYLOAD];
+	uint8_t a_ui8Encoded[TELEMETRY_FRAME_MAX_ENCODED];
+	int16_t a_i16Tenths[MAX_TEMPERATURE_PROBES];
+	uint8_t a_ui8Status[MAX_TEMPERATURE_PROBES];
+	Temperature_Snapshot sSnapshot;
+	uint32_t uiChanged = 0;
+	uint32_t i;
+
+	Temperature_Snapshot_Read(&sSnapshot);
+
+	for (i = 0; i < MAX_TEMPERATURE_PROBES; i++)
+	{
+		Telemetry_Frame_Get_Probe(&sSnapshot, i, &a_i16Tenths[i], &a_ui8Status[i]);
+
+		int32_t iDelta = (int32_t) a_i16Tenths[i] - (int32_t) a_i16Published_Tenths[i];
+		if (iDelta < 0) iDelta = -iDelta;
+
+		if ((a_ui8Status[i] != a_ui8Published_Status[i]) || ((uint32_t) iDelta > g_uiPublisher_Temperature_Deadband))
+		{
+			uiChanged++;
+		}
+		else
+		{
+			g_sPublisher_Counters.ui32Channels_Suppressed++;
+		}
+	}
+
+	if (uiChanged == 0) return 0;
+
+	// as big as the full frame?  then send the full one, it resyncs everything too
+	if ((uiChanged * TELEMETRY_DELTA_PROBE_BYTES) >= (MAX_TEMPERATURE_PROBES * TELEMETRY_PROBE_BYTES))
+	{
+		return Telemetry_Publisher_Keyframe_Temperature(&sSnapshot);
+	}
+
+	uint32_t uiIndex = 0;
+
+	a_ui8Payload[uiIndex++] = (uint8_t) uiChanged;
+
+	for (i = 0; i < MAX_TEMPERATURE_PROBES; i++)
+	{
+		int32_t iDelta = (int32_t) a_i16Tenths[i] - (int32_t) a_i16Published_Tenths[i];
+		if (iDelta < 0) iDelta = -iDelta;
+
+		if ((a_ui8Status[i] == a_ui8Published_Status[i]) && ((uint32_t) iDelta <= g_uiPublisher_Temperature_Deadband)) continue;
+
+		a_ui8Payload[uiIndex++] = (uint8_t) i;
+		Telemetry_Frame_Put_16(a_ui8Payload, &uiIndex, (uint16_t) a_i16Tenths[i]);
+		a_ui8Payload[uiIndex++] = a_ui8Status[i];
+
+		a_i16Published_Tenths[i] = a_i16Tenths[i];
+		a_ui8Published_Status[i] = a_ui8Status[i];
+	}
+
+	g_sPublisher_Counters.ui32Delta_Frames++;
+	g_sPublisher_Counters.ui32Channels_Sent += uiChanged;
+
+	return Telemetry_Publisher_Send(a_ui8Encoded, Telemetry_Frame_Encode(TELEMETRY_FRAME_TYPE_TEMPERATURE_DELTA, a_ui8Payload, uiIndex, a_ui8Encoded));
+}
+
+
+static uint32_t Telemetry_Publisher_Delta_Dish(void)
+{
+	uint8_t a_ui8Payload[TELEMETRY_FRAME_MAX_PAYLOAD];
+	uint8_t a_ui8Encoded[TELEMETRY_FRAME_MAX_ENCODED];
+	uint16_t a_ui16Channels[TELEMETRY_DISH_CHANNELS];
+	uint8_t ui8Mode;
+	uint8_t ui8Flags;
+	uint16_t ui16Mask = 0;
+	uint32_t uiChanged = 0;
+	uint32_t i;
+
+	Telemetry_Frame_Get_Dish(a_ui16Channels, &ui8Mode, &ui8Flags);
+
+	for (i = 0; i < TELEMETRY_DISH_CHANNELS; i++)
+	{
+		int32_t iDelta;
+
+		if (i < PUBLISHER_DISH_RESULT_CHANNEL) iDelta = (int32_t) a_ui16Channels[i] - (int32_t) a_ui16Published_Dish[i];
+		else iDelta = (int32_t) (int16_t) a_ui16Channels[i] - (int32_t) (int16_t) a_ui16Published_Dish[i];
+
+		if (iDelta < 0) iDelta = -iDelta;
+
+		if ((uint32_t) iDelta > g_uiPublisher_ADC_Deadband)
+		{
+			ui16Mask |= (uint16_t) (1 << i);
+			uiChanged++;
+		}
+		else
+		{
+			g_sPublisher_Counters.ui32Channels_Suppressed++;
+		}
+	}
+
+	if ((ui16Mask == 0) && (ui8Mode == g_ui8Published_Mode) && (ui8Flags == g_ui8Published_Flags)) return 0;
+
+	uint32_t uiIndex = 0;
+
+	Telemetry_Frame_Put_16(a_ui8Payload, &uiIndex, ui16Mask);
+
+	for (i = 0; i < TELEMETRY_DISH_CHANNELS; i++)
+	{
+		if ((ui16Mask & (1 << i)) == 0) continue;
+
+		Telemetry_Frame_Put_16(a_ui8Payload, &uiIndex, a_ui16Channels[i]);
+		a_ui16Published_Dish[i] = a_ui16Channels[i];
+	}
+
+	a_ui8Payload[uiIndex++] = ui8Mode;
+	a_ui8Payload[uiIndex++] = ui8Flags;
+
+	g_ui8Published_Mode = ui8Mode;
+	g_ui8Published_Flags = ui8Flags;
+
+	g_sPublisher_Counters.ui32Delta_Frames++;
+	g_sPublisher_Counters.ui32Channels_Sent += uiChanged;
+
+	return Telemetry_Publisher_Send(a_ui8Encoded, Telemetry_Frame_Encode(TELEMETRY_FRAME_TYPE_DISH_DELTA, a_ui8Payload, uiIndex, a_ui8Encoded));
+}
+
+
+uint32_t Telemetry_Publisher_Publish(void)
+{
+	// called from the publisher task each JOB_TELEMETRY_PUBLISHER tick... returns the bytes sent
+
+	uint32_t uiNow = I2C_HAL_Get_Ticks();
+
+	if (g_uiPublisher_Keyframe_Due || ((uiNow - g_uiPublisher_Last_Keyframe) >= g_uiPublisher_Keyframe_Ticks))
+	{
+		Temperature_Snapshot sSnapshot;
+
+		g_uiPublisher_Keyframe_Due = false;
+		g_uiPublisher_Last_Keyframe = uiNow;
+
+		Temperature_Snapshot_Read(&sSnapshot);
+
+		return Telemetry_Publisher_Keyframe_Temperature(&sSnapshot) + Telemetry_Publisher_Keyframe_Dish();
+	}
+
+	return Telemetry_Publisher_Delta_Temperature() + Telemetry_Publisher_Delta_Dish();
+}
+
+
+void Telemetry_Publisher_Get_Counters(Telemetry_Publisher_Counters* pCounters)
+{
+	*pCounters = g_sPublisher_Counters;
+}
+
+
+void Telemetry_Publisher_Task(UArg arg0, UArg arg1)
+{
+	while (true)
+	{
+		Semaphore_pend(Semaphore_handle(&g_sPublisher_Semaphore), BIOS_WAIT_FOREVER);
+
+		Telemetry_Publisher_Publish();
+
+		Job_Scheduler_Work_Done(JOB_TELEMETRY_PUBLISHER);
+	}
+}
+
+
+void Telemetry_Publisher_Wake(void)
+{
+	// the JOB_TELEMETRY_PUBLISHER job... runs in the Clock Swi, the task builds and sends the frames
+	Semaphore_post(Semaphore_handle(&g_sPublisher_Semaphore));
+}
+
+
+void Telemetry_Publisher_Start_Task(uint32_t uiPriority)
+{
+	Semaphore_Params sSemaphore_Params;
+	Semaphore_Params_init(&sSemaphore_Params);
+	sSemaphore_Params.mode = Semaphore_Mode_BINARY;
+	Semaphore_construct(&g_sPublisher_Semaphore, 0, &sSemaphore_Params);
+
+	Task_Params sTask_Params;
+	Task_Params_init(&sTask_Params);
+	sTask_Params.stack = a_ui64Publisher_Stack;
+	sTask_Params.stackSize = sizeof(a_ui64Publisher_Stack);
+	sTask_Params.priority = uiPriority;
+	Task_construct(&g_sPublisher_Task, (Task_FuncPtr) Telemetry_Publisher_Task, &sTask_Params, NULL);
+}
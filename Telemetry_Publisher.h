@@ -0,0 +1,40 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Telemetry Publisher - sends only the channels that moved past their deadband, plus periodic keyframes.
+//
+//*****************************************************************************
+
+#ifndef TELEMETRY_PUBLISHER_H_
+#define TELEMETRY_PUBLISHER_H_
+
+#include <stdint.h>
+
+
+#define TELEMETRY_PUBLISHER_PRIORITY		1      // with the event log drain and the datalogger
+#define TELEMETRY_PUBLISHER_TICKS			1000   // ms, the rate the full telemetry used to go out
+
+
+typedef struct
+{
+	uint32_t ui32Keyframes;
+	uint32_t ui32Delta_Frames;
+	uint32_t ui32Channels_Sent;         // probes + dish channels in delta frames
+	uint32_t ui32Channels_Suppressed;   // inside the deadband, not sent
+	uint32_t ui32Bytes;
+} Telemetry_Publisher_Counters;
+
+
+void Telemetry_Publisher_Set_Deadbands(uint32_t uiTemperature_Tenths, uint32_t uiADC_Counts);
+void Telemetry_Publisher_Set_Keyframe_Interval(uint32_t uiTicks);
+void Telemetry_Publisher_Force_Keyframe(void);
+
+uint32_t Telemetry_Publisher_Publish(void);
+
+void Telemetry_Publisher_Get_Counters(Telemetry_Publisher_Counters* pCounters);
+
+void Telemetry_Publisher_Start_Task(uint32_t uiPriority);
+void Telemetry_Publisher_Wake(void);
+
+#endif /* TELEMETRY_PUBLISHER_H_ */
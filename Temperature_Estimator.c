@@ -0,0 +1,352 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// The tank and collector temperatures move slowly and smoothly, yet every probe is read every cycle
+// (or every class period) whether the last few readings already say where it is going or not.  Each
+// read is a channel select, a convert and a scratchpad read on the bus.
+//
+// This keeps a small Kalman filter per probe on the readings Temperature_Get() publishes.  The model is
+// first order... a temperature and a rate, and the filter keeps the variance (P) of the temperature.
+//     predict  - x = x + rate * dt        P = P + Q * dt
+//     read z   - K = P / (P + R)          x = x + K * (z - x)        P = (1 - K) * P
+//                rate = rate + beta * (z - x) / dt, beta = K^2 / (2 - K) (the alpha-beta pairing)
+// R is the probe's quantization at its resolution (step^2 / 12) plus a little noise.  Q, how fast the
+// uncertainty grows, is learned from the readings: the expected squared error of a prediction is
+// P + Q * dt + R, so every reading gives a sample of Q and Q follows them (1/16 a reading).
+// A reading more than 4 sigma from the prediction (a pump started) restarts the filter from that
+// reading with Q raised to what the miss says it was, and asks for another one next cycle to get the
+// rate back.
+//
+// Gating (Temperature_Estimator_Set_Threshold()) is per probe and off by default.  A gated probe is
+// due when its predicted sigma one cycle from now is over its threshold, when the last real reading
+// is ESTIMATOR_MAX_AGE_TICKS old (a probe that is never read can't be known to be alive), or when the
+// control logic asked for one (Temperature_Estimator_Request_Read()).  Probes in the Control class are
+// never gated, the pumps always run on a real reading.
+//
+// A probe that isn't read keeps its last real reading in g_s_Temperature_Telemetry with
+// TEMPERATURE_ERROR_NOT_DUE, the same as a probe that isn't due in its class.  The prediction and its
+// sigma come from Temperature_Estimator_Get().
+//
+// All of it is fixed point.  Temperatures are 1/10 degree C << 8, variances (1/10 degree C)^2 << 8.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <xdc/std.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#include "constants.h"
+#include "globals.h"
+
+#include "Temperature_Snapshot.h"
+#include "Temperature_Estimator.h"
+#include "I2C_HAL.h"
+#include "Static_Footprint.h"
+
+
+
+#define ESTIMATOR_LOOKAHEAD_TICKS			1000   // ms, one cycle... the next chance to read a probe that isn't read now
+#define ESTIMATOR_Q_INITIAL					64     // (1/10 degree C)^2 a second << 8, 0.25
+#define ESTIMATOR_Q_MIN						1
+#define ESTIMATOR_Q_MAX						(100 << 8)
+#define ESTIMATOR_Q_SHIFT					4      // Q moves 1/16 of the way to each sample
+#define ESTIMATOR_P_MAX						(1000 << 8)
+#define ESTIMATOR_RATE_MAX					(10 << 8)    // 1/10 degree C a second << 8, 1 degree a second
+#define ESTIMATOR_RESET_SIGMAS_SQUARED		16
+
+
+typedef struct
+{
+	int32_t i32X;                       // 1/10 degree C << 8
+	int32_t i32Rate;                    // 1/10 degree C a second << 8
+	uint32_t ui32P;                     // (1/10 degree C)^2 << 8
+	uint32_t ui32Q;                     // (1/10 degree C)^2 a second << 8
+	uint32_t ui32Last_Ticks;            // of the last reading
+	uint32_t ui32Reads;
+	uint32_t ui32Held;
+	uint16_t ui16Resets;
+	uint8_t ui8Threshold;               // 1/10 degree C
+	uint8_t ui8Valid;
+	uint8_t ui8Read_Requested;
+} Estimator_Probe;
+
+
+													//  9     10    11    12
+uint32_t a_uiEstimator_R[MAX_TEMP_RESOLUTIONS]		= { 597,  197,  97,   72 };   // step^2 / 12 + 0.25, << 8
+
+Estimator_Probe a_sEstimator[MAX_TEMPERATURE_PROBES];
+
+const uint32_t g_uiTemperature_Estimator_Static_Bytes = sizeof(a_sEstimator);
+STATIC_FOOTPRINT_CHECK((sizeof(a_sEstimator)) <= STATIC_BUDGET_TEMPERATURE_ESTIMATOR, Temperature_Estimator);
+
+
+
+static void Estimator_Predict(const Estimator_Probe* pProbe, uint32_t ui32Ticks, int32_t* pi32X, uint32_t* pui32P)
+{
+	uint32_t uiDelta_Ticks = ui32Ticks - pProbe->ui32Last_Ticks;
+	uint64_t ui64P = pProbe->ui32P + (((uint64_t) pProbe->ui32Q * uiDelta_Ticks) / 1000);
+
+	*pi32X = pProbe->i32X + (int32_t) (((int64_t) pProbe->i32Rate * uiDelta_Ticks) / 1000);
+	*pui32P = (ui64P > ESTIMATOR_P_MAX) ? ESTIMATOR_P_MAX : (uint32_t) ui64P;
+}
+
+
+static void Estimator_Start(Estimator_Probe* pProbe, int32_t i32Z, uint32_t uiR, uint32_t ui32Ticks)
+{
+	pProbe->i32X = i32Z;
+	pProbe->i32Rate = 0;
+	pProbe->ui32P = uiR;
+	pProbe->ui32Last_Ticks = ui32Ticks;
+	pProbe->ui8Valid = true;
+}
+
+
+static void Estimator_Measure(uint32_t uiTemperatureIndex, int16_t i16Tenths, uint32_t uiResolution, uint32_t ui32Ticks)
+{
+	// the filter is worked on a copy taken under the lock and only its own fields are written back...
+	// Set_Threshold() and Request_Read() from other tasks can land in between and aren't lost
+	Estimator_Probe* pProbe = &a_sEstimator[uiTemperatureIndex];
+	Estimator_Probe sOld;
+	Estimator_Probe sNew;
+
+	UInt uiKey = Hwi_disable();
+	sOld = *pProbe;
+	Hwi_restore(uiKey);
+
+	sNew = sOld;
+
+	int32_t i32Z = (int32_t) i16Tenths << 8;
+	uint32_t uiR = a_uiEstimator_R[(uiResolution < MAX_TEMP_RESOLUTIONS) ? uiResolution : TEMP_RESOLUTION_BITS_9];
+	uint32_t uiDelta_Ticks = ui32Ticks - sOld.ui32Last_Ticks;
+
+	sNew.ui32Reads++;
+	sNew.ui8Read_Requested = false;
+
+	if (sOld.ui8Valid == false)
+	{
+		sNew.ui32Q = ESTIMATOR_Q_INITIAL;
+		Estimator_Start(&sNew, i32Z, uiR, ui32Ticks);
+	}
+	else if (uiDelta_Ticks)
+	{
+		int32_t i32X;
+		uint32_t ui32P;
+
+		Estimator_Predict(&sOld, ui32Ticks, &i32X, &ui32P);
+
+		int32_t i32Error = i32Z - i32X;
+		uint64_t ui64S = (uint64_t) ui32P + uiR;
+		uint64_t ui64Error_Squared = ((uint64_t) ((int64_t) i32Error * i32Error)) >> 8;
+
+		if (ui64Error_Squared > ESTIMATOR_RESET_SIGMAS_SQUARED * ui64S)
+		{
+			// the model doesn't explain this reading... start over from it, at least as unsure as this
+			// error says it should have been, and read again next cycle for the rate
+			uint64_t ui64Q = (ui64Error_Squared * 1000) / uiDelta_Ticks;
+
+			if (ui64Q > ESTIMATOR_Q_MAX) ui64Q = ESTIMATOR_Q_MAX;
+			if (sNew.ui32Q < ui64Q) sNew.ui32Q = (uint32_t) ui64Q;
+
+			sNew.ui16Resets++;
+			sNew.ui8Read_Requested = true;
+			Estimator_Start(&sNew, i32Z, uiR, ui32Ticks);
+		}
+		else
+		{
+			// a sample of Q... what this error says the uncertainty grew by, a second
+			int64_t i64Q_Sample = (((int64_t) ui64Error_Squared - sOld.ui32P - uiR) * 1000) / uiDelta_Ticks;
+			int64_t i64Q = (int64_t) sOld.ui32Q + ((i64Q_Sample - (int64_t) sOld.ui32Q) / (1 << ESTIMATOR_Q_SHIFT));
+
+			if (i64Q < ESTIMATOR_Q_MIN) i64Q = ESTIMATOR_Q_MIN;
+			if (i64Q > ESTIMATOR_Q_MAX) i64Q = ESTIMATOR_Q_MAX;
+			sNew.ui32Q = (uint32_t) i64Q;
+
+			// gains, 1 << 16 is 1
+			uint32_t uiK = (uint32_t) (((uint64_t) ui32P << 16) / ui64S);
+			uint32_t uiBeta = (uint32_t) ((((uint64_t) uiK * uiK) >> 16) * 65536 / (131072 - uiK));
+
+			sNew.i32X = i32X + (int32_t) (((int64_t) uiK * i32Error) >> 16);
+			sNew.ui32P = (uint32_t) (((uint64_t) ui32P * uiR) / ui64S);
+
+			int64_t i64Rate = sOld.i32Rate + (((((int64_t) uiBeta * i32Error) >> 16) * 1000) / uiDelta_Ticks);
+
+			if (i64Rate > ESTIMATOR_RATE_MAX) i64Rate = ESTIMATOR_RATE_MAX;
+			if (i64Rate < -ESTIMATOR_RATE_MAX) i64Rate = -ESTIMATOR_RATE_MAX;
+			sNew.i32Rate = (int32_t) i64Rate;
+
+			sNew.ui32Last_Ticks = ui32Ticks;
+		}
+	}
+
+	uiKey = Hwi_disable();
+
+	pProbe->i32X = sNew.i32X;
+	pProbe->i32Rate = sNew.i32Rate;
+	pProbe->ui32P = sNew.ui32P;
+	pProbe->ui32Q = sNew.ui32Q;
+	pProbe->ui32Last_Ticks = sNew.ui32Last_Ticks;
+	pProbe->ui32Reads = sNew.ui32Reads;
+	pProbe->ui16Resets = sNew.ui16Resets;
+	pProbe->ui8Valid = sNew.ui8Valid;
+
+	// this reading answers a request made before it... one made since the copy is for the next reading
+	if ((pProbe->ui8Read_Requested == sOld.ui8Read_Requested) || sNew.ui8Read_Requested)
+	{
+		pProbe->ui8Read_Requested = sNew.ui8Read_Requested;
+	}
+
+	Hwi_restore(uiKey);
+}
+
+
+void Temperature_Estimator_Initialize(void)
+{
+	memset(a_sEstimator, 0, sizeof(a_sEstimator));
+}
+
+
+uint32_t Temperature_Estimator_Set_Threshold(uint32_t uiTemperatureIndex, uint32_t uiThreshold_Tenths)
+{
+	// ESTIMATOR_THRESHOLD_OFF and the probe is read on its class period again
+	if (uiTemperatureIndex >= MAX_TEMPERATURE_PROBES) return ESTIMATOR_ERR_INVALID;
+	if (uiThreshold_Tenths > ESTIMATOR_MAX_THRESHOLD) return ESTIMATOR_ERR_INVALID;
+
+	a_sEstimator[uiTemperatureIndex].ui8Threshold = (uint8_t) uiThreshold_Tenths;
+
+	return 0;
+}
+
+
+void Temperature_Estimator_Update(void)
+{
+	// takes the readings of the pass that was just published, a probe that wasn't read only has its
+	// uncertainty grow
+	Temperature_Snapshot sSnapshot;
+	uint32_t i;
+
+	if (Temperature_Snapshot_Read(&sSnapshot) == 0) return;
+
+	for (i = 0; i < MAX_TEMPERATURE_PROBES; i++)
+	{
+		if (sSnapshot.a_sProbe[i].ui8Valid == false) continue;
+		if (sSnapshot.a_sProbe[i].ui32Error_Flag != NO_ERRORS) continue;   // holding the last good one, or not due
+
+		Estimator_Measure(i, sSnapshot.a_sProbe[i].i16Tenths_C, sSnapshot.a_sProbe[i].ui8Resolution, sSnapshot.ui32Ticks);
+	}
+}
+
+
+uint32_t Temperature_Estimator_Gates(uint32_t uiTemperatureIndex)
+{
+	// true when the estimator decides when this probe is read
+	if (uiTemperatureIndex >= MAX_TEMPERATURE_PROBES) return false;
+
+	return a_sEstimator[uiTemperatureIndex].ui8Threshold != ESTIMATOR_THRESHOLD_OFF;
+}
+
+
+uint32_t Temperature_Estimator_Needs_Read(uint32_t uiTemperatureIndex, uint32_t ui32Ticks)
+{
+	// ui32Ticks is now... is the prediction still good enough a cycle from now?
+	Estimator_Probe* pProbe;
+	int32_t i32X;
+	uint32_t ui32P;
+
+	if (uiTemperatureIndex >= MAX_TEMPERATURE_PROBES) return true;
+
+	pProbe = &a_sEstimator[uiTemperatureIndex];
+
+	if ((pProbe->ui8Valid == false) || pProbe->ui8Read_Requested) return true;
+
+	ui32Ticks += ESTIMATOR_LOOKAHEAD_TICKS;
+
+	if ((ui32Ticks - pProbe->ui32Last_Ticks) >= ESTIMATOR_MAX_AGE_TICKS) return true;
+
+	Estimator_Predict(pProbe, ui32Ticks, &i32X, &ui32P);
+
+	return ui32P > (((uint32_t) pProbe->ui8Threshold * pProbe->ui8Threshold) << 8);
+}
+
+
+void Temperature_Estimator_Held(uint32_t uiTemperatureIndex)
+{
+	// the temperature task didn't read this probe, the prediction was good enough
+	if (uiTemperatureIndex >= MAX_TEMPERATURE_PROBES) return;
+
+	a_sEstimator[uiTemperatureIndex].ui32Held++;
+}
+
+
+void Temperature_Estimator_Request_Read(uint32_t uiTemperatureIndex)
+{
+	// the control logic wants a real reading of this probe next cycle, whatever the prediction says
+	if (uiTemperatureIndex >= MAX_TEMPERATURE_PROBES) return;
+
+	a_sEstimator[uiTemperatureIndex].ui8Read_Requested = true;
+}
+
+
+static uint32_t Estimator_Square_Root(uint32_t uiValue)
+{
+	uint32_t uiRoot = 0;
+	uint32_t uiBit = 1UL << 30;
+
+	while (uiBit > uiValue) uiBit >>= 2;
+
+	while (uiBit)
+	{
+		if (uiValue >= uiRoot + uiBit)
+		{
+			uiValue -= uiRoot + uiBit;
+			uiRoot = (uiRoot >> 1) + uiBit;
+		}
+		else
+		{
+			uiRoot >>= 1;
+		}
+
+		uiBit >>= 2;
+	}
+
+	return uiRoot;
+}
+
+
+uint32_t Temperature_Estimator_Get(uint32_t uiTemperatureIndex, Temperature_Estimate* pEstimate)
+{
+	// any task... returns false until the probe has had a reading
+	Estimator_Probe sProbe;
+	int32_t i32X;
+	uint32_t ui32P;
+
+	if (uiTemperatureIndex >= MAX_TEMPERATURE_PROBES) return false;
+
+	UInt uiKey = Hwi_disable();
+	sProbe = a_sEstimator[uiTemperatureIndex];
+	Hwi_restore(uiKey);
+
+	memset(pEstimate, 0, sizeof(Temperature_Estimate));
+
+	pEstimate->ui32Threshold = sProbe.ui8Threshold;
+	pEstimate->ui32Reads = sProbe.ui32Reads;
+	pEstimate->ui32Held = sProbe.ui32Held;
+	pEstimate->ui32Resets = sProbe.ui16Resets;
+	pEstimate->ui32Valid = sProbe.ui8Valid;
+
+	if (sProbe.ui8Valid == false) return false;
+
+	Estimator_Predict(&sProbe, I2C_HAL_Get_Ticks(), &i32X, &ui32P);
+
+	pEstimate->i16Tenths_C = (int16_t) ((i32X >= 0) ? ((i32X + 128) >> 8) : -((-i32X + 128) >> 8));
+	pEstimate->ui16Sigma_Tenths = (uint16_t) ((Estimator_Square_Root(ui32P) + 8) >> 4);
+	pEstimate->i32Rate = (sProbe.i32Rate * 600) / 256;   // 1/10 a second to 1/100 a minute
+
+	return true;
+}
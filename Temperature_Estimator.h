@@ -0,0 +1,48 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Temperature Estimator - per probe fixed point Kalman filter that predicts each temperature and how
+// sure it is, so a slow probe is only read when the prediction isn't good enough.
+//
+//*****************************************************************************
+
+#ifndef TEMPERATURE_ESTIMATOR_H_
+#define TEMPERATURE_ESTIMATOR_H_
+
+#include <stdint.h>
+
+
+#define ESTIMATOR_THRESHOLD_OFF				0      // the probe is read on its class period, the default
+#define ESTIMATOR_MAX_THRESHOLD				100    // 1/10 degree C
+#define ESTIMATOR_MAX_AGE_TICKS				8000   // ms, a real read at least this often... under TELEMETRY_STALE_TICKS
+
+// Error Codes
+#define ESTIMATOR_ERR_INVALID				19001
+
+
+typedef struct
+{
+	int16_t i16Tenths_C;                // the prediction, now
+	uint16_t ui16Sigma_Tenths;          // its standard deviation, 1/10 degree C
+	int32_t i32Rate;                    // 1/100 degree C per minute
+	uint32_t ui32Threshold;             // 1/10 degree C, ESTIMATOR_THRESHOLD_OFF when it doesn't gate reads
+	uint32_t ui32Reads;                 // readings the filter took
+	uint32_t ui32Held;                  // cycles the probe wasn't read because the prediction was good enough
+	uint32_t ui32Resets;                // readings the model couldn't explain, the filter started over
+	uint32_t ui32Valid;                 // false until the first reading
+} Temperature_Estimate;
+
+
+void Temperature_Estimator_Initialize(void);
+uint32_t Temperature_Estimator_Set_Threshold(uint32_t uiTemperatureIndex, uint32_t uiThreshold_Tenths);
+
+void Temperature_Estimator_Update(void);
+uint32_t Temperature_Estimator_Gates(uint32_t uiTemperatureIndex);
+uint32_t Temperature_Estimator_Needs_Read(uint32_t uiTemperatureIndex, uint32_t ui32Ticks);
+void Temperature_Estimator_Held(uint32_t uiTemperatureIndex);
+void Temperature_Estimator_Request_Read(uint32_t uiTemperatureIndex);
+
+uint32_t Temperature_Estimator_Get(uint32_t uiTemperatureIndex, Temperature_Estimate* pEstimate);
+
+#endif /* TEMPERATURE_ESTIMATOR_H_ */
@@ -0,0 +1,359 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Only the latest reading of each probe is kept in g_s_Temperature_Telemetry.  Anything that wants a
+// trend (pump differentials, diagnostics) had to keep its own.  This module keeps a short history of
+// every probe over three windows (1 minute, 15 minutes and 1 hour by default) and keeps min, max, mean
+// and slope of each window up to date as samples arrive, so a query never rescans anything.
+//
+// Each window holds HISTORY_SAMPLES samples.  A sample is the average of the readings that came in
+// during one sample period (window / HISTORY_SAMPLES... 2s, 30s and 2 minutes by default).
+//
+// Memory is fixed.  The samples are stored as 1 byte deltas (1/10 degree) from the previous sample, with
+// the oldest and newest values kept whole.  A jump of more than 12.7 degrees in one sample period is
+// clamped... that is a bad reading, not a temperature change.  The min / max queues hold 1 byte slots
+// into the deltas, not copies of the samples, with only the front's value kept whole.  A window is
+// 124 bytes, 5952 for all 16 probes x 3 windows.
+//
+// Per window, with n samples in it:
+//     mean   - running sum of the samples
+//     min    - monotonic queue (rising)  the front is the minimum, samples that can never be the minimum
+//     max    - monotonic queue (falling) again are dropped as new samples arrive
+//     slope  - least squares over the n equally spaced samples, from the running sums Sy and Sky
+//              (k = 0 for the oldest).  When the oldest sample y0 drops out and y arrives:
+//                  Sky = Sky - Sy + y0 + (n - 1) * y
+//                  Sy  = Sy  - y0 + y
+// Query is O(1).  Add and drop are O(1) apart from the queues, which get a slot's value back by walking
+// the deltas from the newest sample (push) or the oldest (expire)... at most HISTORY_SAMPLES adds each.
+//
+// Temperature_History_Update() is called after each Temperature_Get() pass and takes its readings from
+// the published Temperature_Snapshot.  A probe without a good reading in that pass adds nothing.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <xdc/std.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#include "constants.h"
+#include "globals.h"
+
+#include "Temperature_Snapshot.h"
+#include "Temperature_History.h"
+#include "Static_Footprint.h"
+
+
+
+#define HISTORY_DELTA_MAX					127    // 1/10 degree per sample
+
+
+typedef struct
+{
+	uint8_t a_ui8Slot[HISTORY_SAMPLES];  // slots of a_i8Delta, oldest first
+	uint8_t ui8Front;
+	uint8_t ui8Count;
+	int16_t i16Front;                   // the front sample's value, the answer to a query
+} History_Queue;
+
+
+typedef struct
+{
+	// the sample being built
+	int32_t i32Bucket_Sum;
+	uint32_t ui32Bucket_Count;
+	uint32_t ui32Bucket_Start;
+
+	// the samples
+	int8_t a_i8Delta[HISTORY_SAMPLES];  // each sample less the one before it
+	uint8_t ui8Oldest;                  // slot of the oldest sample
+	uint8_t ui8Count;
+	int16_t i16Oldest;
+	int16_t i16Newest;
+
+	// the aggregates
+	int32_t i32Sum;                     // Sy
+	int32_t i32Weighted_Sum;            // Sky
+	History_Queue sMin;
+	History_Queue sMax;
+} History_Window;
+
+
+// default windows, in ms
+uint32_t a_uiHistory_Window_Ticks[HISTORY_MAX_WINDOWS] = { 60000, 900000, 3600000 };
+uint32_t a_uiHistory_Sample_Ticks[HISTORY_MAX_WINDOWS] = { 60000 / HISTORY_SAMPLES, 900000 / HISTORY_SAMPLES, 3600000 / HISTORY_SAMPLES };
+
+History_Window a_sHistory[MAX_TEMPERATURE_PROBES][HISTORY_MAX_WINDOWS];
+
+const uint32_t g_uiTemperature_History_Static_Bytes = sizeof(a_sHistory);
+STATIC_FOOTPRINT_CHECK((sizeof(a_sHistory)) <= STATIC_BUDGET_TEMPERATURE_HISTORY, Temperature_History);
+
+
+
+static void History_Queue_Push(History_Queue* pQueue, const History_Window* pWindow, uint32_t uiSlot, int16_t i16Value, uint32_t uiKeep_Minimum)
+{
+	// the sample in uiSlot was just added... drop everything at the back that it beats, it can never be
+	// the answer again.  The back's value comes from walking the deltas back from the new sample.
+	uint32_t uiWalk = uiSlot;
+	int32_t i32Walk_Value = i16Value;
+
+	while (pQueue->ui8Count)
+	{
+		uint32_t uiBack = pQueue->a_ui8Slot[(pQueue->ui8Front + pQueue->ui8Count - 1) % HISTORY_SAMPLES];
+
+		while (uiWalk != uiBack)
+		{
+			i32Walk_Value -= pWindow->a_i8Delta[uiWalk];
+			uiWalk = (uiWalk + HISTORY_SAMPLES - 1) % HISTORY_SAMPLES;
+		}
+
+		if (uiKeep_Minimum && (i32Walk_Value < i16Value)) break;
+		if (!uiKeep_Minimum && (i32Walk_Value > i16Value)) break;
+
+		pQueue->ui8Count--;
+	}
+
+	pQueue->a_ui8Slot[(pQueue->ui8Front + pQueue->ui8Count) % HISTORY_SAMPLES] = (uint8_t) uiSlot;
+	pQueue->ui8Count++;
+
+	if (pQueue->ui8Count == 1) pQueue->i16Front = i16Value;
+}
+
+
+static void History_Queue_Expire(History_Queue* pQueue, const History_Window* pWindow, uint32_t uiSlot)
+{
+	// the sample in uiSlot just left the window, ui8Oldest / i16Oldest are already the next one
+	if ((pQueue->ui8Count == 0) || (pQueue->a_ui8Slot[pQueue->ui8Front] != uiSlot)) return;
+
+	pQueue->ui8Front = (pQueue->ui8Front + 1) % HISTORY_SAMPLES;
+	pQueue->ui8Count--;
+
+	if (pQueue->ui8Count == 0) return;
+
+	// the new front's value, walking the deltas up from the oldest sample
+	uint32_t uiWalk = pWindow->ui8Oldest;
+	int32_t i32Walk_Value = pWindow->i16Oldest;
+
+	while (uiWalk != pQueue->a_ui8Slot[pQueue->ui8Front])
+	{
+		uiWalk = (uiWalk + 1) % HISTORY_SAMPLES;
+		i32Walk_Value += pWindow->a_i8Delta[uiWalk];
+	}
+
+	pQueue->i16Front = (int16_t) i32Walk_Value;
+}
+
+
+static void History_Window_Push(History_Window* pWindow, int16_t i16Value)
+{
+	uint32_t uiSlot;
+
+	if (pWindow->ui8Count == 0)
+	{
+		uiSlot = 0;
+
+		pWindow->ui8Oldest = 0;
+		pWindow->i16Oldest = i16Value;
+		pWindow->i16Newest = i16Value;
+		pWindow->a_i8Delta[0] = 0;
+		pWindow->ui8Count = 1;
+
+		pWindow->i32Sum = i16Value;
+		pWindow->i32Weighted_Sum = 0;
+	}
+	else
+	{
+		int32_t iDelta = (int32_t) i16Value - (int32_t) pWindow->i16Newest;
+
+		if (iDelta > HISTORY_DELTA_MAX) iDelta = HISTORY_DELTA_MAX;
+		if (iDelta < -HISTORY_DELTA_MAX) iDelta = -HISTORY_DELTA_MAX;
+
+		// the stored series is what the aggregates are built from
+		i16Value = pWindow->i16Newest + (int16_t) iDelta;
+
+		if (pWindow->ui8Count < HISTORY_SAMPLES)
+		{
+			uiSlot = (pWindow->ui8Oldest + pWindow->ui8Count) % HISTORY_SAMPLES;
+
+			pWindow->i32Weighted_Sum += (int32_t) pWindow->ui8Count * i16Value;
+			pWindow->i32Sum += i16Value;
+			pWindow->ui8Count++;
+		}
+		else
+		{
+			// full... the oldest drops out, the new sample takes its slot
+			int16_t i16Dropped = pWindow->i16Oldest;
+
+			uiSlot = pWindow->ui8Oldest;
+			pWindow->ui8Oldest = (pWindow->ui8Oldest + 1) % HISTORY_SAMPLES;
+			pWindow->i16Oldest = i16Dropped + pWindow->a_i8Delta[pWindow->ui8Oldest];
+
+			pWindow->i32Weighted_Sum = pWindow->i32Weighted_Sum - pWindow->i32Sum + i16Dropped + ((HISTORY_SAMPLES - 1) * (int32_t) i16Value);
+			pWindow->i32Sum = pWindow->i32Sum - i16Dropped + i16Value;
+
+			History_Queue_Expire(&pWindow->sMin, pWindow, uiSlot);
+			History_Queue_Expire(&pWindow->sMax, pWindow, uiSlot);
+		}
+
+		pWindow->a_i8Delta[uiSlot] = (int8_t) iDelta;
+		pWindow->i16Newest = i16Value;
+	}
+
+	History_Queue_Push(&pWindow->sMin, pWindow, uiSlot, i16Value, true);
+	History_Queue_Push(&pWindow->sMax, pWindow, uiSlot, i16Value, false);
+}
+
+
+void Temperature_History_Initialize(void)
+{
+	memset(a_sHistory, 0, sizeof(a_sHistory));
+}
+
+
+void Temperature_History_Set_Window(uint32_t uiWindow, uint32_t uiWindow_Ticks)
+{
+	// changes the span of one window for every probe... that window starts over
+	if (uiWindow >= HISTORY_MAX_WINDOWS) return;
+	if (uiWindow_Ticks < HISTORY_SAMPLES) return;
+
+	uint32_t i;
+
+	UInt uiKey = Hwi_disable();
+
+	a_uiHistory_Window_Ticks[uiWindow] = uiWindow_Ticks;
+	a_uiHistory_Sample_Ticks[uiWindow] = uiWindow_Ticks / HISTORY_SAMPLES;
+
+	for (i = 0; i < MAX_TEMPERATURE_PROBES; i++)
+	{
+		memset(&a_sHistory[i][uiWindow], 0, sizeof(History_Window));
+	}
+
+	Hwi_restore(uiKey);
+}
+
+
+void Temperature_History_Add(uint32_t uiTemperatureIndex, int16_t i16Tenths, uint32_t ui32Ticks)
+{
+	if (uiTemperatureIndex >= MAX_TEMPERATURE_PROBES) return;
+
+	uint32_t uiWindow;
+
+	for (uiWindow = 0; uiWindow < HISTORY_MAX_WINDOWS; uiWindow++)
+	{
+		History_Window* pWindow = &a_sHistory[uiTemperatureIndex][uiWindow];
+
+		uint32_t uiSample_Ticks = a_uiHistory_Sample_Ticks[uiWindow];
+
+		if (pWindow->ui32Bucket_Count && ((ui32Ticks - pWindow->ui32Bucket_Start) >= uiSample_Ticks))
+		{
+			// the sample period is over, its average becomes a sample
+			int32_t iAverage = pWindow->i32Bucket_Sum / (int32_t) pWindow->ui32Bucket_Count;
+
+			UInt uiKey = Hwi_disable();
+			History_Window_Push(pWindow, (int16_t) iAverage);
+			Hwi_restore(uiKey);
+
+			pWindow->i32Bucket_Sum = 0;
+			pWindow->ui32Bucket_Count = 0;
+
+			// stay on the sample grid so the samples are evenly spaced... unless readings stopped for a while
+			pWindow->ui32Bucket_Start += uiSample_Ticks;
+			if ((ui32Ticks - pWindow->ui32Bucket_Start) >= uiSample_Ticks) pWindow->ui32Bucket_Start = ui32Ticks;
+		}
+
+		if ((pWindow->ui32Bucket_Count == 0) && (pWindow->ui8Count == 0))
+		{
+			pWindow->ui32Bucket_Start = ui32Ticks;
+		}
+
+		pWindow->i32Bucket_Sum += i16Tenths;
+		pWindow->ui32Bucket_Count++;
+	}
+}
+
+
+void Temperature_History_Update(void)
+{
+	// takes the readings of the pass that was just published
+
+	Temperature_Snapshot sSnapshot;
+	uint32_t i;
+
+	if (Temperature_Snapshot_Read(&sSnapshot) == 0) return;
+
+	for (i = 0; i < MAX_TEMPERATURE_PROBES; i++)
+	{
+		if (sSnapshot.a_sProbe[i].ui8Valid == false) continue;
+		if (sSnapshot.a_sProbe[i].ui32Error_Flag != NO_ERRORS) continue;   // holding the last good one, or not due
+
+		Temperature_History_Add(i, sSnapshot.a_sProbe[i].i16Tenths_C, sSnapshot.ui32Ticks);
+	}
+}
+
+
+uint32_t Temperature_History_Get_Stats(uint32_t uiTemperatureIndex, uint32_t uiWindow, Temperature_History_Stats* pStats)
+{
+	// returns false if the window has no samples yet
+
+	if (uiTemperatureIndex >= MAX_TEMPERATURE_PROBES) return false;
+	if (uiWindow >= HISTORY_MAX_WINDOWS) return false;
+
+	History_Window* pWindow = &a_sHistory[uiTemperatureIndex][uiWindow];
+
+	UInt uiKey = Hwi_disable();
+
+	int32_t n = pWindow->ui8Count;
+
+	if (n == 0)
+	{
+		Hwi_restore(uiKey);
+		return false;
+	}
+
+	int32_t i32Sum = pWindow->i32Sum;
+	int32_t i32Weighted_Sum = pWindow->i32Weighted_Sum;
+
+	pStats->ui32Samples = n;
+	pStats->i16Newest = pWindow->i16Newest;
+	pStats->i16Min = pWindow->sMin.i16Front;
+	pStats->i16Max = pWindow->sMax.i16Front;
+
+	uint32_t uiSample_Ticks = a_uiHistory_Sample_Ticks[uiWindow];
+
+	Hwi_restore(uiKey);
+
+	pStats->i16Mean = (int16_t) ((i32Sum + ((i32Sum >= 0) ? (n / 2) : -(n / 2))) / n);
+
+	pStats->i32Slope = 0;
+
+	if (n >= 2)
+	{
+		// slope = (n Sky - Sk Sy) / (n Skk - Sk Sk)  in 1/10 degree per sample period
+		int64_t i64Sk = ((int64_t) n * (n - 1)) / 2;
+		int64_t i64Skk = ((int64_t) (n - 1) * n * (2 * n - 1)) / 6;
+		int64_t i64Numerator = ((int64_t) n * i32Weighted_Sum) - (i64Sk * i32Sum);
+		int64_t i64Denominator = ((int64_t) n * i64Skk) - (i64Sk * i64Sk);
+
+		// 1/10 degree per period -> 1/100 degree per minute
+		pStats->i32Slope = (int32_t) ((i64Numerator * 600000) / (i64Denominator * uiSample_Ticks));
+	}
+
+	return true;
+}
+
+
+int32_t Temperature_History_Get_Rate(uint32_t uiTemperatureIndex, uint32_t uiWindow)
+{
+	// 1/100 degree C per minute, 0 if there isn't enough history yet
+	Temperature_History_Stats sStats;
+
+	if (Temperature_History_Get_Stats(uiTemperatureIndex, uiWindow, &sStats) == false) return 0;
+
+	return sStats.i32Slope;
+}
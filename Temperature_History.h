@@ -0,0 +1,44 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Temperature History - per probe trend windows with min / max / mean / slope kept as samples arrive.
+//
+//*****************************************************************************
+
+#ifndef TEMPERATURE_HISTORY_H_
+#define TEMPERATURE_HISTORY_H_
+
+#include <stdint.h>
+
+
+// Windows
+#define HISTORY_WINDOW_1_MINUTE				0
+#define HISTORY_WINDOW_15_MINUTES			1
+#define HISTORY_WINDOW_1_HOUR				2
+#define HISTORY_MAX_WINDOWS					3
+
+#define HISTORY_SAMPLES						30     // samples kept in each window
+
+
+typedef struct
+{
+	int16_t i16Min;                     // 1/10 degree C
+	int16_t i16Max;
+	int16_t i16Mean;
+	int16_t i16Newest;
+	int32_t i32Slope;                   // 1/100 degree C per minute
+	uint32_t ui32Samples;               // in the window right now, up to HISTORY_SAMPLES
+} Temperature_History_Stats;
+
+
+void Temperature_History_Initialize(void);
+void Temperature_History_Set_Window(uint32_t uiWindow, uint32_t uiWindow_Ticks);
+
+void Temperature_History_Add(uint32_t uiTemperatureIndex, int16_t i16Tenths, uint32_t ui32Ticks);
+void Temperature_History_Update(void);
+
+uint32_t Temperature_History_Get_Stats(uint32_t uiTemperatureIndex, uint32_t uiWindow, Temperature_History_Stats* pStats);
+int32_t Temperature_History_Get_Rate(uint32_t uiTemperatureIndex, uint32_t uiWindow);
+
+#endif /* TEMPERATURE_HISTORY_H_ */
@@ -42,6 +42,59 @@
 // I did this in order to avoid potential power surges and not being able to control
 // current to the chip.  Therefore, it was easier to ground the chip to 0 (or 0x18) and use two ports.
 //
+// Probe Health:
+// A missing or shorted probe used to cost seconds every cycle (600 busy polls, 10000 config polls)
+// because every probe was retried on every Temperature_Initiate().  Each probe now has a health state.
+//    Healthy     - normal polling limits
+//    Suspect     - it failed once, short polling limits
+//    Quarantined - it failed again, it is skipped and only re-probed after a back off that doubles
+//                  each time the re-probe fails (TEMPERATURE_BACKOFF_MIN_CYCLES to _MAX_CYCLES)
+// There is also a time budget for each pass.  Once a pass is over budget, only Healthy probes are
+// worked on, the others wait for the next cycle.
+// A failed probe keeps its last good reading in g_s_Temperature_Telemetry (uiErrorFlag says it failed)
+// and Temperature_Get_Age() says how old that reading is.
+//
+// Probe Classes:
+// Every probe is in a class (Temperature_Set_Probe_Class()) and each class has a period in cycles and
+// a resolution (Temperature_Set_Class()).
+//    Normal   - every cycle, the global resolution (the default for every probe)
+//    Control  - every cycle, the global resolution... what the pumps run on, never degraded
+//    Tracking - every PROBE_TRACKING_PERIOD_CYCLES cycles, 9 bits (Ground Temp, Outside Air Temp...)
+// A probe is due when (cycle + probe) % period is 0, so the probes of a class are spread over the cycles
+// instead of all landing on the same one.  A probe that isn't due costs no bus time, it keeps its last
+// good reading and uiErrorFlag TEMPERATURE_ERROR_NOT_DUE.  A probe without a reading yet is always due.
+// When acquisitions overrun the period, Cycle_Budget.c degrades and multiplies the tracking period
+// (Cycle_Budget_Tracking_Divisor()).
+// The end of Temperature_Get() tells the Job Scheduler the one second job's work is done, so its
+// Work Overruns count the cycles that ran into the next one.
+//
+// Probe Resolution:
+// Every probe has its own resolution in a_uiProbe_Resolution[], what it is configured to, checked
+// against in the scratchpad and decoded with.  It comes from the probe's own setting
+// (Temperature_Set_Probe_Resolution()), else its class, else the global g_uiResolutionIndex.  A probe
+// whose resolution changes is configured again.  The hold is no longer the global resolution's...
+// Temperature_Initiate() sets it to the conversion time of the finest resolution that is due that
+// cycle, so a 12 bit probe read every 8th cycle only costs 750ms on that cycle.  A resolution whose
+// hold doesn't fit the cycle budget (Cycle_Budget_Check_Settings()) is refused.  The global one is the
+// EEPROM setting and isn't refused outright, Temperature_Set_Resolution() keeps the setting in
+// g_uiResolution_Setting and runs at Temperature_Resolution_Fallback(), the highest one under it that
+// fits.  It is called from the console and the other tasks, and the temperature event ring only takes
+// this task's pushes, so the fall back is only flagged there and Temperature_Initiate() logs it.
+//
+// Probe Estimator:
+// A probe with an estimator threshold (Temperature_Estimator_Set_Threshold()) isn't read on its class
+// period, Temperature_Estimator.c predicts it from its readings and it is due when the prediction's
+// sigma would be over the threshold by next cycle, or its last reading is getting old, or the control
+// logic asked for one.  Control class probes ignore the threshold.
+//
+// Absent Probes:
+// A channel with nothing on it (no presence pulse on the 1-Wire reset, 2005 in Clear_1_Wire_Busy_Status())
+// is remembered in a_uiProbe_Absent[] and not a failing probe... no quarantine.  The main cycle doesn't
+// touch it, it has uiErrorFlag TEMPERATURE_ERROR_ABSENT.  Each Temperature_Initiate() rediscovers one
+// empty channel, round robin, only when the pass is inside its budget, so a probe plugged in shows up
+// within a few cycles and a partly populated board doesn't pay for its empty channels.  A probe that
+// comes back is configured again, it is at its power on resolution.
+//
 //*****************************************************************************
 
 #include <stdbool.h>
@@ -108,6 +161,17 @@
 #include "Task_Setups.h"
 #include "Console_Interface.h"
 #include "Semaphore_Setup.h"
+#include "I2C_Scheduler.h"
+#include "I2C_HAL.h"
+#include "Event_Log.h"
+#include "Temperature_Snapshot.h"
+#include "Temperature_History.h"
+#include "Temperature_Estimator.h"
+#include "Job_Scheduler.h"
+#include "Boot_Timing.h"
+#include "Perf_Instrument.h"
+#include "Acquisition_Kernels.h"
+#include "Cycle_Budget.h"
 
 
 
@@ -151,23 +215,95 @@
 #define I2C_MASTER_INTERNAL_TIMEOUT 		16384
 
 
+// Probe Health
+#define PROBE_HEALTHY						0
+#define PROBE_SUSPECT						1
+#define PROBE_QUARANTINED					2
+#define MAX_PROBE_HEALTH_STATES				3
+
+#define PROBE_QUARANTINE_FAILURES			2      // consecutive failures before a probe is quarantined
+#define TEMPERATURE_BACKOFF_MIN_CYCLES		2
+#define TEMPERATURE_BACKOFF_MAX_CYCLES		256
+#define TEMPERATURE_PASS_BUDGET_TICKS		250    // ms for each Temperature_Initiate() / Temperature_Get() pass
+#define TEMPERATURE_CONFIG_MAX_POLLS		100    // was 10000
+#define TEMPERATURE_AGE_NEVER				0xFFFFFFFF
+#define TEMPERATURE_ROM_READS_PER_CHIP		2      // each pass, ROM codes aren't needed for a reading, spread them out
+
+// Probe Classes
+#define PROBE_CLASS_NORMAL					0
+#define PROBE_CLASS_CONTROL					1
+#define PROBE_CLASS_TRACKING				2
+#define MAX_PROBE_CLASSES					3
+
+#define PROBE_TRACKING_PERIOD_CYCLES		8      // a held reading is still under TELEMETRY_STALE_TICKS
+#define PROBE_MAX_PERIOD_CYCLES				3600
+#define TEMP_RESOLUTION_GLOBAL				0xFF   // the class follows g_uiResolutionIndex
+#define TEMP_RESOLUTION_CLASS				0xFE   // the probe follows its class
+
+
 //uint8_t a_ui8_Slave_Addresses[MAX_TEMPERATURE_PROBES]    =      {0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x19, 0x19, 0x19, 0x19, 0x19, 0x19, 0x19, 0x19};
 uint8_t a_ui8_Slave_Addresses[MAX_TEMPERATURE_PROBES]      = {0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18};
 uint8_t a_ui8_Write_Channel_Array[MAX_TEMPERATURE_PROBES]  = {0xF0, 0xE1, 0xD2, 0xC3, 0xB4, 0xA5, 0x96, 0x87, 0xF0, 0xE1, 0xD2, 0xC3, 0xB4, 0xA5, 0x96, 0x87};
 uint8_t a_ui8_Verify_Channel_Array[MAX_TEMPERATURE_PROBES] = {0xB8, 0xB1, 0xAA, 0xA3, 0x9C, 0x95, 0x8E, 0x87, 0xB8, 0xB1, 0xAA, 0xA3, 0x9C, 0x95, 0x8E, 0x87};
 
-I2C_Handle a_h_I2C_Handle[MAX_TEMPERATURE_PROBES]          = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+uint32_t a_ui_I2C_Bus[MAX_TEMPERATURE_PROBES]               = {I2C_BUS_TEMPERATURE_0_7,  I2C_BUS_TEMPERATURE_0_7,  I2C_BUS_TEMPERATURE_0_7,  I2C_BUS_TEMPERATURE_0_7,
+															  I2C_BUS_TEMPERATURE_0_7,  I2C_BUS_TEMPERATURE_0_7,  I2C_BUS_TEMPERATURE_0_7,  I2C_BUS_TEMPERATURE_0_7,
+															  I2C_BUS_TEMPERATURE_8_15, I2C_BUS_TEMPERATURE_8_15, I2C_BUS_TEMPERATURE_8_15, I2C_BUS_TEMPERATURE_8_15,
+															  I2C_BUS_TEMPERATURE_8_15, I2C_BUS_TEMPERATURE_8_15, I2C_BUS_TEMPERATURE_8_15, I2C_BUS_TEMPERATURE_8_15};
+
+// the scratchpad reads in Temperature_Get() drop to I2C_PRIORITY_BULK so ADC reads can go ahead of them
+uint32_t g_uiTemperature_I2C_Priority = I2C_PRIORITY_NORMAL;
 
 													  //9     10    11    12
 uint32_t a_uiConfigResBits[MAX_TEMP_RESOLUTIONS]  	= {0x1F, 0x3F, 0x5F, 0x7F};
 uint32_t a_uiResolutionMask[MAX_TEMP_RESOLUTIONS] 	= {0x08, 0x0C, 0x0E, 0x0F};
-uint32_t g_uiResolutionIndex;
+uint32_t g_uiResolutionIndex;            // what the global probes run at
+uint32_t g_uiResolution_Setting;         // what was asked for (the EEPROM setting), over the budget it's higher
+volatile uint32_t g_uiResolution_Refused;  // set by Temperature_Set_Resolution(), logged by the next Temperature_Initiate()
 
 uint32_t g_uiTemperatureIndex;
 uint32_t g_ui32SrcClock;
 uint32_t g_uiLoggingFlag;
 uint32_t g_uiPresensePulseDetected;
 
+// A busy poll is the g_ui_0001_Second wait (100 us, not 1 ms) and a one byte status read, about 150 us at
+// 400 kHz and 300 us at 100 kHz, with one more wait before the first poll.  Healthy gives up after 3 - 6 ms,
+// well past a 1.15 ms reset or a 0.56 ms byte.  3 polls can't cover a reset, which is why a reset always
+// gets the Healthy limit (Clear_1_Wire_Busy_Status()).  Cycle_Budget.c and tools/host use the same 100 us.
+														//  Healthy  Suspect  Quarantined
+uint32_t a_uiBusy_Poll_Limit[MAX_PROBE_HEALTH_STATES]    = { 20,      3,       3 };   // polls
+
+uint32_t a_uiProbe_Health[MAX_TEMPERATURE_PROBES];
+uint32_t a_uiProbe_Failures[MAX_TEMPERATURE_PROBES];
+uint32_t a_uiProbe_Backoff[MAX_TEMPERATURE_PROBES];
+uint32_t a_uiProbe_Retry_Cycle[MAX_TEMPERATURE_PROBES];
+uint32_t a_uiProbe_Last_Good_Ticks[MAX_TEMPERATURE_PROBES];
+uint32_t a_uiProbe_Has_Reading[MAX_TEMPERATURE_PROBES];
+uint32_t a_uiProbe_Absent[MAX_TEMPERATURE_PROBES];          // no presence pulse on the channel, only rediscovery tries it
+uint32_t g_uiProbe_Rediscover_Index = MAX_TEMPERATURE_PROBES;
+
+uint32_t g_uiTemperature_Cycle;
+uint32_t g_uiTemperature_Pass_Start;
+
+typedef struct
+{
+	uint32_t uiPeriod_Cycles;
+	uint32_t uiResolution;              // TEMP_RESOLUTION_BITS_ or TEMP_RESOLUTION_GLOBAL
+} Probe_Class;
+
+															// Period                        Resolution
+Probe_Class a_sProbe_Class[MAX_PROBE_CLASSES]			= { { 1,                             TEMP_RESOLUTION_GLOBAL },    // Normal
+															{ 1,                             TEMP_RESOLUTION_GLOBAL },    // Control
+															{ PROBE_TRACKING_PERIOD_CYCLES,  TEMP_RESOLUTION_BITS_9 } };  // Tracking
+
+uint32_t a_uiProbe_Class[MAX_TEMPERATURE_PROBES];           // all PROBE_CLASS_NORMAL until they're set
+
+uint32_t a_uiProbe_Resolution_Setting[MAX_TEMPERATURE_PROBES] = { TEMP_RESOLUTION_CLASS, TEMP_RESOLUTION_CLASS, TEMP_RESOLUTION_CLASS, TEMP_RESOLUTION_CLASS,
+																  TEMP_RESOLUTION_CLASS, TEMP_RESOLUTION_CLASS, TEMP_RESOLUTION_CLASS, TEMP_RESOLUTION_CLASS,
+																  TEMP_RESOLUTION_CLASS, TEMP_RESOLUTION_CLASS, TEMP_RESOLUTION_CLASS, TEMP_RESOLUTION_CLASS,
+																  TEMP_RESOLUTION_CLASS, TEMP_RESOLUTION_CLASS, TEMP_RESOLUTION_CLASS, TEMP_RESOLUTION_CLASS };
+uint32_t a_uiProbe_Resolution[MAX_TEMPERATURE_PROBES];      // what each probe is configured to, TEMP_RESOLUTION_BITS_
+
 
 
 void Temperature_Set_Logging_Flag(uint32_t uiSetLoggingFlag)
@@ -175,7 +311,7 @@ void Temperature_Set_Logging_Flag(uint32_t uiSetLoggingFlag)
 	g_uiLoggingFlag = uiSetLoggingFlag;
 }
 
-void Temperature_Log_Message(char* szMsg, uint32_t uiLocation, uint32_t ui32ErrorCode, uint32_t ui32Extended)
+void Temperature_Log_Message(const char* szMsg, uint32_t uiLocation, uint32_t ui32ErrorCode, uint32_t ui32Extended)
 {
 
 	// due to the fact that we have this information AND the routine was not setup to take a specific index.
@@ -185,69 +321,152 @@ void Temperature_Log_Message(char* szMsg, uint32_t uiLocation, uint32_t ui32Erro
 
 	if (g_uiLoggingFlag == false) return;
 
-	char szTemp[128] = "\0";
+	// this is called from inside the I2C sequences... just record it, Event_Log_Drain() does the text later.
+	// szMsg has to be a literal or static, only the pointer is kept.
+	Event_Log_Push(EVENT_SOURCE_TEMPERATURE, g_uiTemperatureIndex, uiLocation, ui32ErrorCode, ui32Extended, szMsg);
+
+	return;
+}
+
+void Temperature_Log_Message_Generic(const char* szMsg)
+{
+	if (g_uiLoggingFlag == false) return;
 
-	Telemetry_Send_Output(szMsg);
+	Event_Log_Push(EVENT_SOURCE_TEMPERATURE, g_uiTemperatureIndex, 0, 0, 0, szMsg);
+}
 
-	char szIndex[12];
-	char szLocation[12];
-	char szErrorCode[12];
-	char szExtended[12];
 
+void Temperature_Update_Resolutions(void)
+{
+	// each probe's own setting, else its class, else the global... a probe that changes is configured again
+	uint32_t i;
 
-	ltoa(g_uiTemperatureIndex, szIndex);
-	ltoa(uiLocation, szLocation);
-	ltoa(ui32ErrorCode, szErrorCode);
-	ltoa(ui32Extended, szExtended);
+	for (i = 0; i < MAX_TEMPERATURE_PROBES; i++)
+	{
+		uint32_t uiResolution = a_uiProbe_Resolution_Setting[i];
 
-	strcpy(szTemp, " Index: ");
-	strcat(szTemp, szIndex);
-	strcat(szTemp, "   Location: ");
-	strcat(szTemp, szLocation);
-	strcat(szTemp, "   Error: ");
-	strcat(szTemp, szErrorCode);
-	strcat(szTemp, "   Extended: ");
-	strcat(szTemp, szExtended);
-	strcat(szTemp, "\n");
+		if (uiResolution == TEMP_RESOLUTION_CLASS) uiResolution = a_sProbe_Class[a_uiProbe_Class[i]].uiResolution;
+		if (uiResolution == TEMP_RESOLUTION_GLOBAL) uiResolution = g_uiResolutionIndex;
 
-	Telemetry_Send_Output(szTemp);
+		if (uiResolution == a_uiProbe_Resolution[i]) continue;
 
-	return;
+		a_uiProbe_Resolution[i] = uiResolution;
+		g_s_Temperature_Telemetry[i].uiProbe_Configuration_Flag = false;
+	}
 }
 
-void Temperature_Log_Message_Generic(char* szMsg)
+
+uint32_t Temperature_Resolution_Fits(uint32_t uiResolution)
 {
-	if (g_uiLoggingFlag == false) return;
+	// the hold for this resolution has to fit in the cycle budget, the same check as the EEPROM setting
+	I2C_Bus_Counters sBus_Counters;
+
+	if (uiResolution > TEMP_RESOLUTION_BITS_12) return false;
+
+	I2C_Scheduler_Get_Counters(I2C_BUS_TEMPERATURE_0_7, &sBus_Counters);
+
+	return Cycle_Budget_Check_Settings(uiResolution, sBus_Counters.ui32Bit_Rate_kHz) == 0;
+}
+
 
-	Telemetry_Send_Output(szMsg);
+uint32_t Temperature_Resolution_Fallback(uint32_t uiResolution)
+{
+	// the highest resolution at or under uiResolution whose hold fits the cycle budget... 9 bits if none do
+	if (uiResolution > TEMP_RESOLUTION_BITS_12) uiResolution = TEMP_RESOLUTION_BITS_9;
+
+	while ((uiResolution > TEMP_RESOLUTION_BITS_9) && (Temperature_Resolution_Fits(uiResolution) == false))
+	{
+		uiResolution--;
+	}
+
+	return uiResolution;
 }
 
 
 void Temperature_Set_Resolution(uint32_t uiResolution)
 {
+	// the setting is kept as it was asked for, only what the probes run at falls back
+	if (uiResolution > TEMP_RESOLUTION_BITS_12) uiResolution = TEMP_RESOLUTION_BITS_9;  // default to 9 bits
 
-	if (uiResolution == g_uiResolutionIndex)
+	g_uiResolution_Setting = uiResolution;
+
+	// not logged here, this isn't the temperature task
+	uint32_t uiRunning = Temperature_Resolution_Fallback(uiResolution);
+	if (uiRunning != uiResolution) g_uiResolution_Refused = true;
+
+	if (uiRunning == g_uiResolutionIndex)
 	{
 		// no changes required, get out.
 		return;
 	}
 
-	if (uiResolution <= TEMP_RESOLUTION_BITS_12)
-	{
-		g_uiResolutionIndex = uiResolution;
-	}
-	else
-	{
-		g_uiResolutionIndex = TEMP_RESOLUTION_BITS_9;  // default to 9 bits
-	}
+	g_uiResolutionIndex = uiRunning;
 
-	// Set Flag to Reset the Temperature Resolution
-	uint32_t i;
-	for (i = 0; i < MAX_TEMPERATURE_PROBES; i++)
-    {
-		// s_Temperature_Telemetry[i].uiTemperature_Resolution = g_uiResolutionIndex;  // kind of a waste since the resolution is always the same
-    	g_s_Temperature_Telemetry[i].uiProbe_Configuration_Flag = false;
-    }
+	// the probes that follow the global resolution are configured again
+	Temperature_Update_Resolutions();
+}
+
+
+
+uint32_t Temperature_Set_Class(uint32_t uiClass, uint32_t uiPeriod_Cycles, uint32_t uiResolution)
+{
+	// 0, or CYCLE_BUDGET_ERR_OVER_PERIOD and nothing changes
+	if (uiClass >= MAX_PROBE_CLASSES) return CYCLE_BUDGET_ERR_INVALID;
+
+	if (uiPeriod_Cycles == 0) uiPeriod_Cycles = 1;
+	if (uiPeriod_Cycles > PROBE_MAX_PERIOD_CYCLES) uiPeriod_Cycles = PROBE_MAX_PERIOD_CYCLES;
+	if ((uiResolution > TEMP_RESOLUTION_BITS_12) && (uiResolution != TEMP_RESOLUTION_GLOBAL)) uiResolution = TEMP_RESOLUTION_GLOBAL;
+
+	if ((uiResolution != TEMP_RESOLUTION_GLOBAL) && (Temperature_Resolution_Fits(uiResolution) == false)) return CYCLE_BUDGET_ERR_OVER_PERIOD;
+
+	a_sProbe_Class[uiClass].uiPeriod_Cycles = uiPeriod_Cycles;
+	a_sProbe_Class[uiClass].uiResolution = uiResolution;
+
+	Temperature_Update_Resolutions();
+
+	return 0;
+}
+
+
+void Temperature_Set_Probe_Class(uint32_t uiTemperatureIndex, uint32_t uiClass)
+{
+	if ((uiTemperatureIndex >= MAX_TEMPERATURE_PROBES) || (uiClass >= MAX_PROBE_CLASSES)) return;
+
+	a_uiProbe_Class[uiTemperatureIndex] = uiClass;
+
+	Temperature_Update_Resolutions();
+}
+
+
+uint32_t Temperature_Set_Probe_Resolution(uint32_t uiTemperatureIndex, uint32_t uiResolution)
+{
+	// TEMP_RESOLUTION_BITS_ for this probe alone, TEMP_RESOLUTION_CLASS to follow its class again
+	if (uiTemperatureIndex >= MAX_TEMPERATURE_PROBES) return CYCLE_BUDGET_ERR_INVALID;
+	if ((uiResolution > TEMP_RESOLUTION_BITS_12) && (uiResolution != TEMP_RESOLUTION_CLASS)) return CYCLE_BUDGET_ERR_INVALID;
+
+	if ((uiResolution != TEMP_RESOLUTION_CLASS) && (Temperature_Resolution_Fits(uiResolution) == false)) return CYCLE_BUDGET_ERR_OVER_PERIOD;
+
+	a_uiProbe_Resolution_Setting[uiTemperatureIndex] = uiResolution;
+
+	Temperature_Update_Resolutions();
+
+	return 0;
+}
+
+
+uint32_t Temperature_Get_Probe_Resolution(uint32_t uiTemperatureIndex)
+{
+	if (uiTemperatureIndex >= MAX_TEMPERATURE_PROBES) return g_uiResolutionIndex;
+
+	return a_uiProbe_Resolution[uiTemperatureIndex];
+}
+
+
+uint32_t Temperature_Get_Probe_Class(uint32_t uiTemperatureIndex)
+{
+	if (uiTemperatureIndex >= MAX_TEMPERATURE_PROBES) return PROBE_CLASS_NORMAL;
+
+	return a_uiProbe_Class[uiTemperatureIndex];
 }
 
 
@@ -259,26 +478,22 @@ void Temperature_Initialize(uint32_t uiResolution)
 
 
 	Temperature_Set_Resolution(uiResolution);
+	Temperature_Update_Resolutions();
 
 
 	uint32_t i, j;
 
-    for (i = 0; i < MAX_TEMPERATURE_PROBES; i++)
-    {
-    	if (i <= 7)
-    	{
-    		a_h_I2C_Handle[i] = g_I2C_Handle_0_7;
-    	}
-    	else
-    	{
-    		a_h_I2C_Handle[i] = g_I2C_Handle_8_15;
-    	}
-    }
-
+	// the bus for each probe is fixed in a_ui_I2C_Bus[], the handles are registered with the I2C Scheduler in Driver_Setup()
 
 	// Init The Reading Structure
     for (i = 0; i < MAX_TEMPERATURE_PROBES; i++)
     {
+    	a_uiProbe_Health[i] = PROBE_HEALTHY;
+    	a_uiProbe_Failures[i] = 0;
+    	a_uiProbe_Backoff[i] = TEMPERATURE_BACKOFF_MIN_CYCLES;
+    	a_uiProbe_Retry_Cycle[i] = 0;
+    	a_uiProbe_Has_Reading[i] = false;
+
     	g_s_Temperature_Telemetry[i].uiROM_Flag = false;
     	g_s_Temperature_Telemetry[i].uiProbe_Configuration_Flag = false;
     	for (j = 0; j < 8; j++)
@@ -287,6 +502,9 @@ void Temperature_Initialize(uint32_t uiResolution)
     	}
     }
 
+    Temperature_History_Initialize();
+    Temperature_Estimator_Initialize();
+
     return;
 }
 
@@ -305,19 +523,19 @@ uint32_t I2C_Receive(uint8_t* p_ui8Data)
 	Temperature_Transaction.arg = NULL;
 
 
-	//bool bTransferOK = I2C_transfer(g_I2C_Handle_0_7, &Temperature_Transaction); /* Perform I2C transfer
-	bool bTransferOK = I2C_transfer(a_h_I2C_Handle[g_uiTemperatureIndex], &Temperature_Transaction);
+	PERF_START(ui32Perf);
+
+	uint32_t uiReturn = I2C_Scheduler_Transfer(a_ui_I2C_Bus[g_uiTemperatureIndex], g_uiTemperature_I2C_Priority, I2C_NO_DEADLINE, &Temperature_Transaction);
 
-	if (bTransferOK)
+	PERF_STOP(PERF_OP_I2C_RECEIVE, g_uiTemperatureIndex, ui32Perf);
+
+	if (uiReturn == I2C_MASTER_ERR_NONE)
 	{
 		return I2C_MASTER_ERR_NONE;
 	}
 
 
 	// oops, badness...
-	uint32_t uiReturn = I2C_control(a_h_I2C_Handle[g_uiTemperatureIndex], I2C_MASTER_ERR_NONE, 0);
-
-
 	Temperature_Log_Message("I2C_Receive()::I2C_Control()", 6001, uiReturn, 0);
 
 
@@ -338,7 +556,7 @@ uint32_t Clear_1_Wire_Busy_Status(uint8_t uiCommand1)
 
 	uint32_t uiCounter = 0;
 
-	char szLocation[] = "Clear_1_Wire_Busy_Status";
+	static const char szLocation[] = "Clear_1_Wire_Busy_Status";
 
 	// these are the commands that do NOT require a wait for the 1WBusy Flag to Clear..  we can get out.
 	if ((uiCommand1 == DS2482_SET_READ_POINTER_COMMAND) ||
@@ -350,9 +568,16 @@ uint32_t Clear_1_Wire_Busy_Status(uint8_t uiCommand1)
 
 
 	// we could constantly check for the Status Register Busy Flag....
-	SysCtlDelay(g_ui_0001_Second);
+	I2C_HAL_Delay(g_ui_0001_Second);
+
+	// a 1-Wire reset or byte is done in ~1.2ms, anything past the limit is a bad probe... don't wait 600ms for it
+	uint32_t uiPoll_Limit = a_uiBusy_Poll_Limit[a_uiProbe_Health[g_uiTemperatureIndex]];
+
+	// except a 1-Wire reset, the presence pulse is only there at the end of it... cut short, an empty channel
+	// looks like a bad probe and the DS2482 is left busy for the next channel select
+	if (uiCommand1 == DS2482_ONE_WIRE_RESET) uiPoll_Limit = a_uiBusy_Poll_Limit[PROBE_HEALTHY];
 
-	for (uiCounter = 0; uiCounter < 600; uiCounter++)
+	for (uiCounter = 0; uiCounter < uiPoll_Limit; uiCounter++)
 	{
 		// Get The Status of the 1 WIRE RESET - Already Pointing at the Status Register
 		ui32ErrorCode = I2C_Receive(&ui8Data);
@@ -366,11 +591,16 @@ uint32_t Clear_1_Wire_Busy_Status(uint8_t uiCommand1)
 
 		if ((ui8Data & ONE_WIRE_BUSY_FLAG) == 0)  // clears 1 Wire Busy Status - Then, Ready to Go!!!!
 		{
+			PERF_COUNT(PERF_OP_BUSY_POLLS, g_uiTemperatureIndex, uiCounter + 1);
+
 			if (uiCommand1 == DS2482_ONE_WIRE_RESET)		// look at the PPD on a 1 Wire Rest...
 			{
 				if ((ui8Data & ONE_WIRE_PPD) == 0) 			// this means that a Presense Pulse Was Not Detected on the Probe
 				{
-					Temperature_Log_Message(szLocation, 2005, 77, 0);
+					g_uiPresensePulseDetected = false;
+
+					// an empty channel being rediscovered isn't news
+					if (a_uiProbe_Absent[g_uiTemperatureIndex] == false) Temperature_Log_Message(szLocation, 2005, 77, 0);
 					return 2005;
 				}
 			}
@@ -379,11 +609,13 @@ uint32_t Clear_1_Wire_Busy_Status(uint8_t uiCommand1)
 		}
 
 
-		SysCtlDelay(g_ui_0001_Second);
+		I2C_HAL_Delay(g_ui_0001_Second);
 	}
 
 
 	// OK, we errored out!!!!
+	PERF_COUNT(PERF_OP_BUSY_POLLS, g_uiTemperatureIndex, uiPoll_Limit);
+
 	ui32ErrorCode = I2C_MASTER_INTERNAL_TIMEOUT;
 
 	Temperature_Log_Message(szLocation, 2010, ui32ErrorCode, 0);
@@ -419,23 +651,20 @@ uint32_t I2C_SendCommand(uint8_t uiCommand1, uint8_t uiCommand2)
 	Temperature_Transaction.readCount = 0;
  	Temperature_Transaction.arg = NULL;
 
- 	bool bTransferOK;
+ 	PERF_START(ui32Perf);
 
+ 	uint32_t uiReturn = I2C_Scheduler_Transfer(a_ui_I2C_Bus[g_uiTemperatureIndex], g_uiTemperature_I2C_Priority, I2C_NO_DEADLINE, &Temperature_Transaction);
 
-	//bTransferOK = I2C_transfer(g_I2C_Handle_0_7, &Temperature_Transaction); /* Perform I2C transfer */
- 	bTransferOK = I2C_transfer(a_h_I2C_Handle[g_uiTemperatureIndex], &Temperature_Transaction);
+ 	PERF_STOP(PERF_OP_I2C_SEND_COMMAND, g_uiTemperatureIndex, ui32Perf);
 
 
-	if (bTransferOK)
+	if (uiReturn == I2C_MASTER_ERR_NONE)
 	{
 		return I2C_MASTER_ERR_NONE;
 	}
 
 
 	// oops, badness...
-	uint32_t uiReturn = I2C_control(a_h_I2C_Handle[g_uiTemperatureIndex], I2C_MASTER_ERR_NONE, 0);
-
-
 	Temperature_Log_Message("Sent Command()::I2C_Control()", 3010, uiReturn, 0);
 
 
@@ -450,7 +679,7 @@ uint32_t I2C_SendCommand_Generic(uint8_t uiCommand1, uint8_t uiCommand2)
 
 	uint32_t ui32ErrorCode = 0;
 
-	char szLocation[] = "I2C_SendCommand_Generic";
+	static const char szLocation[] = "I2C_SendCommand_Generic";
 
 	ui32ErrorCode = I2C_SendCommand(uiCommand1, uiCommand2);
 
@@ -485,7 +714,7 @@ uint32_t Set_DS18B20_Configuration(void)
 
 	uint32_t ui32ErrorCode = 0;
 
-	char szLocation[] = "Set_DS18B20_Configuration";
+	static const char szLocation[] = "Set_DS18B20_Configuration";
 
 
 	ui32ErrorCode = I2C_SendCommand_Generic(DS2482_ONE_WIRE_RESET, 0);
@@ -526,7 +755,7 @@ uint32_t Set_DS18B20_Configuration(void)
 
 
 
-	uint8_t ui8ConfigBit = a_uiConfigResBits[g_uiResolutionIndex];  // 9, 10, 11, 12
+	uint8_t ui8ConfigBit = a_uiConfigResBits[a_uiProbe_Resolution[g_uiTemperatureIndex]];  // 9, 10, 11, 12
 
 
 	ui32ErrorCode = I2C_SendCommand_Generic(DS2482_ONE_WIRE_WRITE_BYTE, ui8ConfigBit);  // New Temp Config
@@ -564,8 +793,8 @@ uint32_t Set_DS18B20_Configuration(void)
 
 
 	// just wait to make sure it copied all the way!!!!  Give it double time...
-	SysCtlDelay(g_ui_001_Second);
-	SysCtlDelay(g_ui_001_Second);
+	I2C_HAL_Delay(g_ui_001_Second);
+	I2C_HAL_Delay(g_ui_001_Second);
 
 
 	ui32ErrorCode = I2C_SendCommand_Generic(DS2482_ONE_WIRE_RESET, 0);
@@ -580,7 +809,7 @@ uint32_t Set_DS18B20_Configuration(void)
 	uint8_t ui8TempData = 0;
 	uint32_t uiIndex;
 	uint32_t bKeepProcessing = true;
-	for (uiIndex = 0; uiIndex < 10000 && bKeepProcessing; uiIndex++)  // you could read the busy flag instead...!
+	for (uiIndex = 0; uiIndex < TEMPERATURE_CONFIG_MAX_POLLS && bKeepProcessing; uiIndex++)  // you could read the busy flag instead...!
 	{
 		// Set Register to Read
 		ui32ErrorCode = I2C_SendCommand_Generic(DS2482_SET_READ_POINTER_COMMAND, DS2482_DATA_REGISTER);
@@ -628,7 +857,7 @@ uint32_t I2C_Read_Data(uint8_t* ui8Data)
 
 	uint32_t ui32ErrorCode = 0;
 
-	char szLocation[] = "I2C_Read_Data";
+	static const char szLocation[] = "I2C_Read_Data";
 
 	ui32ErrorCode = I2C_SendCommand_Generic(DS2482_ONE_WIRE_READ_BYTE, 0);
 	if (ui32ErrorCode != I2C_MASTER_ERR_NONE)
@@ -673,7 +902,7 @@ uint32_t I2C_Reset_DS2482_And_Configure(uint32_t uiResetChip)
 
 	uint32_t ui32ErrorCode;
 
-	char szLocation[] = "I2C_Reset_DS2482_And_Configure";
+	static const char szLocation[] = "I2C_Reset_DS2482_And_Configure";
 
 	if (uiResetChip == false)  // anything to do here?
 	{
@@ -727,12 +956,23 @@ uint32_t I2C_Set_Channel_Select(uint32_t ui8_Write_Channel, uint32_t ui8_Verify_
 
 	uint32_t ui32ErrorCode;
 
-	char szLocation[] = "I2C_Set_Channel_Select";
+	static const char szLocation[] = "I2C_Set_Channel_Select";
+
+	// the select and the verify read go out as one batch
+	uint32_t uiBus = a_ui_I2C_Bus[g_uiTemperatureIndex];
+
+	ui32ErrorCode = I2C_Scheduler_Acquire(uiBus, g_uiTemperature_I2C_Priority, I2C_NO_DEADLINE);
+	if (ui32ErrorCode != 0)
+	{
+		Temperature_Log_Message(szLocation, 9005, ui32ErrorCode, 0);
+		return ui32ErrorCode;
+	}
 
 	// Select The Channel to Use
 	ui32ErrorCode = I2C_SendCommand_Generic(DS2482_CHANNEL_SELECT_COMMAND, ui8_Write_Channel);
 	if (ui32ErrorCode != 0)
 	{
+		I2C_Scheduler_Release(uiBus);
 		Temperature_Log_Message(szLocation, 9000, ui32ErrorCode, 0);
 		return ui32ErrorCode;
 	}
@@ -740,6 +980,9 @@ uint32_t I2C_Set_Channel_Select(uint32_t ui8_Write_Channel, uint32_t ui8_Verify_
 
 	// Get The Channel Data that is being pointed at
 	ui32ErrorCode = I2C_Receive(&ui8Data);
+
+	I2C_Scheduler_Release(uiBus);
+
 	if (ui32ErrorCode != 0)
 	{
 		Temperature_Log_Message(szLocation, 9010, ui32ErrorCode, 0);
@@ -761,28 +1004,7 @@ uint32_t I2C_Calculate_ScratchPad_CRC(unsigned char* ucString, int iLen)
 {
 	// 10000
 
-	//short int uCalcCRC = 0;
-
-	uint8_t uCalcCRC = 0;
-
-	int i = 0;
-	for (i = 0; i < iLen; i++)
-	{
-		short int inbyte = ucString[i];
-		int j = 0;
-		for (j = 0; j < 8; j++)
-		{
-			short int mix = (uCalcCRC ^ inbyte) & 0x01;
-			uCalcCRC >>= 1;
-
-			if (mix)
-			{
-				uCalcCRC ^= 0x8C;
-			}
-
-			inbyte >>= 1;
-		}
-	}
+	uint8_t uCalcCRC = Acquisition_CRC8(ucString, iLen);
 
 	short int uCRC = 0;
 	if (iLen == 7)  // ROM
@@ -802,6 +1024,9 @@ uint32_t I2C_Calculate_ScratchPad_CRC(unsigned char* ucString, int iLen)
 
 	Temperature_Log_Message("I2C_Calculate_ScratchPad_CRC: CRC Error!", 10000, uCRC, uCalcCRC);
 
+	// a CRC failure is a bus problem too, it counts towards dropping out of fast mode
+	I2C_Scheduler_Report_Error(a_ui_I2C_Bus[g_uiTemperatureIndex]);
+
 	return 105;
 }
 
@@ -817,7 +1042,7 @@ uint32_t I2C_Get_ROM_Codes(char* szROMCode)
 
 	uint8_t ui8Data = 0;
 
-	char szLocation[] = "I2C_Get_ROM_Codes";
+	static const char szLocation[] = "I2C_Get_ROM_Codes";
 
 	// Reset the 1-Wire Device
 	ui32ErrorCode = I2C_SendCommand_Generic(DS2482_ONE_WIRE_RESET, 0);
@@ -893,7 +1118,7 @@ uint32_t I2C_Activate_The_Temperatures(void)
 
 	uint32_t ui32ErrorCode;
 
-	char szLocation[] = "I2C_Activate_The_Temperatures";
+	static const char szLocation[] = "I2C_Activate_The_Temperatures";
 
 	// Reset the 1-Wire Device
 	ui32ErrorCode = I2C_SendCommand_Generic(DS2482_ONE_WIRE_RESET, 0);
@@ -925,31 +1150,12 @@ uint32_t I2C_Activate_The_Temperatures(void)
 
 void I2C_Convert_Celcius_To_Farenheit(uint32_t uiTemperatureIndex)
 {
-	float fTemp;
-	float fTemp2;
-
-	fTemp = (float) g_s_Temperature_Telemetry[uiTemperatureIndex].ui8Whole_C + ((float) g_s_Temperature_Telemetry[uiTemperatureIndex].ui8Fraction_C / 10.0);
-
-	if (g_s_Temperature_Telemetry[uiTemperatureIndex].ui8SignBit_C)
-	{
-		fTemp = fTemp *= -1;
-	}
-
-	// get the whole portion
-	fTemp = (fTemp * 1.8) + 32;
-	uint8_t ui8Temp_1 = (uint8_t) fTemp;
-	g_s_Temperature_Telemetry[uiTemperatureIndex].ui8Whole_F = ui8Temp_1;
-
-	// get the fraction
-	fTemp2 = fTemp - (float) g_s_Temperature_Telemetry[uiTemperatureIndex].ui8Whole_F;
-	fTemp2 *= 10;
-	uint8_t ui8Temp_2 = (uint8_t) fTemp2;
-	g_s_Temperature_Telemetry[uiTemperatureIndex].ui8Fraction_F = ui8Temp_2;
-
-	// get the sign bit
-	g_s_Temperature_Telemetry[uiTemperatureIndex].ui8SignBit_F = 0;
-	if (fTemp < 0) g_s_Temperature_Telemetry[uiTemperatureIndex].ui8SignBit_F = 1;
-
+	Acquisition_Celsius_To_Fahrenheit(g_s_Temperature_Telemetry[uiTemperatureIndex].ui8Whole_C,
+									  g_s_Temperature_Telemetry[uiTemperatureIndex].ui8Fraction_C,
+									  g_s_Temperature_Telemetry[uiTemperatureIndex].ui8SignBit_C,
+									  &g_s_Temperature_Telemetry[uiTemperatureIndex].ui8Whole_F,
+									  &g_s_Temperature_Telemetry[uiTemperatureIndex].ui8Fraction_F,
+									  &g_s_Temperature_Telemetry[uiTemperatureIndex].ui8SignBit_F);
 }
 
 
@@ -962,7 +1168,7 @@ uint32_t I2C_Retrieve_The_Temperatures(uint32_t uiTemperatureIndex)
 
 	uint8_t ui8Data;
 
-	char szLocation[] = "Retrieve_The_Temperatures";
+	static const char szLocation[] = "Retrieve_The_Temperatures";
 
 	// Reset the 1-Wire Device
 	ui32ErrorCode = I2C_SendCommand_Generic(DS2482_ONE_WIRE_RESET, 0);
@@ -1039,13 +1245,14 @@ uint32_t I2C_Retrieve_The_Temperatures(uint32_t uiTemperatureIndex)
 
 	// this is a check...
 	// 1. Did the resolution match KNOWN and Possible Resolution Combinations?
-	// 2. Did the global resolution Index match the index from array.  Does 0 = 0, 1 = 1, etc...
+	// 2. Did this probe's resolution Index match the index from array.  Does 0 = 0, 1 = 1, etc...
+	uint32_t uiProbe_Resolution = a_uiProbe_Resolution[uiTemperatureIndex];
 	uint32_t uiFlag = false;
 	for (uiIndex = 0; uiIndex < MAX_TEMP_RESOLUTIONS; uiIndex++)
 	{
 		if (a_uiConfigResBits[uiIndex] == uiTempRes)  // 1.
 		{
-			if (g_uiResolutionIndex == uiIndex)  // 2.
+			if (uiProbe_Resolution == uiIndex)  // 2.
 			{
 				uiFlag = true;
 			}
@@ -1058,24 +1265,8 @@ uint32_t I2C_Retrieve_The_Temperatures(uint32_t uiTemperatureIndex)
 	{
 		ui32ErrorCode = 109;
 
-		char szMsg[128];
-		char szExpected[12];
-		char szBits[12];
-		char szReceived[12];
-
-		ltoa(9 + g_uiResolutionIndex, szExpected);
-		ltoa(a_uiConfigResBits[g_uiResolutionIndex], szBits);
-		ltoa(uiTempRes, szReceived);
-
-		strcpy(szMsg, "Invalid Resolution...Expected: ");
-		strcat(szMsg, szExpected);
-		strcpy(szMsg, "  Bits-[");
-		strcat(szMsg, szBits);
-		strcpy(szMsg, "]  Received: [");
-		strcat(szMsg, szReceived);
-		strcpy(szMsg, "]  \n");
-
-		Temperature_Log_Message(szMsg, 15100, ui32ErrorCode, uiTempRes);
+		// Error carries the config bits we sent, Extended the config bits that came back
+		Temperature_Log_Message("Invalid Resolution...Error: Expected Config  Extended: Received Config\n", 15100, a_uiConfigResBits[uiProbe_Resolution], uiTempRes);
 		return ui32ErrorCode;
 	}
 
@@ -1117,123 +1308,226 @@ uint32_t I2C_Retrieve_The_Temperatures(uint32_t uiTemperatureIndex)
 	}
 
 
-	int8_t i8Temperature;
+	//s_Temperature_Telemetry[uiTemperatureIndex].ui8Raw0 = uiTempCode[0];
+	//s_Temperature_Telemetry[uiTemperatureIndex].ui8Raw1 = uiTempCode[1];
+
+	// whole number, tenths and sign from bytes 0 and 1, the fraction bits that count depend on the resolution
+	Acquisition_Decode_Temperature(uiTempCode[0], uiTempCode[1], a_uiResolutionMask[uiProbe_Resolution],
+								   &g_s_Temperature_Telemetry[uiTemperatureIndex].ui8Whole_C,
+								   &g_s_Temperature_Telemetry[uiTemperatureIndex].ui8Fraction_C,
+								   &g_s_Temperature_Telemetry[uiTemperatureIndex].ui8SignBit_C);
+
+
+
+	I2C_Convert_Celcius_To_Farenheit(uiTemperatureIndex);
+
+
+	return I2C_MASTER_ERR_NONE;
+}
 
-	uint8_t ucFractionIndex = 0;
-    uint8_t ucByte0 = uiTempCode[0];
-    uint8_t ucByte1 = uiTempCode[1];
 
+void Reset_ROM_Codes(void)
+{
+	g_s_Temperature_Telemetry[g_uiTemperatureIndex].uiROM_Flag = false;
+
+	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ucROM[0] = 0;
+	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ucROM[1] = 0;
+	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ucROM[2] = 0;
+	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ucROM[3] = 0;
+	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ucROM[4] = 0;
+	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ucROM[5] = 0;
+	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ucROM[6] = 0;
+	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ucROM[7] = 0;
+
+}
 
-    //s_Temperature_Telemetry[uiTemperatureIndex].ui8Raw0 = ucByte0;
-	//s_Temperature_Telemetry[uiTemperatureIndex].ui8Raw1 = ucByte1;
 
+void Reset_Temperatures(void)
+{
 
-    // GET THE FRACTION
-	// 9  bit = 1/2   or .5
-	// 10 bit = 1/4   or .25
-	// 11 bit = 1/8   or .125
-	// 12 bit = 1/16  or .0625
+	g_s_Temperature_Telemetry[g_uiTemperatureIndex].uiErrorFlag = 9999;
 
+	// the readings are only zeroed until there is a good one, after that the last good reading stays
+	if (a_uiProbe_Has_Reading[g_uiTemperatureIndex]) return;
 
-    							// 0    1    2    3    4    5    6    7   8    9    A    B    C    D    E    F
-                                // 0  .06  .12  .18  .25  .31  .38  .44  .5  .56  .62  .69  .75  .81  .88  .93
-	uint8_t aFractionPos[16] =    {0,   1,   1,   2,   3,   3,   4,   4,  5,   6,   6,   7,   8,   8,   9,   9};
+	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ui8Whole_C = 0;
+	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ui8Fraction_C = 0;
+	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ui8SignBit_C = 0;
 
-								// 0    1    2    3    4    5    6    7   8    9    A    B    C    D    E    F
-								// 0  .93  .88  .81  .75  .69  .62  .56  .5  .44  .38  .31  .25  .18  .12  .06
-	uint8_t aFractionNeg[16] =    {9,   9,   8,   7,   7,   6,   6,  5,   4,   4,   3,   3,   2,   1,   1,  0 };
+	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ui8Whole_F = 0;
+	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ui8Fraction_F = 0;
+	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ui8SignBit_F = 0;
+}
 
 
-	// the issue with 4 bit resolution is trying to represent .0625 with an integer, you can't or you
-	// constantly have to recalculate it when you want to use it...
-	//so, I am downshifting to .1, .2, .3, etc.  this still gives good resolution within a Whole Number
+uint32_t Temperature_Get_Age(uint32_t uiTemperatureIndex)
+{
+	// ms since the last good reading of this probe
+	if (uiTemperatureIndex >= MAX_TEMPERATURE_PROBES) return TEMPERATURE_AGE_NEVER;
 
+	if (a_uiProbe_Has_Reading[uiTemperatureIndex] == false) return TEMPERATURE_AGE_NEVER;
 
-	// bTemp at this point has the resolution..
-	// all is cleared away from the whole number portion
-	// this is the index for the Fraction Lookup on the Table above!
-	ucFractionIndex = ucByte0 & a_uiResolutionMask[g_uiResolutionIndex];
+	return I2C_HAL_Get_Ticks() - a_uiProbe_Last_Good_Ticks[uiTemperatureIndex];
+}
 
 
+uint32_t Temperature_Get_Health(uint32_t uiTemperatureIndex)
+{
+	if (uiTemperatureIndex >= MAX_TEMPERATURE_PROBES) return PROBE_QUARANTINED;
 
+	return a_uiProbe_Health[uiTemperatureIndex];
+}
 
-	// GET THE TEMPERATURE
-	// Mask out the sign bit
-	// uint8_t ucByteSignBit = ucByte1 & 0x08;
 
+uint32_t Temperature_Probe_Is_Due(void)
+{
+	// the class period, the tracking class's stretched when the cycle is degraded
+	uint32_t uiClass = a_uiProbe_Class[g_uiTemperatureIndex];
+	uint32_t uiPeriod = a_sProbe_Class[uiClass].uiPeriod_Cycles;
 
-	ucByte0 = ucByte0 >> 4;   	// shifts bit7 through bit4 down to bit3 through bit0 - clears out the decimal portion
-	ucByte0 = ucByte0 & 0x0F;    // clears out the upper bits
+	if (a_uiProbe_Has_Reading[g_uiTemperatureIndex] == false) return true;
 
-	ucByte1 = ucByte1 << 4;		// shifts bit0 through bit3 up to bit 7 through bit4 - clears out the sign bits
-	ucByte1 = ucByte1 & 0xF0;   // clears out the lower bits
+	// a gated probe is read when its prediction isn't good enough, the control probes never are
+	if ((uiClass != PROBE_CLASS_CONTROL) && Temperature_Estimator_Gates(g_uiTemperatureIndex))
+	{
+		return Temperature_Estimator_Needs_Read(g_uiTemperatureIndex, g_uiTemperature_Pass_Start);
+	}
 
-	i8Temperature = ucByte1 | ucByte0;
+	if (uiClass == PROBE_CLASS_TRACKING) uiPeriod *= Cycle_Budget_Tracking_Divisor();
 
+	return ((g_uiTemperature_Cycle + g_uiTemperatureIndex) % uiPeriod) == 0;
+}
 
-	uint8_t ui8_FractionValue = 0;
 
+uint32_t Temperature_Probe_Should_Skip(void)
+{
+	uint32_t uiHealth = a_uiProbe_Health[g_uiTemperatureIndex];
 
-	// check the sign bit
-	if ((i8Temperature & (int8_t) 0x80) == 0)
+	// quarantined and not due for a re-probe
+	if ((uiHealth == PROBE_QUARANTINED) && ((int32_t) (g_uiTemperature_Cycle - a_uiProbe_Retry_Cycle[g_uiTemperatureIndex]) < 0))
 	{
-		g_s_Temperature_Telemetry[uiTemperatureIndex].ui8SignBit_C = 0;
-		g_s_Temperature_Telemetry[uiTemperatureIndex].ui8Whole_C = i8Temperature;
+		return true;
+	}
 
-		ui8_FractionValue = aFractionPos[ucFractionIndex];
-		g_s_Temperature_Telemetry[uiTemperatureIndex].ui8Fraction_C = ui8_FractionValue;
+	// over budget, only the healthy probes get the time
+	if ((uiHealth != PROBE_HEALTHY) && ((I2C_HAL_Get_Ticks() - g_uiTemperature_Pass_Start) > TEMPERATURE_PASS_BUDGET_TICKS))
+	{
+		return true;
 	}
-	else
+
+	return false;
+}
+
+
+uint32_t Temperature_Hold_Resolution(void)
+{
+	// the finest resolution of the probes that will convert this cycle, the hold has to cover it
+	uint32_t uiHold_Resolution = TEMP_RESOLUTION_BITS_9;
+
+	for (g_uiTemperatureIndex = 0; g_uiTemperatureIndex < MAX_TEMPERATURE_PROBES; g_uiTemperatureIndex++)
 	{
-		// flip everything around...!!!
+		if (a_uiProbe_Absent[g_uiTemperatureIndex] && (g_uiTemperatureIndex != g_uiProbe_Rediscover_Index)) continue;
+		if (Temperature_Probe_Should_Skip() || (Temperature_Probe_Is_Due() == false)) continue;
 
-		// the number is negative!!  Set Sign Bit.
-		g_s_Temperature_Telemetry[uiTemperatureIndex].ui8SignBit_C = 1;
+		if (a_uiProbe_Resolution[g_uiTemperatureIndex] > uiHold_Resolution) uiHold_Resolution = a_uiProbe_Resolution[g_uiTemperatureIndex];
+	}
+
+	return uiHold_Resolution;
+}
+
+
+void Temperature_Probe_Failed(void)
+{
+	uint32_t i = g_uiTemperatureIndex;
+
+	a_uiProbe_Failures[i]++;
+
+	if (a_uiProbe_Health[i] == PROBE_HEALTHY)
+	{
+		a_uiProbe_Health[i] = PROBE_SUSPECT;
+	}
 
-		// flip the bits of the Whole Number to get the negative number.
-		g_s_Temperature_Telemetry[uiTemperatureIndex].ui8Whole_C = i8Temperature ^ 0xFF;
+	if (a_uiProbe_Failures[i] < PROBE_QUARANTINE_FAILURES)
+	{
+		return;
+	}
 
-		ui8_FractionValue = aFractionNeg[ucFractionIndex];
-		g_s_Temperature_Telemetry[uiTemperatureIndex].ui8Fraction_C = ui8_FractionValue;
+	// into quarantine (or back in), the wait doubles every time
+	if (a_uiProbe_Health[i] == PROBE_QUARANTINED)
+	{
+		a_uiProbe_Backoff[i] *= 2;
+		if (a_uiProbe_Backoff[i] > TEMPERATURE_BACKOFF_MAX_CYCLES) a_uiProbe_Backoff[i] = TEMPERATURE_BACKOFF_MAX_CYCLES;
 	}
 
+	a_uiProbe_Health[i] = PROBE_QUARANTINED;
+	a_uiProbe_Retry_Cycle[i] = g_uiTemperature_Cycle + a_uiProbe_Backoff[i];
+}
 
 
-	I2C_Convert_Celcius_To_Farenheit(uiTemperatureIndex);
+void Temperature_Probe_Succeeded(void)
+{
+	uint32_t i = g_uiTemperatureIndex;
 
+	a_uiProbe_Health[i] = PROBE_HEALTHY;
+	a_uiProbe_Failures[i] = 0;
+	a_uiProbe_Backoff[i] = TEMPERATURE_BACKOFF_MIN_CYCLES;
 
-	return I2C_MASTER_ERR_NONE;
+	a_uiProbe_Has_Reading[i] = true;
+	a_uiProbe_Last_Good_Ticks[i] = I2C_HAL_Get_Ticks();
 }
 
 
-void Reset_ROM_Codes(void)
+void Temperature_Probe_Missing(void)
 {
-	g_s_Temperature_Telemetry[g_uiTemperatureIndex].uiROM_Flag = false;
+	// no presence pulse... nothing on the channel, not a failing probe, so no quarantine
+	uint32_t i = g_uiTemperatureIndex;
 
-	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ucROM[0] = 0;
-	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ucROM[1] = 0;
-	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ucROM[2] = 0;
-	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ucROM[3] = 0;
-	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ucROM[4] = 0;
-	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ucROM[5] = 0;
-	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ucROM[6] = 0;
-	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ucROM[7] = 0;
+	a_uiProbe_Health[i] = PROBE_HEALTHY;
+	a_uiProbe_Failures[i] = 0;
+
+	if (a_uiProbe_Absent[i] == false)
+	{
+		a_uiProbe_Absent[i] = true;
+		Temperature_Log_Message_Generic("Temperature_Initiate()::Probe Absent");
+
+		// whatever is plugged in next is a different probe at its power on resolution
+		g_s_Temperature_Telemetry[i].uiProbe_Configuration_Flag = false;
+		g_s_Temperature_Telemetry[i].uiROM_Flag = false;
+	}
 
+	g_s_Temperature_Telemetry[i].uiErrorFlag = TEMPERATURE_ERROR_ABSENT;
 }
 
 
-void Reset_Temperatures(void)
+void Temperature_Probe_Rediscovered(void)
 {
+	// it answered the 1-Wire reset, back in the main cycle from here on
+	uint32_t i = g_uiTemperatureIndex;
 
-	g_s_Temperature_Telemetry[g_uiTemperatureIndex].uiErrorFlag = 9999;
+	a_uiProbe_Absent[i] = false;
 
-	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ui8Whole_C = 0;
-	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ui8Fraction_C = 0;
-	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ui8SignBit_C = 0;
+	Temperature_Log_Message_Generic("Temperature_Initiate()::Probe Found");
+}
 
-	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ui8Whole_F = 0;
-	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ui8Fraction_F = 0;
-	g_s_Temperature_Telemetry[g_uiTemperatureIndex].ui8SignBit_F = 0;
+
+void Temperature_Next_Rediscovery(void)
+{
+	// one empty channel a cycle, round robin, so a probe plugged in shows up within 16 cycles
+	uint32_t uiCount;
+	uint32_t i = g_uiProbe_Rediscover_Index;
+
+	g_uiProbe_Rediscover_Index = MAX_TEMPERATURE_PROBES;
+
+	for (uiCount = 0; uiCount < MAX_TEMPERATURE_PROBES; uiCount++)
+	{
+		i = (i + 1) % MAX_TEMPERATURE_PROBES;
+
+		if (a_uiProbe_Absent[i])
+		{
+			g_uiProbe_Rediscover_Index = i;
+			return;
+		}
+	}
 }
 
 void Temperature_Initiate(void)
@@ -1242,14 +1536,32 @@ void Temperature_Initiate(void)
 	// 16000
 	uint32_t uiOK;
 	uint32_t ui32ErrorCode;
+	uint32_t uiROM_Reads = 0;
 
 	uint32_t a_ui32_Reset_Chip[MAX_TEMPERATURE_PROBES] = {true, false, false, false, false, false, false, false, true, false, false, false, false, false, false, false};
 
 
-	char szLocation[] = "Temperature_Initiate";
+	static const char szLocation[] = "Temperature_Initiate";
 
 	// set up the CHIP, The Configs, Get The ROMs and Ask the Probes to work on a Temp.
 
+	PERF_START(ui32Perf);
+	uint32_t ui32Cycle_Start = Cycle_Budget_Phase_Start(CYCLE_PHASE_INITIATE);
+
+	g_uiTemperature_Cycle++;
+	g_uiTemperature_Pass_Start = I2C_HAL_Get_Ticks();
+
+	if (g_uiResolution_Refused)
+	{
+		g_uiResolution_Refused = false;
+		Event_Log_Push(EVENT_SOURCE_TEMPERATURE, EVENT_NO_PROBE, 16000, CYCLE_BUDGET_ERR_OVER_PERIOD, g_uiResolutionIndex,
+					   "Temperature_Set_Resolution()::Over The Cycle Budget, Running At A Lower Resolution");
+	}
+
+	Temperature_Next_Rediscovery();
+
+	// the hold is armed with this delay at probe 1
+	Job_Scheduler_Set_Period(JOB_TEMPERATURE_HOLD, g_ui_Temperature_Clock_Delay[Temperature_Hold_Resolution()]);
 
 	for (g_uiTemperatureIndex = 0; g_uiTemperatureIndex < MAX_TEMPERATURE_PROBES; g_uiTemperatureIndex++)
 	{
@@ -1257,17 +1569,46 @@ void Temperature_Initiate(void)
 
 		if (g_uiTemperatureIndex == 1)
 		{
-			Clock_start(g_Clock_Temperature_OneShot_Handle);
+			Job_Scheduler_Start(JOB_TEMPERATURE_HOLD);
+		}
+
+
+		// skipped probes keep uiErrorFlag 9999 and their last good reading, probes that aren't due keep
+		// TEMPERATURE_ERROR_NOT_DUE and their last good reading, empty channels TEMPERATURE_ERROR_ABSENT.
+		// The channel being rediscovered goes through... it is last in line, only if the pass has the time.
+		uint32_t uiHeld_Flag = I2C_MASTER_ERR_NONE;
+		uint32_t uiRediscovery = false;
+		if (a_uiProbe_Absent[g_uiTemperatureIndex])
+		{
+			uiRediscovery = (g_uiTemperatureIndex == g_uiProbe_Rediscover_Index) && ((I2C_HAL_Get_Ticks() - g_uiTemperature_Pass_Start) <= TEMPERATURE_PASS_BUDGET_TICKS);
+			if (uiRediscovery == false) uiHeld_Flag = TEMPERATURE_ERROR_ABSENT;
+		}
+		else if (Temperature_Probe_Should_Skip()) uiHeld_Flag = 9999;
+		else if (Temperature_Probe_Is_Due() == false)
+		{
+			uiHeld_Flag = TEMPERATURE_ERROR_NOT_DUE;
+			if (Temperature_Estimator_Gates(g_uiTemperatureIndex)) Temperature_Estimator_Held(g_uiTemperatureIndex);
+		}
+
+		if ((uiHeld_Flag != I2C_MASTER_ERR_NONE) && (a_ui32_Reset_Chip[g_uiTemperatureIndex] == false))
+		{
+			g_s_Temperature_Telemetry[g_uiTemperatureIndex].uiErrorFlag = uiHeld_Flag;
+			continue;
 		}
 
 
 
 		uiOK = true;
 		g_s_Temperature_Telemetry[g_uiTemperatureIndex].uiErrorFlag = I2C_MASTER_ERR_NONE;
+		g_uiPresensePulseDetected = true;
 
 
 		uiOK = true;
 
+		// the ROM read limit is per chip... the config poll in Set_DS18B20_Configuration() needs a byte read
+		// on this chip since its reset, and the first ROM read on the chip puts one in the data register
+		if (a_ui32_Reset_Chip[g_uiTemperatureIndex]) uiROM_Reads = 0;
+
 		ui32ErrorCode = I2C_Reset_DS2482_And_Configure(a_ui32_Reset_Chip[g_uiTemperatureIndex]);
 		if (ui32ErrorCode != I2C_MASTER_ERR_NONE)
 		{
@@ -1277,6 +1618,14 @@ void Temperature_Initiate(void)
 		}
 
 
+		// the DS2482 reset rides along with the 1st probe of each chip, that still has to happen
+		if (uiHeld_Flag != I2C_MASTER_ERR_NONE)
+		{
+			g_s_Temperature_Telemetry[g_uiTemperatureIndex].uiErrorFlag = uiHeld_Flag;
+			continue;
+		}
+
+
 		if (uiOK)
 		{
 			ui32ErrorCode = I2C_Set_Channel_Select(a_ui8_Write_Channel_Array[g_uiTemperatureIndex], a_ui8_Verify_Channel_Array[g_uiTemperatureIndex]);
@@ -1291,9 +1640,13 @@ void Temperature_Initiate(void)
 
 		if (uiOK)
 		{
-			if (g_s_Temperature_Telemetry[g_uiTemperatureIndex].uiROM_Flag == false)
+			// ROM reads are limited per chip in each pass so the first pass gets to a reading quickly,
+			// the rest of the ROMs are picked up over the next few passes
+			if ((g_s_Temperature_Telemetry[g_uiTemperatureIndex].uiROM_Flag == false) && (uiROM_Reads < TEMPERATURE_ROM_READS_PER_CHIP))
 			{
 				char szROMCode[DS18B20_ROM_SIZE];
+
+				uiROM_Reads++;
 				ui32ErrorCode = I2C_Get_ROM_Codes(szROMCode);
 				if (ui32ErrorCode != I2C_MASTER_ERR_NONE)
 				{
@@ -1352,9 +1705,25 @@ void Temperature_Initiate(void)
 			}
 		}
 
+
+		if ((uiOK == false) && (g_uiPresensePulseDetected == false))
+		{
+			Temperature_Probe_Missing();
+		}
+		else if (uiOK == false)
+		{
+			Temperature_Probe_Failed();
+		}
+		else if (uiRediscovery)
+		{
+			Temperature_Probe_Rediscovered();
+		}
+
 	}
 
 
+	PERF_STOP(PERF_OP_TEMPERATURE_INITIATE, PERF_NO_SLOT, ui32Perf);
+	Cycle_Budget_Phase_Stop(CYCLE_PHASE_INITIATE, ui32Cycle_Start);
 
 	return;
 }
@@ -1367,8 +1736,13 @@ void Temperature_Get(void)
 	uint32_t ui32ErrorCode;
 
 
-	char szLocation[] = "Temperature_Get";
+	static const char szLocation[] = "Temperature_Get";
+
+
+	PERF_START(ui32Perf);
+	uint32_t ui32Cycle_Start = Cycle_Budget_Phase_Start(CYCLE_PHASE_GET);
 
+	g_uiTemperature_Pass_Start = I2C_HAL_Get_Ticks();
 
 	// Get The Temps
 	for (g_uiTemperatureIndex = 0; g_uiTemperatureIndex < MAX_TEMPERATURE_PROBES; g_uiTemperatureIndex++)
@@ -1377,6 +1751,11 @@ void Temperature_Get(void)
 
 		if (g_s_Temperature_Telemetry[g_uiTemperatureIndex].uiErrorFlag == I2C_MASTER_ERR_NONE)
 		{
+			if (Temperature_Probe_Should_Skip())
+			{
+				g_s_Temperature_Telemetry[g_uiTemperatureIndex].uiErrorFlag = 9999;
+				continue;
+			}
 
 			ui32ErrorCode = I2C_Set_Channel_Select(a_ui8_Write_Channel_Array[g_uiTemperatureIndex], a_ui8_Verify_Channel_Array[g_uiTemperatureIndex]);
 			if (ui32ErrorCode != I2C_MASTER_ERR_NONE)
@@ -1388,7 +1767,13 @@ void Temperature_Get(void)
 
 			if (uiOK)
 			{
+				// the scratchpad read is bulk work, anything latency critical can go ahead of it
+				g_uiTemperature_I2C_Priority = I2C_PRIORITY_BULK;
+
 				ui32ErrorCode = I2C_Retrieve_The_Temperatures(g_uiTemperatureIndex);
+
+				g_uiTemperature_I2C_Priority = I2C_PRIORITY_NORMAL;
+
 				if (ui32ErrorCode != I2C_MASTER_ERR_NONE)
 				{
 					Temperature_Log_Message(szLocation, 90, ui32ErrorCode, 0);
@@ -1397,11 +1782,36 @@ void Temperature_Get(void)
 				}
 			}
 
+
+			if (uiOK)
+			{
+				Temperature_Probe_Succeeded();
+			}
+			else
+			{
+				Temperature_Probe_Failed();
+			}
+
 		}
 	}
 
 
-	//Temperature_Log_Message("\n\nHighest Counter----------------------------------------------", g_HighestWaitCounter, g_HighestWaitCounter);
+	// the pass is complete... readers in other tasks only ever see whole passes
+	Temperature_Snapshot_Publish();
+
+	// trends for the pump logic, from the snapshot just published
+	Temperature_History_Update();
+
+	// and the predictions that decide which gated probes are read next cycle
+	Temperature_Estimator_Update();
+
+	Boot_Timing_Mark(BOOT_STAGE_FIRST_TEMPERATURE);
+
+	PERF_STOP(PERF_OP_TEMPERATURE_GET, PERF_NO_SLOT, ui32Perf);
+	Cycle_Budget_Phase_Stop(CYCLE_PHASE_GET, ui32Cycle_Start);
+
+	// the cycle the one second job started is done
+	Job_Scheduler_Work_Done(JOB_ONE_SECOND_SYSTEM);
 
 	return;
 }
@@ -0,0 +1,157 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Temperature_Get() writes the whole, fraction and sign of each probe one field at a time, and the
+// pass takes most of a second.  A reader in another task (pump control, telemetry) looking straight at
+// g_s_Temperature_Telemetry can see one field new and the next one old, or a probe that is half way
+// through its pass.
+//
+// At the end of each pass Temperature_Snapshot_Publish() copies all 16 probes into a snapshot, and
+// readers use Temperature_Snapshot_Read() to get a complete copy without a semaphore.
+//
+// There are two buffers, each with its own sequence number (seqlock).
+//     Writer - bumps the sequence of the buffer that is NOT being read (now odd), fills it, bumps the
+//              sequence again (even) and then makes it the active buffer.
+//     Reader - takes the active buffer's sequence, copies the buffer, and checks the sequence again.
+//              Same and even... the copy is good.  Otherwise it goes around again.
+// The writer never touches the active buffer, so a higher priority reader that preempts the writer
+// half way through still gets a good copy on the first try.  A reader only goes around again when
+// the writer got in and published twice while it was copying.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <xdc/std.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#include "constants.h"
+#include "globals.h"
+
+#include "Temperature_Snapshot.h"
+#include "I2C_HAL.h"
+#include "Static_Footprint.h"
+
+
+#define TEMPERATURE_SNAPSHOT_BUFFERS		2
+
+
+// from Temperature_Interface.c
+uint32_t Temperature_Get_Age(uint32_t uiTemperatureIndex);
+uint32_t Temperature_Get_Health(uint32_t uiTemperatureIndex);
+uint32_t Temperature_Get_Probe_Resolution(uint32_t uiTemperatureIndex);
+
+
+Temperature_Snapshot a_sTemperature_Snapshot[TEMPERATURE_SNAPSHOT_BUFFERS];
+volatile uint32_t a_uiSnapshot_Sequence[TEMPERATURE_SNAPSHOT_BUFFERS];
+
+const uint32_t g_uiTemperature_Snapshot_Static_Bytes = sizeof(a_sTemperature_Snapshot) + sizeof(a_uiSnapshot_Sequence);
+STATIC_FOOTPRINT_CHECK((sizeof(a_sTemperature_Snapshot) + sizeof(a_uiSnapshot_Sequence)) <= STATIC_BUDGET_TEMPERATURE_SNAPSHOT, Temperature_Snapshot);
+volatile uint32_t g_uiSnapshot_Active;
+
+uint32_t g_uiSnapshot_Published;
+uint32_t g_uiSnapshot_Retries;
+
+
+
+static void Temperature_Snapshot_Copy(volatile Temperature_Snapshot* pTo, const volatile Temperature_Snapshot* pFrom)
+{
+	// field by field through volatile pointers so the compiler keeps every access between the
+	// sequence reads / writes around it
+	uint32_t i;
+
+	pTo->ui32Sequence = pFrom->ui32Sequence;
+	pTo->ui32Ticks = pFrom->ui32Ticks;
+
+	for (i = 0; i < TEMPERATURE_SNAPSHOT_PROBES; i++)
+	{
+		pTo->a_sProbe[i].i16Tenths_C = pFrom->a_sProbe[i].i16Tenths_C;
+		pTo->a_sProbe[i].i16Tenths_F = pFrom->a_sProbe[i].i16Tenths_F;
+		pTo->a_sProbe[i].ui32Error_Flag = pFrom->a_sProbe[i].ui32Error_Flag;
+		pTo->a_sProbe[i].ui32Last_Good_Ticks = pFrom->a_sProbe[i].ui32Last_Good_Ticks;
+		pTo->a_sProbe[i].ui8Valid = pFrom->a_sProbe[i].ui8Valid;
+		pTo->a_sProbe[i].ui8ROM_Flag = pFrom->a_sProbe[i].ui8ROM_Flag;
+		pTo->a_sProbe[i].ui8Configured = pFrom->a_sProbe[i].ui8Configured;
+		pTo->a_sProbe[i].ui8Health = pFrom->a_sProbe[i].ui8Health;
+		pTo->a_sProbe[i].ui8Resolution = pFrom->a_sProbe[i].ui8Resolution;
+	}
+}
+
+
+void Temperature_Snapshot_Publish(void)
+{
+	// called by the temperature task only, at the end of a Temperature_Get() pass
+
+	Temperature_Snapshot sNew;
+	uint32_t uiNow = I2C_HAL_Get_Ticks();
+	uint32_t i;
+
+	g_uiSnapshot_Published++;
+
+	sNew.ui32Sequence = g_uiSnapshot_Published;
+	sNew.ui32Ticks = uiNow;
+
+	for (i = 0; i < TEMPERATURE_SNAPSHOT_PROBES; i++)
+	{
+		Temperature_Probe_Snapshot* pProbe = &sNew.a_sProbe[i];
+
+		pProbe->i16Tenths_C = (int16_t) (g_s_Temperature_Telemetry[i].ui8Whole_C * 10 + g_s_Temperature_Telemetry[i].ui8Fraction_C);
+		if (g_s_Temperature_Telemetry[i].ui8SignBit_C) pProbe->i16Tenths_C = -pProbe->i16Tenths_C;
+
+		pProbe->i16Tenths_F = (int16_t) (g_s_Temperature_Telemetry[i].ui8Whole_F * 10 + g_s_Temperature_Telemetry[i].ui8Fraction_F);
+		if (g_s_Temperature_Telemetry[i].ui8SignBit_F) pProbe->i16Tenths_F = -pProbe->i16Tenths_F;
+
+		uint32_t uiAge = Temperature_Get_Age(i);
+
+		pProbe->ui32Error_Flag = g_s_Temperature_Telemetry[i].uiErrorFlag;
+		pProbe->ui8Valid = (uiAge != 0xFFFFFFFF);
+		pProbe->ui32Last_Good_Ticks = pProbe->ui8Valid ? (uiNow - uiAge) : 0;
+		pProbe->ui8ROM_Flag = (g_s_Temperature_Telemetry[i].uiROM_Flag != false);
+		pProbe->ui8Configured = (g_s_Temperature_Telemetry[i].uiProbe_Configuration_Flag != false);
+		pProbe->ui8Health = (uint8_t) Temperature_Get_Health(i);
+		pProbe->ui8Resolution = (uint8_t) Temperature_Get_Probe_Resolution(i);
+	}
+
+	// fill the buffer nobody is being pointed at
+	uint32_t uiBuffer = g_uiSnapshot_Active ^ 1;
+
+	a_uiSnapshot_Sequence[uiBuffer]++;     // odd... being written
+
+	Temperature_Snapshot_Copy(&a_sTemperature_Snapshot[uiBuffer], &sNew);
+
+	a_uiSnapshot_Sequence[uiBuffer]++;     // even... complete
+
+	g_uiSnapshot_Active = uiBuffer;
+}
+
+
+uint32_t Temperature_Snapshot_Read(Temperature_Snapshot* pSnapshot)
+{
+	// any task... returns the publish count of the copy, 0 if nothing has been published yet
+
+	uint32_t uiBuffer;
+	uint32_t uiSequence;
+
+	while (true)
+	{
+		uiBuffer = g_uiSnapshot_Active;
+		uiSequence = a_uiSnapshot_Sequence[uiBuffer];
+
+		if ((uiSequence & 1) == 0)
+		{
+			Temperature_Snapshot_Copy(pSnapshot, &a_sTemperature_Snapshot[uiBuffer]);
+
+			if (a_uiSnapshot_Sequence[uiBuffer] == uiSequence) break;
+		}
+
+		// the writer got to this buffer while it was being copied
+		g_uiSnapshot_Retries++;
+	}
+
+	return pSnapshot->ui32Sequence;
+}
@@ -0,0 +1,49 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Temperature Snapshot - a consistent copy of all 16 probes, published once per Temperature_Get() pass.
+//
+//*****************************************************************************
+
+#ifndef TEMPERATURE_SNAPSHOT_H_
+#define TEMPERATURE_SNAPSHOT_H_
+
+#include <stdint.h>
+
+
+#define TEMPERATURE_SNAPSHOT_PROBES			16     // MAX_TEMPERATURE_PROBES
+
+// ui32Error_Flag of a probe its class didn't read this pass... the last good reading is held, not an error
+#define TEMPERATURE_ERROR_NOT_DUE			9998
+
+// ui32Error_Flag of a channel with no probe on it (no presence pulse)... only rediscovery tries it
+#define TEMPERATURE_ERROR_ABSENT			9997
+
+
+typedef struct
+{
+	int16_t i16Tenths_C;                // 1/10 degree
+	int16_t i16Tenths_F;
+	uint32_t ui32Error_Flag;            // uiErrorFlag at the end of the pass
+	uint32_t ui32Last_Good_Ticks;       // only meaningful when ui8Valid
+	uint8_t ui8Valid;                   // there has been a good reading
+	uint8_t ui8ROM_Flag;
+	uint8_t ui8Configured;
+	uint8_t ui8Health;                  // PROBE_HEALTHY / SUSPECT / QUARANTINED
+	uint8_t ui8Resolution;              // TEMP_RESOLUTION_BITS_, what the probe is configured to
+} Temperature_Probe_Snapshot;
+
+
+typedef struct
+{
+	uint32_t ui32Sequence;              // publishes so far... changes every pass
+	uint32_t ui32Ticks;                 // when it was published
+	Temperature_Probe_Snapshot a_sProbe[TEMPERATURE_SNAPSHOT_PROBES];
+} Temperature_Snapshot;
+
+
+void Temperature_Snapshot_Publish(void);
+uint32_t Temperature_Snapshot_Read(Temperature_Snapshot* pSnapshot);
+
+#endif /* TEMPERATURE_SNAPSHOT_H_ */
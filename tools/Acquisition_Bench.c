@@ -0,0 +1,360 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// PC benchmark for the per cycle acquisition kernels in Acquisition_Kernels.c.
+//
+// This is a PC program, it is not part of the board build.  The --wrap flags let it count allocations.
+//     gcc -O2 -I.. -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc -o acq_bench Acquisition_Bench.c ../Acquisition_Kernels.c
+//     ./acq_bench                                          print ns/op, allocations/op and checksums
+//     ./acq_bench -c Acquisition_Bench_Baseline.txt [-t 25] compare against the baselines, exit 1 on a regression
+//     ./acq_bench -w Acquisition_Bench_Baseline.txt        write new baselines
+//
+// Every kernel runs over a fixed set of inputs (scratchpads, readings, ADC samples, event records), so
+// the checksum of the results is fixed too.  A regression is:
+//     ns/op more than the threshold (default 25%) over the baseline
+//     any allocation
+//     a checksum that differs from the baseline... an optimization that changes a result isn't one
+//
+// The times are the best of several runs.  They only mean something against baselines written on the
+// same machine with the same compiler, write new ones when either changes and commit them with the
+// change that moved them.
+//
+//*****************************************************************************
+
+#if !defined(__TI_COMPILER_VERSION__)
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "Event_Log.h"
+#include "Acquisition_Kernels.h"
+
+
+#define BENCH_INPUTS						64     // power of 2
+#define BENCH_INPUT_MASK					(BENCH_INPUTS - 1)
+#define BENCH_RUNS							25
+#define BENCH_RUN_NS						5000000ULL
+#define BENCH_THRESHOLD_DEFAULT				25     // percent
+#define BENCH_ADC_SAMPLES					10
+#define BENCH_MAX_KERNELS					8
+
+
+typedef uint32_t (*Bench_Kernel)(uint32_t uiIndex);
+
+typedef struct
+{
+	const char* szName;
+	Bench_Kernel pKernel;
+	double dNs_Per_Op;
+	double dAllocations_Per_Op;
+	uint32_t ui32Checksum;
+} Bench_Result;
+
+
+uint8_t a_ui8Bench_Scratchpad[BENCH_INPUTS][9];
+uint8_t a_ui8Bench_Celsius[BENCH_INPUTS][3];
+uint16_t a_ui16Bench_Samples[BENCH_INPUTS][BENCH_ADC_SAMPLES];
+Event_Record a_sBench_Event[BENCH_INPUTS];
+
+const uint8_t a_ui8Bench_Resolution_Mask[4] = {0x08, 0x0C, 0x0E, 0x0F};
+
+volatile uint32_t g_ui32Bench_Sink;
+uint32_t g_uiBench_Allocations;
+
+
+
+// allocation counting, through the linker's --wrap
+void* __real_malloc(size_t uiSize);
+void* __real_calloc(size_t uiCount, size_t uiSize);
+void* __real_realloc(void* pMemory, size_t uiSize);
+
+void* __wrap_malloc(size_t uiSize)						{ g_uiBench_Allocations++; return __real_malloc(uiSize); }
+void* __wrap_calloc(size_t uiCount, size_t uiSize)		{ g_uiBench_Allocations++; return __real_calloc(uiCount, uiSize); }
+void* __wrap_realloc(void* pMemory, size_t uiSize)		{ g_uiBench_Allocations++; return __real_realloc(pMemory, uiSize); }
+
+
+
+static uint64_t Bench_Now_ns(void)
+{
+	struct timespec sNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &sNow);
+	return ((uint64_t) sNow.tv_sec * 1000000000ULL) + (uint64_t) sNow.tv_nsec;
+}
+
+
+static void Bench_Fill_Inputs(void)
+{
+	// fixed inputs... a spread of DS18B20 readings from -40C to 125C, a noisy ADC channel, the kinds of
+	// events the temperature task actually logs
+	uint32_t i, j;
+	uint32_t ui32Seed = 12345;
+
+	for (i = 0; i < BENCH_INPUTS; i++)
+	{
+		int16_t i16Raw = (int16_t) (-640 + (int32_t) ((i * 2640) / BENCH_INPUTS) + (int32_t) (i % 16));
+
+		a_ui8Bench_Scratchpad[i][0] = (uint8_t) (i16Raw & 0xFF);
+		a_ui8Bench_Scratchpad[i][1] = (uint8_t) ((uint16_t) i16Raw >> 8);
+		a_ui8Bench_Scratchpad[i][2] = 0x4A;
+		a_ui8Bench_Scratchpad[i][3] = 0x43;
+		a_ui8Bench_Scratchpad[i][4] = 0x1F | ((i & 0x03) << 5);
+		a_ui8Bench_Scratchpad[i][5] = 0xFF;
+		a_ui8Bench_Scratchpad[i][6] = 0x0C;
+		a_ui8Bench_Scratchpad[i][7] = 0x10;
+		a_ui8Bench_Scratchpad[i][8] = Acquisition_CRC8(a_ui8Bench_Scratchpad[i], 8);
+
+		a_ui8Bench_Celsius[i][0] = (uint8_t) ((i * 7) % 126);
+		a_ui8Bench_Celsius[i][1] = (uint8_t) (i % 10);
+		a_ui8Bench_Celsius[i][2] = (uint8_t) ((i % 5) == 0);
+
+		for (j = 0; j < BENCH_ADC_SAMPLES; j++)
+		{
+			ui32Seed = (ui32Seed * 1103515245) + 12345;
+			a_ui16Bench_Samples[i][j] = (uint16_t) ((i * 61) + ((ui32Seed >> 16) & 0x3F));
+		}
+
+		a_sBench_Event[i].ui32Timestamp = 1000 + (i * 997);
+		a_sBench_Event[i].szMessage = "Bench";
+		a_sBench_Event[i].ui32ErrorCode = (i & 1) ? 2005 : 16384;
+		a_sBench_Event[i].ui32Extended = i * 3;
+		a_sBench_Event[i].ui16Location = (uint16_t) (2000 + i);
+		a_sBench_Event[i].ui8Probe = (uint8_t) (i % 16);
+		a_sBench_Event[i].ui8Source = (uint8_t) (i & 1);
+	}
+}
+
+
+static uint32_t Bench_CRC8(uint32_t uiIndex)
+{
+	return Acquisition_CRC8(a_ui8Bench_Scratchpad[uiIndex & BENCH_INPUT_MASK], 8);
+}
+
+
+static uint32_t Bench_Decode(uint32_t uiIndex)
+{
+	uint8_t* pScratchpad = a_ui8Bench_Scratchpad[uiIndex & BENCH_INPUT_MASK];
+	uint8_t ui8Whole, ui8Fraction, ui8Sign;
+
+	Acquisition_Decode_Temperature(pScratchpad[0], pScratchpad[1], a_ui8Bench_Resolution_Mask[(pScratchpad[4] >> 5) & 0x03],
+								   &ui8Whole, &ui8Fraction, &ui8Sign);
+
+	return ((uint32_t) ui8Whole << 16) | ((uint32_t) ui8Fraction << 8) | ui8Sign;
+}
+
+
+static uint32_t Bench_Fahrenheit(uint32_t uiIndex)
+{
+	uint8_t* pCelsius = a_ui8Bench_Celsius[uiIndex & BENCH_INPUT_MASK];
+	uint8_t ui8Whole, ui8Fraction, ui8Sign;
+
+	Acquisition_Celsius_To_Fahrenheit(pCelsius[0], pCelsius[1], pCelsius[2], &ui8Whole, &ui8Fraction, &ui8Sign);
+
+	return ((uint32_t) ui8Whole << 16) | ((uint32_t) ui8Fraction << 8) | ui8Sign;
+}
+
+
+static uint32_t Bench_Trimmed_Mean(uint32_t uiIndex)
+{
+	// one channel's worth, the way ADC_Get_Data() feeds it
+	uint16_t* pSamples = a_ui16Bench_Samples[uiIndex & BENCH_INPUT_MASK];
+	Acquisition_Trim sTrim;
+	uint32_t i;
+
+	Acquisition_Trim_Reset(&sTrim);
+	for (i = 0; i < BENCH_ADC_SAMPLES; i++) Acquisition_Trim_Add(&sTrim, pSamples[i]);
+
+	return Acquisition_Trimmed_Mean(&sTrim);
+}
+
+
+static uint32_t Bench_Format_Event(uint32_t uiIndex)
+{
+	static const char* a_szSource[EVENT_LOG_MAX_SOURCES] = { "TEMP", "ADC" };
+	Event_Record* pRecord = &a_sBench_Event[uiIndex & BENCH_INPUT_MASK];
+	char szBuffer[EVENT_LOG_FORMAT_SIZE];
+	uint32_t ui32Hash = 2166136261u;
+	uint32_t i;
+
+	Acquisition_Format_Event(pRecord, a_szSource[pRecord->ui8Source], szBuffer);
+
+	for (i = 0; szBuffer[i]; i++) ui32Hash = (ui32Hash ^ (uint8_t) szBuffer[i]) * 16777619u;
+
+	return ui32Hash;
+}
+
+
+static uint32_t Bench_Size(Bench_Result* pResult)
+{
+	// checksum and allocations over one pass of the inputs, then the ops for a run of about BENCH_RUN_NS
+	uint32_t uiOps = 1024;
+	uint32_t i;
+
+	pResult->ui32Checksum = 0;
+	g_uiBench_Allocations = 0;
+
+	for (i = 0; i < BENCH_INPUTS; i++) pResult->ui32Checksum = (pResult->ui32Checksum * 31) + pResult->pKernel(i);
+
+	pResult->dAllocations_Per_Op = (double) g_uiBench_Allocations / BENCH_INPUTS;
+	pResult->dNs_Per_Op = 1e30;
+
+	for (;;)
+	{
+		uint64_t ui64Start = Bench_Now_ns();
+		for (i = 0; i < uiOps; i++) g_ui32Bench_Sink += pResult->pKernel(i);
+		if ((Bench_Now_ns() - ui64Start) >= BENCH_RUN_NS) break;
+		uiOps *= 2;
+	}
+
+	return uiOps;
+}
+
+
+static void Bench_Measure(Bench_Result* pResult, uint32_t uiOps)
+{
+	// one run, the best one is kept
+	uint32_t i;
+
+	uint64_t ui64Start = Bench_Now_ns();
+	for (i = 0; i < uiOps; i++) g_ui32Bench_Sink += pResult->pKernel(i);
+	double dNs = (double) (Bench_Now_ns() - ui64Start) / uiOps;
+
+	if (dNs < pResult->dNs_Per_Op) pResult->dNs_Per_Op = dNs;
+}
+
+
+static uint32_t Bench_Compare(const char* szFile, Bench_Result* a_sResults, uint32_t uiCount, uint32_t uiThreshold)
+{
+	// returns the number of regressions
+	char szLine[128];
+	char szName[64];
+	double dBaseline;
+	uint32_t ui32Checksum;
+	uint32_t uiRegressions = 0;
+	uint32_t a_uiFound[BENCH_MAX_KERNELS] = {0};
+	uint32_t i;
+
+	FILE* pFile = fopen(szFile, "r");
+	if (pFile == NULL)
+	{
+		printf("Unable to open %s\n", szFile);
+		return 1;
+	}
+
+	while (fgets(szLine, sizeof(szLine), pFile))
+	{
+		if ((szLine[0] == '#') || (sscanf(szLine, "%63s %lf %x", szName, &dBaseline, &ui32Checksum) != 3)) continue;
+
+		for (i = 0; i < uiCount; i++)
+		{
+			if (strcmp(szName, a_sResults[i].szName) != 0) continue;
+
+			double dLimit = dBaseline * (100 + uiThreshold) / 100;
+			uint32_t uiSlow = (a_sResults[i].dNs_Per_Op > dLimit);
+			uint32_t uiWrong = (a_sResults[i].ui32Checksum != ui32Checksum);
+			uint32_t uiAllocates = (a_sResults[i].dAllocations_Per_Op != 0);
+
+			printf("%-22s %10.2f ns/op  baseline %10.2f  %+6.1f%%  %s%s%s%s\n", szName, a_sResults[i].dNs_Per_Op, dBaseline,
+					((a_sResults[i].dNs_Per_Op - dBaseline) * 100) / dBaseline,
+					(uiSlow || uiWrong || uiAllocates) ? "FAIL" : "pass",
+					uiSlow ? " (slower)" : "", uiWrong ? " (checksum)" : "", uiAllocates ? " (allocates)" : "");
+
+			if (uiSlow || uiWrong || uiAllocates) uiRegressions++;
+			a_uiFound[i] = true;
+		}
+	}
+
+	fclose(pFile);
+
+	for (i = 0; i < uiCount; i++)
+	{
+		if (a_uiFound[i] == false) printf("%-22s no baseline\n", a_sResults[i].szName);
+	}
+
+	return uiRegressions;
+}
+
+
+static void Bench_Write(const char* szFile, Bench_Result* a_sResults, uint32_t uiCount)
+{
+	uint32_t i;
+
+	FILE* pFile = fopen(szFile, "w");
+	if (pFile == NULL)
+	{
+		printf("Unable to write %s\n", szFile);
+		return;
+	}
+
+	fprintf(pFile, "# Acquisition_Bench baselines - name, ns/op (best of %u runs), result checksum\n", BENCH_RUNS);
+	fprintf(pFile, "# only comparable on the machine and compiler that wrote them\n");
+
+	for (i = 0; i < uiCount; i++)
+	{
+		fprintf(pFile, "%s %.2f 0x%08x\n", a_sResults[i].szName, a_sResults[i].dNs_Per_Op, a_sResults[i].ui32Checksum);
+	}
+
+	fclose(pFile);
+	printf("Baselines written to %s\n", szFile);
+}
+
+
+int main(int argc, char* argv[])
+{
+	Bench_Result a_sResults[] = { { "crc8_scratchpad",		Bench_CRC8,			0, 0, 0 },
+								  { "decode_temperature",	Bench_Decode,		0, 0, 0 },
+								  { "celsius_to_fahrenheit",	Bench_Fahrenheit,	0, 0, 0 },
+								  { "adc_trimmed_mean",		Bench_Trimmed_Mean,	0, 0, 0 },
+								  { "format_event",			Bench_Format_Event,	0, 0, 0 } };
+	uint32_t uiCount = sizeof(a_sResults) / sizeof(a_sResults[0]);
+	const char* szCompare = NULL;
+	const char* szWrite = NULL;
+	uint32_t uiThreshold = BENCH_THRESHOLD_DEFAULT;
+	int i;
+
+	for (i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "-c") == 0) && (i + 1 < argc)) szCompare = argv[++i];
+		else if ((strcmp(argv[i], "-w") == 0) && (i + 1 < argc)) szWrite = argv[++i];
+		else if ((strcmp(argv[i], "-t") == 0) && (i + 1 < argc)) uiThreshold = (uint32_t) atoi(argv[++i]);
+	}
+
+	Bench_Fill_Inputs();
+
+	uint32_t a_uiOps[BENCH_MAX_KERNELS];
+	uint32_t uiRun;
+
+	for (i = 0; i < (int) uiCount; i++) a_uiOps[i] = Bench_Size(&a_sResults[i]);
+
+	// the kernels take turns, so a slow patch on the machine doesn't land on just one of them
+	for (uiRun = 0; uiRun < BENCH_RUNS; uiRun++)
+	{
+		for (i = 0; i < (int) uiCount; i++) Bench_Measure(&a_sResults[i], a_uiOps[i]);
+	}
+
+
+	if (szCompare)
+	{
+		uint32_t uiRegressions = Bench_Compare(szCompare, a_sResults, uiCount, uiThreshold);
+
+		printf("%u regression(s), threshold %u%%\n", uiRegressions, uiThreshold);
+		return uiRegressions ? 1 : 0;
+	}
+
+	for (i = 0; i < (int) uiCount; i++)
+	{
+		printf("%-22s %10.2f ns/op  %4.1f allocations/op  checksum 0x%08x\n", a_sResults[i].szName,
+				a_sResults[i].dNs_Per_Op, a_sResults[i].dAllocations_Per_Op, a_sResults[i].ui32Checksum);
+	}
+
+	if (szWrite) Bench_Write(szWrite, a_sResults, uiCount);
+
+	return 0;
+}
+
+#endif
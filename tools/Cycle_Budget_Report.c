@@ -0,0 +1,150 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// PC report of the cycle budget (Cycle_Budget.c) for any acquisition configuration.
+//
+// This is a PC program, it is not part of the board build.
+//     gcc -O2 -DCYCLE_BUDGET_MODEL_ONLY -I.. -o cycle_budget Cycle_Budget_Report.c ../Cycle_Budget.c
+//     ./cycle_budget [-p probes] [-s adc samples] [-d poll delay us] [-o transfer cpu us] [-h hold ms] [bits] [kHz]
+//
+// With no bits / kHz every resolution at 100 and 400 kHz is listed.  For each one the best, typical and
+// worst case cycle is broken down into I2C, 1-Wire wait, conversion and CPU, and the worst case is
+// checked against the control period... the same check the board makes on its EEPROM settings at boot.
+// The hold defaults to the DS18B20 conversion time, give -h if the board's g_ui_Temperature_Clock_Delay[]
+// is different.  The CPU defaults are estimates, Cycle_Budget_Report() on the board shows the measured
+// phases to set them from.
+//
+// Exits 1 if any configuration listed is over the period, so it can gate a configuration change.
+//
+//*****************************************************************************
+
+#if !defined(__TI_COMPILER_VERSION__)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Cycle_Budget.h"
+
+
+typedef struct
+{
+	uint32_t uiProbes;
+	uint32_t uiADC_Samples;
+	uint32_t uiPoll_Delay_us;
+	uint32_t uiTransfer_CPU_us;
+	uint32_t uiHold_ms;
+	uint32_t uiSet;                         // which of the above were given
+} Report_Options;
+
+#define OPTION_PROBES						0x01
+#define OPTION_SAMPLES						0x02
+#define OPTION_POLL_DELAY					0x04
+#define OPTION_TRANSFER_CPU					0x08
+#define OPTION_HOLD							0x10
+
+
+
+static void Report_Line(const char* szCase, const Cycle_Budget_Breakdown* pBreakdown)
+{
+	printf("  %-8s %8u us   I2C %7u  1-Wire %7u  Conversion %7u  CPU %7u   (%u transfers)\n",
+			szCase, pBreakdown->ui32Total_us, pBreakdown->ui32I2C_us, pBreakdown->ui32One_Wire_us,
+			pBreakdown->ui32Conversion_us, pBreakdown->ui32CPU_us, pBreakdown->ui32Transfers);
+}
+
+
+static uint32_t Report_Configuration(uint32_t uiBits, uint32_t uiBit_Rate_kHz, const Report_Options* pOptions)
+{
+	// 1 if the worst case is over the period
+	Cycle_Budget_Config sConfig;
+	Cycle_Budget_Estimate sEstimate;
+
+	Cycle_Budget_Default_Config(&sConfig, uiBits - 9, uiBit_Rate_kHz);
+
+	if (pOptions->uiSet & OPTION_PROBES) sConfig.uiProbes = pOptions->uiProbes;
+	if (pOptions->uiSet & OPTION_SAMPLES) sConfig.uiADC_Samples = pOptions->uiADC_Samples;
+	if (pOptions->uiSet & OPTION_POLL_DELAY) sConfig.uiPoll_Delay_ns = pOptions->uiPoll_Delay_us * 1000;
+	if (pOptions->uiSet & OPTION_TRANSFER_CPU) sConfig.uiTransfer_CPU_ns = pOptions->uiTransfer_CPU_us * 1000;
+	if (pOptions->uiSet & OPTION_HOLD) sConfig.uiHold_ms = pOptions->uiHold_ms;
+
+	Cycle_Budget_Estimate_Cycle(&sConfig, &sEstimate);
+	uint32_t uiOver = (Cycle_Budget_Check(&sConfig, CYCLE_BUDGET_PERIOD_MS) != 0);
+
+	printf("\n%u bits, %u kHz, %u probes, %u x %u ADC samples, hold %u ms, poll delay %u us, %u us driver a transfer\n",
+			uiBits, uiBit_Rate_kHz, sConfig.uiProbes, sConfig.uiADC_Channels, sConfig.uiADC_Samples, sConfig.uiHold_ms,
+			sConfig.uiPoll_Delay_ns / 1000, sConfig.uiTransfer_CPU_ns / 1000);
+	Report_Line("Best", &sEstimate.sBest);
+	Report_Line("Typical", &sEstimate.sTypical);
+	Report_Line("Worst", &sEstimate.sWorst);
+	printf("  %s, worst case is %u%% of the %u ms period\n", uiOver ? "REFUSED" : "OK",
+			(uint32_t) (((uint64_t) sEstimate.sWorst.ui32Total_us * 100) / (CYCLE_BUDGET_PERIOD_MS * 1000)), CYCLE_BUDGET_PERIOD_MS);
+
+	return uiOver;
+}
+
+
+int main(int argc, char* argv[])
+{
+	Report_Options sOptions;
+	uint32_t uiBits = 0;
+	uint32_t uiBit_Rate_kHz = 0;
+	uint32_t uiOver = 0;
+	uint32_t uiPositional = 0;
+	int i;
+
+	memset(&sOptions, 0, sizeof(sOptions));
+
+	for (i = 1; i < argc; i++)
+	{
+		if ((argv[i][0] == '-') && (i + 1 < argc))
+		{
+			uint32_t uiValue = (uint32_t) atoi(argv[i + 1]);
+
+			switch (argv[i][1])
+			{
+				case 'p': sOptions.uiProbes = uiValue;          sOptions.uiSet |= OPTION_PROBES;       break;
+				case 's': sOptions.uiADC_Samples = uiValue;     sOptions.uiSet |= OPTION_SAMPLES;      break;
+				case 'd': sOptions.uiPoll_Delay_us = uiValue;   sOptions.uiSet |= OPTION_POLL_DELAY;   break;
+				case 'o': sOptions.uiTransfer_CPU_us = uiValue; sOptions.uiSet |= OPTION_TRANSFER_CPU; break;
+				case 'h': sOptions.uiHold_ms = uiValue;         sOptions.uiSet |= OPTION_HOLD;         break;
+				default:
+					printf("Unknown option %s\n", argv[i]);
+					return 2;
+			}
+
+			i++;
+			continue;
+		}
+
+		if (uiPositional == 0) uiBits = (uint32_t) atoi(argv[i]);
+		else if (uiPositional == 1) uiBit_Rate_kHz = (uint32_t) atoi(argv[i]);
+		uiPositional++;
+	}
+
+	printf("Cycle budget, control period %u ms\n", CYCLE_BUDGET_PERIOD_MS);
+
+	if (uiBits)
+	{
+		if ((uiBits < 9) || (uiBits > 12))
+		{
+			printf("Resolution is 9 to 12 bits\n");
+			return 2;
+		}
+
+		uiOver = Report_Configuration(uiBits, uiBit_Rate_kHz ? uiBit_Rate_kHz : 100, &sOptions);
+	}
+	else
+	{
+		for (uiBits = 9; uiBits <= 12; uiBits++)
+		{
+			uiOver |= Report_Configuration(uiBits, 100, &sOptions);
+			uiOver |= Report_Configuration(uiBits, 400, &sOptions);
+		}
+	}
+
+	return uiOver ? 1 : 0;
+}
+
+#endif
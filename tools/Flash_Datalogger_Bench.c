@@ -0,0 +1,166 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// PC bench for Flash_Datalogger.c against the file backed flash emulator.
+//
+// This is a PC program, it is not part of the board build.
+//     gcc -O2 -DFLASH_DATALOGGER_EMULATOR -I.. -o flash_bench Flash_Datalogger_Bench.c ../Flash_Datalogger.c
+//     ./flash_bench [days] [flash file]
+//
+// Logs a temperature sized and a dish sized record every 2 minutes of simulated time for the given
+// number of days (default 30), remounting now and then the way a reset would.  Then it checks the most
+// recent records read back correctly and prints the write rate, the page writes, and the erase counts
+// of every segment (they should all be within one of each other).
+//
+//*****************************************************************************
+
+#if !defined(__TI_COMPILER_VERSION__)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "Flash_Datalogger.h"
+
+
+#define BENCH_TEMPERATURE_BYTES				61
+#define BENCH_DISH_BYTES					34
+#define BENCH_RECORDS_PER_DAY				(2 * 720)      // one pair every 2 minutes
+#define BENCH_REMOUNT_EVERY					5000
+
+
+static void Bench_Fill(uint8_t* pRecord, uint32_t uiLength, uint32_t uiNumber)
+{
+	uint32_t i;
+
+	for (i = 0; i < uiLength; i++) pRecord[i] = (uint8_t) ((uiNumber * 31) + i);
+	memcpy(pRecord, &uiNumber, sizeof(uiNumber));
+}
+
+
+int main(int argc, char* argv[])
+{
+	uint32_t uiDays = 30;
+	const char* szFile = (argc > 2) ? argv[2] : "flash_log.bin";
+	uint8_t a_ui8Record[FLASH_LOG_MAX_RECORD];
+	uint8_t a_ui8Read[FLASH_LOG_MAX_RECORD];
+	uint32_t uiRecords;
+	uint32_t uiLength;
+	uint32_t uiError;
+	uint32_t i;
+	clock_t tStart;
+	double dSeconds;
+	Flash_Datalogger_Counters sCounters;
+	char* pEnd;
+
+	if (argc > 1)
+	{
+		// atoi() took "abc" as 0 days and passed without logging anything
+		unsigned long ulDays = strtoul(argv[1], &pEnd, 10);
+
+		if ((argv[1][0] < '0') || (argv[1][0] > '9') || (*pEnd != '\0') || (ulDays == 0) || (ulDays > 3650))
+		{
+			printf("days has to be a number from 1 to 3650: %s\n", argv[1]);
+			return 1;
+		}
+
+		uiDays = (uint32_t) ulDays;
+	}
+
+	uiRecords = uiDays * BENCH_RECORDS_PER_DAY;
+
+	remove(szFile);
+
+	if (Flash_Emulator_Open(szFile) == 0)
+	{
+		perror(szFile);
+		return 1;
+	}
+
+	uiError = Flash_Datalogger_Mount();
+	if (uiError)
+	{
+		printf("mount failed: %u\n", uiError);
+		return 1;
+	}
+
+	tStart = clock();
+
+	for (i = 0; i < uiRecords; i++)
+	{
+		uiLength = (i & 1) ? BENCH_DISH_BYTES : BENCH_TEMPERATURE_BYTES;
+		Bench_Fill(a_ui8Record, uiLength, i);
+
+		uiError = Flash_Datalogger_Append(a_ui8Record, uiLength);
+		if (uiError)
+		{
+			printf("append %u failed: %u\n", i, uiError);
+			return 1;
+		}
+
+		if ((i % BENCH_REMOUNT_EVERY) == (BENCH_REMOUNT_EVERY - 1))
+		{
+			Flash_Datalogger_Flush();
+			Flash_Datalogger_Mount();
+		}
+	}
+
+	Flash_Datalogger_Flush();
+
+	dSeconds = (double) (clock() - tStart) / CLOCKS_PER_SEC;
+
+	// reset, then read the newest records back
+	Flash_Datalogger_Mount();
+
+	uint32_t uiChecked = 0;
+	uint32_t uiBad = 0;
+
+	for (i = 0; i < 64; i++)
+	{
+		uint32_t uiNumber = uiRecords - 1 - i;
+
+		if (Flash_Datalogger_Get_Recent(i, a_ui8Read, sizeof(a_ui8Read), &uiLength) != 0) break;
+
+		Bench_Fill(a_ui8Record, (uiNumber & 1) ? BENCH_DISH_BYTES : BENCH_TEMPERATURE_BYTES, uiNumber);
+
+		if ((uiLength != ((uiNumber & 1) ? BENCH_DISH_BYTES : BENCH_TEMPERATURE_BYTES)) || memcmp(a_ui8Read, a_ui8Record, uiLength)) uiBad++;
+		uiChecked++;
+	}
+
+	Flash_Datalogger_Get_Counters(&sCounters);
+
+	printf("records:        %u (%u days)\n", uiRecords, uiDays);
+	printf("host time:      %.3f s  (%.0f records/s)\n", dSeconds, uiRecords / (dSeconds > 0 ? dSeconds : 1e-9));
+	printf("read back:      %u checked, %u bad\n", uiChecked, uiBad);
+	printf("sequence:       %u  segment %u  free %u\n", sCounters.ui32Current_Sequence, sCounters.ui32Current_Segment, sCounters.ui32Free_In_Segment);
+
+	// erase counts straight from the segment headers
+	FILE* pFile = fopen(szFile, "rb");
+	uint32_t uiMin = 0xFFFFFFFF;
+	uint32_t uiMax = 0;
+
+	printf("erase counts:  ");
+	for (i = 0; i < FLASH_LOG_SEGMENTS; i++)
+	{
+		uint32_t a_ui32Header[4];
+
+		fseek(pFile, i * FLASH_LOG_SEGMENT_SIZE, SEEK_SET);
+		if (fread(a_ui32Header, sizeof(a_ui32Header), 1, pFile) != 1) break;
+		if (a_ui32Header[0] != 0x584C4F47) continue;      // never used
+
+		printf(" %u", a_ui32Header[2]);
+		if (a_ui32Header[2] < uiMin) uiMin = a_ui32Header[2];
+		if (a_ui32Header[2] > uiMax) uiMax = a_ui32Header[2];
+	}
+	printf("\nerase spread:   %u\n", uiMax - uiMin);
+
+	fclose(pFile);
+	Flash_Emulator_Close();
+
+	return (uiBad || (uiChecked == 0)) ? 1 : 0;
+}
+
+#endif
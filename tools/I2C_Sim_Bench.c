@@ -0,0 +1,395 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// PC bench for the acquisition firmware against the bus simulator in I2C_Sim.c.
+//
+// This is a PC program, it is not part of the board build.  The firmware modules are built as they are,
+// I2C_HAL.h sends them to the simulator and tools/host has stand-ins for the TI-RTOS and board headers.
+//     gcc -O2 -DI2C_HAL_SIMULATOR -Ihost -I.. -o i2c_bench I2C_Sim_Bench.c host/Host_RTOS.c ../I2C_Sim.c
+//         ../Temperature_Interface.c ../ADC_Interface.c ../I2C_Scheduler.c ../I2C_Trace.c ../Event_Log.c
+//         ../Temperature_Snapshot.c ../Temperature_History.c ../Temperature_Estimator.c ../Job_Scheduler.c
+//         ../Cycle_Budget.c ../Boot_Timing.c ../Acquisition_Kernels.c ../Solar_Position.c
+//     ./i2c_bench [-r console capture | -c console capture] [busy poll delay us] [resolution bits] [driver overhead us]
+//
+// Runs the real Temperature_Initiate(), the conversion hold the firmware asks the job scheduler for,
+// Temperature_Get() and ADC_Get_Data(), the same as the one second job does on the board.  The first
+// cycles configure the probes and read their ROM codes, once every probe is configured and has its ROM
+// code the next cycle is the steady state one that is measured.
+//
+// It does that at 100 and 400 kHz and prints the simulated time of each pass and the wire time,
+// 1-Wire time, transfers and busy polls of each bus.  The temperatures and dish channels the firmware
+// published are checked against what the simulated parts were set to.
+//
+// Then the budget model (Cycle_Budget.c) is checked against that run.  Its configuration is the one the
+// firmware checks its settings with, Cycle_Budget_Board_Config(), from the same globals the run used.
+// Only the CPU time is the simulator's... the driver overhead a transfer and nothing for the compute.
+// Without the conversion hold:
+//     the typical estimate has to be within BENCH_MODEL_TOLERANCE_PERCENT of the measured cycle
+//     the worst case has to cover the first warm up cycle, the one that configures and reads ROM codes
+//     the best case can't be over the measured cycle
+// If any of them fail the model no longer follows the firmware, it says which and exits 1.
+//
+// The busy poll delay is the firmware's g_ui_0001_Second, so it moves the firmware and the model together.
+//
+// -r replays an I2C_Trace_Dump() from the board through the measured cycle (I2C_Sim_Load_Trace()), the
+// capture answers for the parts until the firmware and the board's part ways.  It's the real
+// Temperature_Interface.c and ADC_Interface.c that decode it, so the temperatures printed are what the
+// firmware made of the board's bytes, not the simulated parts'.  The parts are set 20 C (and 250 ADC
+// counts) off the usual spread for a replay, a reading that still comes from them says the replay
+// didn't cover it.  The replay line says
+// how far it got and the recorded and simulated time for that stretch.
+//
+// -c (built with -DI2C_TRACE as well) writes the I2C_Trace_Dump() of the 100 kHz measured cycle to the
+// file, the same lines the board prints... -r can take it back, a check of the capture and replay
+// without a board.
+//
+//*****************************************************************************
+
+#if !defined(__TI_COMPILER_VERSION__)
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <xdc/std.h>
+#include <ti/drivers/I2C.h>
+
+#include "constants.h"
+#include "globals.h"
+
+#include "I2C_Sim.h"
+#include "I2C_Scheduler.h"
+#include "Job_Scheduler.h"
+#include "Event_Log.h"
+#include "Temperature_Snapshot.h"
+#include "Cycle_Budget.h"
+#include "I2C_Trace.h"
+#include "Telemetry.h"
+
+
+#define BENCH_ADC_CHANNELS					8      // the dish photo-resistors, H 0-3 and V 4-7
+#define BENCH_WARM_UP_CYCLES				10     // configure and ROM codes, normally 4 at 2 ROM reads a chip
+#define BENCH_CYCLE_MS						1000   // the one second job
+#define BENCH_REPLAY_OFFSET					320    // 20 C in sixteenths, the parts during a replay
+#define BENCH_REPLAY_ADC_OFFSET				250    // counts, the same for the dish channels
+#define BENCH_MODEL_TOLERANCE_PERCENT		2      // typical estimate against the measured cycle
+
+
+// from Temperature_Interface.c
+void Temperature_Initialize(uint32_t uiResolution);
+void Temperature_Initiate(void);
+void Temperature_Get(void);
+uint32_t Temperature_Resolution_Fallback(uint32_t uiResolution);
+extern uint32_t g_uiResolutionIndex;
+
+// from ADC_Interface.c
+void ADC_Get_Data(void);
+
+
+const char* g_szBench_Trace;              // -r
+const char* g_szBench_Capture;            // -c
+uint32_t g_uiBench_Model_Failures;
+
+
+
+static void Bench_Hold(void)
+{
+	// the firmware arms JOB_TEMPERATURE_HOLD, the bench waits it out itself
+}
+
+
+static uint32_t Bench_Setup(uint32_t uiBit_Rate_kHz, uint32_t uiResolution)
+{
+	// what Driver_Setup() does for the acquisition, in the same order... returns the resolution the
+	// probes run at, under the setting when the setting doesn't fit the cycle budget
+	uint32_t i;
+
+	Job_Scheduler_Initialize();
+	I2C_Scheduler_Initialize();
+
+	for (i = 0; i < I2C_MAX_BUSES; i++)
+	{
+		I2C_Scheduler_Configure_Bus_Speed(i, uiBit_Rate_kHz == 400);
+	}
+
+	I2C_Scheduler_Open_Bus(I2C_BUS_TEMPERATURE_0_7, I2C_BUS_TEMPERATURE_0_7);
+	I2C_Scheduler_Open_Bus(I2C_BUS_TEMPERATURE_8_15, I2C_BUS_TEMPERATURE_8_15);
+	I2C_Scheduler_Open_Bus(I2C_BUS_ADC, I2C_BUS_ADC);
+
+	Job_Scheduler_Define_One_Shot(JOB_TEMPERATURE_HOLD, "Temperature Hold", Bench_Hold, g_ui_Temperature_Clock_Delay[Temperature_Resolution_Fallback(uiResolution)], JOB_NO_BUDGET);
+
+	// the whole cycle every time, the bench is measuring it not protecting it
+	Cycle_Budget_Set_Degrade_Enable(false);
+
+	g_s_EEPROM_Data.uiTemperatureResolution = uiResolution + TEMP_RES_BASE_OFFSET;
+	Temperature_Initialize(uiResolution);
+
+	return g_uiResolutionIndex;
+}
+
+
+static void Bench_Cycle(uint64_t* pInitiate_ns, uint64_t* pGet_ns, uint64_t* pADC_ns)
+{
+	uint64_t ui64Cycle_Start = I2C_Sim_Get_Time_ns();
+
+	Temperature_Initiate();
+	*pInitiate_ns = I2C_Sim_Get_Time_ns() - ui64Cycle_Start;
+
+	// the one shot hold the firmware just armed
+	I2C_Sim_Advance_ns((uint64_t) Job_Scheduler_Get_Period(JOB_TEMPERATURE_HOLD) * 1000000ULL);
+
+	uint64_t ui64Start = I2C_Sim_Get_Time_ns();
+	Temperature_Get();
+	*pGet_ns = I2C_Sim_Get_Time_ns() - ui64Start;
+
+	ui64Start = I2C_Sim_Get_Time_ns();
+	ADC_Get_Data();
+	*pADC_ns = I2C_Sim_Get_Time_ns() - ui64Start;
+
+	// on to the next one second job
+	uint64_t ui64Used = I2C_Sim_Get_Time_ns() - ui64Cycle_Start;
+	if (ui64Used < (BENCH_CYCLE_MS * 1000000ULL)) I2C_Sim_Advance_ns((BENCH_CYCLE_MS * 1000000ULL) - ui64Used);
+}
+
+
+static uint32_t Bench_Ready(void)
+{
+	// every probe configured and with its ROM code... from here on the cycle is the steady state one
+	uint32_t i;
+
+	for (i = 0; i < MAX_TEMPERATURE_PROBES; i++)
+	{
+		if ((g_s_Temperature_Telemetry[i].uiProbe_Configuration_Flag == false) || (g_s_Temperature_Telemetry[i].uiROM_Flag == false)) return false;
+	}
+
+	return true;
+}
+
+
+static int16_t Bench_Temperature(uint32_t uiProbe)
+{
+	// 1/16 degree, what the simulated parts are set to
+	return (int16_t) ((((int32_t) uiProbe * 37) - 100) + 7);
+}
+
+
+static void Bench_Check_Model(uint32_t uiBit_Rate_kHz, uint32_t uiResolution, uint32_t uiOverhead_ns, uint64_t ui64First_ns, uint64_t ui64Steady_ns)
+{
+	// the model the firmware runs on, against what the firmware just did on the simulator
+	Cycle_Budget_Config sConfig;
+	Cycle_Budget_Estimate sEstimate;
+
+	Cycle_Budget_Board_Config(&sConfig, uiResolution, uiBit_Rate_kHz);
+	sConfig.uiTransfer_CPU_ns = uiOverhead_ns;
+	sConfig.uiProbe_CPU_ns = 0;
+	sConfig.uiADC_Channel_CPU_ns = 0;
+	Cycle_Budget_Estimate_Cycle(&sConfig, &sEstimate);
+
+	uint32_t uiBest = sEstimate.sBest.ui32Total_us - sEstimate.sBest.ui32Conversion_us;
+	uint32_t uiTypical = sEstimate.sTypical.ui32Total_us - sEstimate.sTypical.ui32Conversion_us;
+	uint32_t uiWorst = sEstimate.sWorst.ui32Total_us - sEstimate.sWorst.ui32Conversion_us;
+	uint32_t uiSteady = (uint32_t) (ui64Steady_ns / 1000);
+	uint32_t uiFirst = (uint32_t) (ui64First_ns / 1000);
+
+	printf("Cycle Budget Best: %u us   Typical: %u us   Worst: %u us   (%u transfers)\n", uiBest, uiTypical, uiWorst, sEstimate.sTypical.ui32Transfers);
+	printf("Simulated: %u us   First Warm Up Cycle: %u us\n", uiSteady, uiFirst);
+
+	uint32_t uiDifference = (uiTypical > uiSteady) ? (uiTypical - uiSteady) : (uiSteady - uiTypical);
+
+	if (((uint64_t) uiDifference * 100) > ((uint64_t) uiSteady * BENCH_MODEL_TOLERANCE_PERCENT))
+	{
+		printf("MODEL MISMATCH: typical is %u us off the simulated cycle, over %u%%\n", uiDifference, BENCH_MODEL_TOLERANCE_PERCENT);
+		g_uiBench_Model_Failures++;
+	}
+
+	if (uiFirst > uiWorst)
+	{
+		printf("MODEL MISMATCH: the first cycle is over the worst case by %u us\n", uiFirst - uiWorst);
+		g_uiBench_Model_Failures++;
+	}
+
+	if (uiBest > uiSteady)
+	{
+		printf("MODEL MISMATCH: the best case is over the simulated cycle by %u us\n", uiBest - uiSteady);
+		g_uiBench_Model_Failures++;
+	}
+}
+
+
+static void Bench_Run(uint32_t uiBit_Rate_kHz, uint32_t uiResolution, uint32_t uiOverhead_ns)
+{
+	int16_t a_i16Expected_Tenths[MAX_TEMPERATURE_PROBES];
+	uint64_t ui64Initiate, ui64Get, ui64ADC;
+	uint64_t ui64First_ns = 0;
+	uint32_t uiWarm_Up;
+	uint32_t i;
+
+	I2C_Sim_Reset();
+	I2C_Sim_Set_Transfer_Overhead_ns(uiOverhead_ns);
+
+	// a spread of temperatures, some below zero
+	for (i = 0; i < MAX_TEMPERATURE_PROBES; i++)
+	{
+		I2C_Sim_Set_Probe(i / 8, i % 8, true, (int16_t) (Bench_Temperature(i) + ((g_szBench_Trace != NULL) ? BENCH_REPLAY_OFFSET : 0)));
+	}
+
+	for (i = 0; i < BENCH_ADC_CHANNELS; i++) I2C_Sim_Set_ADC(i, (uint16_t) ((i * 500) + 100 + ((g_szBench_Trace != NULL) ? BENCH_REPLAY_ADC_OFFSET : 0)));
+
+	uint32_t uiRunning = Bench_Setup(uiBit_Rate_kHz, uiResolution);
+
+	// the expected values drop the bits the resolution the probes run at doesn't have
+	for (i = 0; i < MAX_TEMPERATURE_PROBES; i++)
+	{
+		int32_t i32Masked = (int16_t) ((uint16_t) Bench_Temperature(i) & (uint16_t) (0xFFFF << (3 - uiRunning)));
+		a_i16Expected_Tenths[i] = (int16_t) ((i32Masked * 10) / 16);
+	}
+
+	for (uiWarm_Up = 0; (uiWarm_Up < BENCH_WARM_UP_CYCLES) && (Bench_Ready() == false); uiWarm_Up++)
+	{
+		Bench_Cycle(&ui64Initiate, &ui64Get, &ui64ADC);
+
+		if (uiWarm_Up == 0) ui64First_ns = ui64Initiate + ui64Get + ui64ADC;
+	}
+
+	// what the warm up logged isn't this cycle's
+	while (Event_Log_Drain(EVENT_LOG_MAX_SOURCES * 64));
+
+
+	I2C_Sim_Reset_Counters();
+
+	// the capture starts at the top of a cycle, the warm up above isn't in it
+	if (g_szBench_Trace != NULL)
+	{
+		if (I2C_Sim_Load_Trace(g_szBench_Trace) == 0) printf("No records in %s\n", g_szBench_Trace);
+	}
+
+#ifdef I2C_TRACE
+	if ((g_szBench_Capture != NULL) && (uiBit_Rate_kHz == 100)) I2C_Trace_Start();
+#endif
+
+	Bench_Cycle(&ui64Initiate, &ui64Get, &ui64ADC);
+
+#ifdef I2C_TRACE
+	if ((g_szBench_Capture != NULL) && (uiBit_Rate_kHz == 100))
+	{
+		// the dump goes out the console on the board, to the file here
+		g_pHost_Telemetry_Output = fopen(g_szBench_Capture, "w");
+		if (g_pHost_Telemetry_Output == NULL) printf("Can't write %s\n", g_szBench_Capture);
+
+		I2C_Trace_Dump();
+
+		if (g_pHost_Telemetry_Output != NULL)
+		{
+			fclose(g_pHost_Telemetry_Output);
+			g_pHost_Telemetry_Output = NULL;
+			printf("%u I2C_Trace records written to %s\n", I2C_Trace_Get_Count(), g_szBench_Capture);
+		}
+	}
+#endif
+
+	uint32_t uiEvents = Event_Log_Drain(EVENT_LOG_MAX_SOURCES * 64);
+
+
+	// what the firmware published
+	Temperature_Snapshot sSnapshot;
+	Temperature_Snapshot_Read(&sSnapshot);
+
+	uint32_t uiGood = 0;
+	uint32_t uiMatch = 0;
+	uint32_t uiFrom_Parts = 0;
+	for (i = 0; i < MAX_TEMPERATURE_PROBES; i++)
+	{
+		if (sSnapshot.a_sProbe[i].ui32Error_Flag != 0) continue;
+
+		uiGood++;
+
+		// the firmware's whole / fraction split may round the last tenth the other way
+		if (abs(sSnapshot.a_sProbe[i].i16Tenths_C - a_i16Expected_Tenths[i]) <= 1) uiMatch++;
+		if (abs(sSnapshot.a_sProbe[i].i16Tenths_C - (a_i16Expected_Tenths[i] + ((BENCH_REPLAY_OFFSET * 10) / 16))) <= 1) uiFrom_Parts++;
+	}
+
+	uint32_t uiADC_Match = 0;
+	uint32_t uiADC_From_Parts = 0;
+	for (i = 0; i < BENCH_ADC_CHANNELS; i++)
+	{
+		uint32_t ui32Reading = (i < MAX_PHOTORESISTOR_RLUP) ? g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_H_Data[i] : g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_V_Data[i - MAX_PHOTORESISTOR_RLUP];
+
+		if (ui32Reading == ((i * 500) + 100)) uiADC_Match++;
+		if (ui32Reading == ((i * 500) + 100 + BENCH_REPLAY_ADC_OFFSET)) uiADC_From_Parts++;
+	}
+
+	printf("\n%u kHz, %u bits, %u ns driver overhead a transfer, %u warm up cycles\n", uiBit_Rate_kHz, uiRunning + 9, uiOverhead_ns, uiWarm_Up);
+	if (uiRunning != uiResolution) printf("%u bits is over the cycle budget, the firmware fell back to %u bits\n", uiResolution + 9, uiRunning + 9);
+	printf("Temperature Initiate: %llu us   Temperature Get: %llu us   ADC Sample Set: %llu us\n",
+			(unsigned long long) (ui64Initiate / 1000), (unsigned long long) (ui64Get / 1000), (unsigned long long) (ui64ADC / 1000));
+	I2C_Sim_Report();
+	if (g_szBench_Trace == NULL)
+	{
+		printf("Probes Read: %u / %u   Temperatures Match: %u   ADC Channels Match: %u / %u   Events Logged: %u\n",
+				uiGood, MAX_TEMPERATURE_PROBES, uiMatch, uiADC_Match, BENCH_ADC_CHANNELS, uiEvents);
+	}
+	else
+	{
+		// what the firmware decoded from the capture... the parts' readings are 20 C off, so they stand out
+		printf("Probes Read: %u / %u   Read From The Simulated Parts: %u probes, %u ADC channels   Events Logged: %u\nReplayed Tenths C:",
+				uiGood, MAX_TEMPERATURE_PROBES, uiFrom_Parts, uiADC_From_Parts, uiEvents);
+		for (i = 0; i < MAX_TEMPERATURE_PROBES; i++)
+		{
+			if (sSnapshot.a_sProbe[i].ui32Error_Flag != 0) printf(" --");
+			else printf(" %d", sSnapshot.a_sProbe[i].i16Tenths_C);
+		}
+		printf("\nReplayed ADC H/V:");
+		for (i = 0; i < BENCH_ADC_CHANNELS; i++)
+		{
+			printf(" %u", (i < MAX_PHOTORESISTOR_RLUP) ? g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_H_Data[i] : g_s_Dish_Movement_Telemetry.MT_a_ui32ADC_V_Data[i - MAX_PHOTORESISTOR_RLUP]);
+		}
+		printf("\n");
+	}
+
+	// a replay's cycle is the board's, the model is only checked against the simulated parts
+	if (g_szBench_Trace == NULL) Bench_Check_Model(uiBit_Rate_kHz, uiRunning, uiOverhead_ns, ui64First_ns, ui64Initiate + ui64Get + ui64ADC);
+
+	if (g_szBench_Trace != NULL) I2C_Sim_Replay_Report();
+}
+
+
+int main(int argc, char* argv[])
+{
+	if ((argc > 2) && (strcmp(argv[1], "-r") == 0))
+	{
+		g_szBench_Trace = argv[2];
+		argc -= 2;
+		argv += 2;
+	}
+	else if ((argc > 2) && (strcmp(argv[1], "-c") == 0))
+	{
+#ifndef I2C_TRACE
+		printf("-c needs the bench built with -DI2C_TRACE\n");
+		return 1;
+#endif
+		g_szBench_Capture = argv[2];
+		argc -= 2;
+		argv += 2;
+	}
+
+	uint32_t uiPoll_us = (argc > 1) ? (uint32_t) atoi(argv[1]) : 100;
+	uint32_t uiBits = (argc > 2) ? (uint32_t) atoi(argv[2]) : 9;
+	uint32_t uiOverhead_us = (argc > 3) ? (uint32_t) atoi(argv[3]) : 0;
+
+	if ((uiBits < 9) || (uiBits > 12)) uiBits = 9;
+
+	// the firmware's busy poll delay, SysCtlDelay() counts at 3 cycles each
+	g_ui_0001_Second = (uint32_t) (((uint64_t) uiPoll_us * I2C_SIM_CPU_HZ) / 3000000);
+
+	printf("Busy poll delay %u us\n", uiPoll_us);
+
+	Bench_Run(100, uiBits - 9, uiOverhead_us * 1000);
+	Bench_Run(400, uiBits - 9, uiOverhead_us * 1000);
+
+	return g_uiBench_Model_Failures ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,298 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host side decoder for the binary telemetry frames from Telemetry_Frame.c.
+//
+// This is a PC program, it is not part of the board build.
+//     gcc -O2 -I.. -o telemetry_decode Telemetry_Decode.c
+//     stty -F /dev/ttyUSB0 57600 raw && ./telemetry_decode /dev/ttyUSB0
+//     ./telemetry_decode capture.bin
+// With no file name it reads stdin.
+//
+// Each frame is split on 0x00, COBS decoded, CRC checked and printed one line per frame.
+// Keyframes print in upper case (TEMP / DISH), delta frames in lower case with only what changed.
+// Frames with a bad CRC, an unknown version or the wrong length are counted and skipped.
+//
+//*****************************************************************************
+
+#if !defined(__TI_COMPILER_VERSION__)
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Telemetry_Frame.h"
+
+
+static const char* a_szHealth[4] = { "OK", "SUSPECT", "QUARANTINED", "?" };
+
+static const char* a_szSample_Mode[4] = { "FAST", "SLOW", "NIGHT", "CORRECTION" };
+
+
+static uint16_t Decode_CRC16(const uint8_t* pData, uint32_t uiLength)
+{
+	// must match Telemetry_Frame_CRC16()... CRC-16/CCITT-FALSE
+	uint16_t ui16CRC = 0xFFFF;
+	uint32_t i, j;
+
+	for (i = 0; i < uiLength; i++)
+	{
+		ui16CRC ^= (uint16_t) (pData[i] << 8);
+
+		for (j = 0; j < 8; j++)
+		{
+			ui16CRC = (ui16CRC & 0x8000) ? (uint16_t) ((ui16CRC << 1) ^ 0x1021) : (uint16_t) (ui16CRC << 1);
+		}
+	}
+
+	return ui16CRC;
+}
+
+
+static uint32_t Decode_COBS(const uint8_t* pEncoded, uint32_t uiLength, uint8_t* pDecoded, uint32_t uiMax)
+{
+	// pEncoded does not include the 0x00 delimiter... returns the decoded length, 0 on a bad frame
+	uint32_t uiRead = 0;
+	uint32_t uiWrite = 0;
+
+	while (uiRead < uiLength)
+	{
+		uint8_t ui8Code = pEncoded[uiRead++];
+		uint32_t i;
+
+		if (ui8Code == 0) return 0;
+
+		for (i = 1; i < ui8Code; i++)
+		{
+			if ((uiRead >= uiLength) || (uiWrite >= uiMax)) return 0;
+			pDecoded[uiWrite++] = pEncoded[uiRead++];
+		}
+
+		if ((ui8Code != 0xFF) && (uiRead < uiLength))
+		{
+			if (uiWrite >= uiMax) return 0;
+			pDecoded[uiWrite++] = 0;
+		}
+	}
+
+	return uiWrite;
+}
+
+
+static uint16_t Get_16(const uint8_t* p)
+{
+	return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+
+static uint32_t Get_32(const uint8_t* p)
+{
+	return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+
+static void Print_Probe(uint32_t uiProbe, const uint8_t* pValue)
+{
+	int16_t i16Tenths = (int16_t) Get_16(pValue);
+	uint8_t ui8Status = pValue[2];
+
+	if ((ui8Status & TELEMETRY_PROBE_VALID) == 0)
+	{
+		printf(" %2u:---", uiProbe);
+		return;
+	}
+
+	printf(" %2u:%s%d.%d%s%s[%s]", uiProbe,
+			(i16Tenths < 0) ? "-" : "",
+			((i16Tenths < 0) ? -i16Tenths : i16Tenths) / 10,
+			((i16Tenths < 0) ? -i16Tenths : i16Tenths) % 10,
+			(ui8Status & TELEMETRY_PROBE_ERROR) ? "!" : "",
+			(ui8Status & TELEMETRY_PROBE_STALE) ? "~" : "",
+			a_szHealth[(ui8Status & TELEMETRY_PROBE_HEALTH_MASK) >> TELEMETRY_PROBE_HEALTH_SHIFT]);
+}
+
+
+static int Print_Temperature(const uint8_t* pPayload, uint32_t uiLength)
+{
+	uint32_t uiCount;
+	uint32_t i;
+
+	if (uiLength < 1) return 0;
+
+	uiCount = pPayload[0];
+	if (uiLength != 1 + (uiCount * TELEMETRY_PROBE_BYTES)) return 0;
+
+	for (i = 0; i < uiCount; i++)
+	{
+		Print_Probe(i, &pPayload[1 + (i * TELEMETRY_PROBE_BYTES)]);
+	}
+
+	printf("\n");
+	return 1;
+}
+
+
+static int Print_Temperature_Delta(const uint8_t* pPayload, uint32_t uiLength)
+{
+	uint32_t uiCount;
+	uint32_t i;
+
+	if (uiLength < 1) return 0;
+
+	uiCount = pPayload[0];
+	if (uiLength != 1 + (uiCount * TELEMETRY_DELTA_PROBE_BYTES)) return 0;
+
+	for (i = 0; i < uiCount; i++)
+	{
+		const uint8_t* pProbe = &pPayload[1 + (i * TELEMETRY_DELTA_PROBE_BYTES)];
+
+		Print_Probe(pProbe[0], &pProbe[1]);
+	}
+
+	printf("\n");
+	return 1;
+}
+
+
+static int Print_Dish_Delta(const uint8_t* pPayload, uint32_t uiLength)
+{
+	static const char* a_szChannel[TELEMETRY_DISH_CHANNELS] = { "H0", "H1", "H2", "H3", "V0", "V1", "V2", "V3", "HR", "VR" };
+	uint16_t ui16Mask;
+	uint32_t uiIndex = 2;
+	uint32_t i;
+
+	if (uiLength < 4) return 0;
+
+	ui16Mask = Get_16(pPayload);
+
+	for (i = 0; i < TELEMETRY_DISH_CHANNELS; i++)
+	{
+		if ((ui16Mask & (1 << i)) == 0) continue;
+		if ((uiIndex + 2) > (uiLength - 2)) return 0;
+
+		if (i < 8) printf(" %s:%u", a_szChannel[i], Get_16(&pPayload[uiIndex]));
+		else printf(" %s:%d", a_szChannel[i], (int16_t) Get_16(&pPayload[uiIndex]));
+
+		uiIndex += 2;
+	}
+
+	if (uiIndex != (uiLength - 2)) return 0;
+
+	printf("  Mode: %s%s\n",
+			a_szSample_Mode[pPayload[uiIndex] & 0x03],
+			(pPayload[uiIndex + 1] & TELEMETRY_DISH_SOLAR_VALID) ? "  Solar" : "");
+
+	return 1;
+}
+
+
+static int Print_Dish(const uint8_t* pPayload, uint32_t uiLength)
+{
+	uint32_t i;
+
+	if (uiLength != TELEMETRY_DISH_BYTES) return 0;
+
+	printf(" H:");
+	for (i = 0; i < 4; i++) printf(" %u", Get_16(&pPayload[i * 2]));
+
+	printf("  V:");
+	for (i = 0; i < 4; i++) printf(" %u", Get_16(&pPayload[8 + (i * 2)]));
+
+	printf("  Result H: %d  V: %d  Mode: %s%s\n",
+			(int16_t) Get_16(&pPayload[16]),
+			(int16_t) Get_16(&pPayload[18]),
+			a_szSample_Mode[pPayload[20] & 0x03],
+			(pPayload[21] & TELEMETRY_DISH_SOLAR_VALID) ? "  Solar" : "");
+
+	return 1;
+}
+
+
+static int Decode_Frame(const uint8_t* pEncoded, uint32_t uiLength)
+{
+	uint8_t a_ui8Raw[TELEMETRY_FRAME_MAX_RAW];
+	uint32_t uiRaw;
+	uint32_t uiPayload;
+
+	uiRaw = Decode_COBS(pEncoded, uiLength, a_ui8Raw, sizeof(a_ui8Raw));
+	if (uiRaw < (TELEMETRY_FRAME_HEADER_SIZE + TELEMETRY_FRAME_CRC_SIZE)) return 0;
+
+	uiPayload = uiRaw - TELEMETRY_FRAME_HEADER_SIZE - TELEMETRY_FRAME_CRC_SIZE;
+
+	if (Decode_CRC16(a_ui8Raw, uiRaw - TELEMETRY_FRAME_CRC_SIZE) != Get_16(&a_ui8Raw[uiRaw - TELEMETRY_FRAME_CRC_SIZE])) return 0;
+	if (a_ui8Raw[0] != TELEMETRY_FRAME_VERSION) return 0;
+
+	printf("%10u  #%5u", Get_32(&a_ui8Raw[4]), Get_16(&a_ui8Raw[2]));
+
+	switch (a_ui8Raw[1])
+	{
+		case TELEMETRY_FRAME_TYPE_TEMPERATURE:
+			printf("  TEMP");
+			return Print_Temperature(&a_ui8Raw[TELEMETRY_FRAME_HEADER_SIZE], uiPayload);
+
+		case TELEMETRY_FRAME_TYPE_DISH:
+			printf("  DISH");
+			return Print_Dish(&a_ui8Raw[TELEMETRY_FRAME_HEADER_SIZE], uiPayload);
+
+		case TELEMETRY_FRAME_TYPE_TEMPERATURE_DELTA:
+			printf("  temp");
+			return Print_Temperature_Delta(&a_ui8Raw[TELEMETRY_FRAME_HEADER_SIZE], uiPayload);
+
+		case TELEMETRY_FRAME_TYPE_DISH_DELTA:
+			printf("  dish");
+			return Print_Dish_Delta(&a_ui8Raw[TELEMETRY_FRAME_HEADER_SIZE], uiPayload);
+
+		default:
+			printf("  type %u?\n", a_ui8Raw[1]);
+			return 0;
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	FILE* pFile = stdin;
+	uint8_t a_ui8Frame[TELEMETRY_FRAME_MAX_ENCODED];
+	uint32_t uiLength = 0;
+	uint32_t uiGood = 0;
+	uint32_t uiBad = 0;
+	int iByte;
+
+	if (argc > 1)
+	{
+		pFile = fopen(argv[1], "rb");
+		if (pFile == NULL)
+		{
+			perror(argv[1]);
+			return 1;
+		}
+	}
+
+	while ((iByte = fgetc(pFile)) != EOF)
+	{
+		if (iByte != 0)
+		{
+			// too long for a frame... wait for the next delimiter
+			if (uiLength < sizeof(a_ui8Frame)) a_ui8Frame[uiLength] = (uint8_t) iByte;
+			uiLength++;
+			continue;
+		}
+
+		if (uiLength == 0) continue;
+
+		if ((uiLength <= sizeof(a_ui8Frame)) && Decode_Frame(a_ui8Frame, uiLength)) uiGood++;
+		else uiBad++;
+
+		uiLength = 0;
+		fflush(stdout);
+	}
+
+	fprintf(stderr, "frames: %u good, %u bad\n", uiGood, uiBad);
+
+	if (pFile != stdin) fclose(pFile);
+
+	return 0;
+}
+
+#endif
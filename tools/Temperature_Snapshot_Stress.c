@@ -0,0 +1,263 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// PC stress test for the Temperature_Snapshot.c seqlock, one writer against several readers.
+//
+// This is a PC program, it is not part of the board build.  Temperature_Snapshot.c is built as it is,
+// I2C_HAL.h gives it the simulator's ticks and tools/host has the stand-ins for the board headers.
+//     gcc -O2 -pthread -DI2C_HAL_SIMULATOR -Ihost -I.. -o snapshot_stress Temperature_Snapshot_Stress.c
+//         host/Host_RTOS.c ../I2C_Sim.c ../I2C_Trace.c ../Temperature_Snapshot.c
+//     ./snapshot_stress [publishes] [readers]
+//
+// The writer does what the temperature task does, it changes g_s_Temperature_Telemetry one field at a
+// time and then calls Temperature_Snapshot_Publish(), as fast as it can.  Every field of publish n is
+// made from n, and the simulated clock is moved 1 ms a publish, so a reader can tell from the
+// snapshot's own sequence number what every other field should be.  The readers (default 3) call
+// Temperature_Snapshot_Read() in a loop on the other cores and check each copy against its sequence,
+// and that the sequence never goes backwards.
+//
+// On the board the readers are preempting tasks, here they run alongside the writer on other cores,
+// which gets the writer into a buffer under a reader far more often than the board ever will.  The
+// retries say how often that happened... a torn copy is a failure, exit 1.
+//
+// The seqlock leans on the volatile accesses staying in order, which the Cortex-M4 and x86 both do
+// without barriers.  Don't read anything into a run on a weaker ordered machine.
+//
+//*****************************************************************************
+
+#if !defined(__TI_COMPILER_VERSION__)
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <xdc/std.h>
+#include <ti/drivers/I2C.h>
+
+#include "constants.h"
+#include "globals.h"
+
+#include "I2C_Sim.h"
+#include "Temperature_Snapshot.h"
+
+
+#define STRESS_MAX_READERS					16
+#define STRESS_REPORT_FAILURES				10     // printed, the rest are only counted
+
+
+extern uint32_t g_uiSnapshot_Retries;
+
+
+// the publish being written... the Temperature_Interface.c stand-ins below answer from it
+volatile uint32_t g_uiStress_Publish;
+volatile uint32_t g_uiStress_Done;
+
+
+typedef struct
+{
+	pthread_t hThread;
+	uint32_t ui32Reads;
+	uint32_t ui32Torn;
+	uint32_t ui32Backwards;
+	uint32_t ui32Empty;
+} Stress_Reader;
+
+
+
+// Temperature_Interface.c stand-ins, the same made up values as the telemetry
+uint32_t Temperature_Get_Age(uint32_t uiTemperatureIndex)
+{
+	// probe 0 never had a good reading
+	return (uiTemperatureIndex == 0) ? 0xFFFFFFFF : ((g_uiStress_Publish + uiTemperatureIndex) % 50);
+}
+
+
+uint32_t Temperature_Get_Health(uint32_t uiTemperatureIndex)
+{
+	return (g_uiStress_Publish + uiTemperatureIndex) % 3;
+}
+
+
+uint32_t Temperature_Get_Probe_Resolution(uint32_t uiTemperatureIndex)
+{
+	return (g_uiStress_Publish + uiTemperatureIndex) % MAX_TEMP_RESOLUTIONS;
+}
+
+
+
+static int16_t Stress_Tenths(uint32_t uiPublish, uint32_t uiProbe, uint32_t uiFahrenheit)
+{
+	// what publish n puts in a probe, whole * 10 + fraction with the sign... odd publishes are below zero
+	int32_t i32Tenths = (int32_t) ((((uiPublish + uiProbe) % 100) + uiFahrenheit * 32) * 10 + ((uiPublish + uiProbe) % 10));
+
+	return (int16_t) ((uiPublish & 1) ? -i32Tenths : i32Tenths);
+}
+
+
+static void Stress_Write_Telemetry(uint32_t uiPublish)
+{
+	// one field at a time the way Temperature_Get() does... the snapshot has to hide all of this
+	uint32_t i;
+
+	g_uiStress_Publish = uiPublish;
+
+	for (i = 0; i < MAX_TEMPERATURE_PROBES; i++)
+	{
+		volatile Temperature_Telemetry* pProbe = &g_s_Temperature_Telemetry[i];
+		int16_t i16Tenths_C = Stress_Tenths(uiPublish, i, 0);
+		int16_t i16Tenths_F = Stress_Tenths(uiPublish, i, 1);
+
+		pProbe->ui8Whole_C = (uint8_t) (abs(i16Tenths_C) / 10);
+		pProbe->ui8Fraction_C = (uint8_t) (abs(i16Tenths_C) % 10);
+		pProbe->ui8SignBit_C = (i16Tenths_C < 0);
+		pProbe->ui8Whole_F = (uint8_t) (abs(i16Tenths_F) / 10);
+		pProbe->ui8Fraction_F = (uint8_t) (abs(i16Tenths_F) % 10);
+		pProbe->ui8SignBit_F = (i16Tenths_F < 0);
+		pProbe->uiErrorFlag = uiPublish + i;
+		pProbe->uiROM_Flag = ((uiPublish + i) & 2) != 0;
+		pProbe->uiProbe_Configuration_Flag = ((uiPublish + i) & 4) != 0;
+	}
+}
+
+
+static uint32_t Stress_Check(const Temperature_Snapshot* pSnapshot)
+{
+	// 0 if every field is the one its sequence number says, else the first probe that isn't + 1
+	uint32_t uiPublish = pSnapshot->ui32Sequence;
+	uint32_t i;
+
+	// the writer moves the clock 1 ms before each publish
+	if (pSnapshot->ui32Ticks != uiPublish) return TEMPERATURE_SNAPSHOT_PROBES + 1;
+
+	for (i = 0; i < TEMPERATURE_SNAPSHOT_PROBES; i++)
+	{
+		const Temperature_Probe_Snapshot* pProbe = &pSnapshot->a_sProbe[i];
+		uint32_t uiValid = (i != 0);
+
+		if ((pProbe->i16Tenths_C != Stress_Tenths(uiPublish, i, 0)) ||
+			(pProbe->i16Tenths_F != Stress_Tenths(uiPublish, i, 1)) ||
+			(pProbe->ui32Error_Flag != (uiPublish + i)) ||
+			(pProbe->ui8Valid != uiValid) ||
+			(pProbe->ui32Last_Good_Ticks != (uiValid ? (uiPublish - ((uiPublish + i) % 50)) : 0)) ||
+			(pProbe->ui8ROM_Flag != (((uiPublish + i) & 2) != 0)) ||
+			(pProbe->ui8Configured != (((uiPublish + i) & 4) != 0)) ||
+			(pProbe->ui8Health != ((uiPublish + i) % 3)) ||
+			(pProbe->ui8Resolution != ((uiPublish + i) % MAX_TEMP_RESOLUTIONS)))
+		{
+			return i + 1;
+		}
+	}
+
+	return 0;
+}
+
+
+static void* Stress_Reader_Thread(void* pArgument)
+{
+	Stress_Reader* pReader = (Stress_Reader*) pArgument;
+	Temperature_Snapshot sSnapshot;
+	uint32_t uiLast = 0;
+
+	while (g_uiStress_Done == false)
+	{
+		uint32_t uiSequence = Temperature_Snapshot_Read(&sSnapshot);
+
+		pReader->ui32Reads++;
+
+		if (uiSequence == 0)
+		{
+			pReader->ui32Empty++;
+			continue;
+		}
+
+		if (uiSequence < uiLast) pReader->ui32Backwards++;
+		uiLast = uiSequence;
+
+		uint32_t uiBad = Stress_Check(&sSnapshot);
+		if (uiBad)
+		{
+			if (pReader->ui32Torn++ < STRESS_REPORT_FAILURES) printf("torn copy of publish %u at probe %u\n", uiSequence, uiBad - 1);
+		}
+	}
+
+	return NULL;
+}
+
+
+int main(int argc, char* argv[])
+{
+	Stress_Reader a_sReader[STRESS_MAX_READERS];
+	char* pEnd;
+	uint32_t uiPublishes = 2000000;
+	uint32_t uiReaders = 3;
+	uint32_t uiReads = 0;
+	uint32_t uiTorn = 0;
+	uint32_t uiBackwards = 0;
+	uint32_t i;
+
+	if (argc > 1)
+	{
+		uiPublishes = (uint32_t) strtoul(argv[1], &pEnd, 10);
+		if ((*argv[1] == '\0') || (*pEnd != '\0') || (uiPublishes == 0))
+		{
+			printf("publishes has to be a number above 0: %s\n", argv[1]);
+			return 1;
+		}
+	}
+
+	if (argc > 2)
+	{
+		uiReaders = (uint32_t) strtoul(argv[2], &pEnd, 10);
+		if ((*argv[2] == '\0') || (*pEnd != '\0') || (uiReaders == 0) || (uiReaders > STRESS_MAX_READERS))
+		{
+			printf("readers has to be 1 to %u: %s\n", STRESS_MAX_READERS, argv[2]);
+			return 1;
+		}
+	}
+
+	I2C_Sim_Reset();
+
+	memset(a_sReader, 0, sizeof(a_sReader));
+
+	for (i = 0; i < uiReaders; i++)
+	{
+		if (pthread_create(&a_sReader[i].hThread, NULL, Stress_Reader_Thread, &a_sReader[i]) != 0)
+		{
+			printf("can't start reader %u\n", i);
+			return 1;
+		}
+	}
+
+	// the writer, publish n is the nth Temperature_Snapshot_Publish() so its sequence number is n
+	for (i = 1; i <= uiPublishes; i++)
+	{
+		I2C_Sim_Advance_ns(1000000);
+		Stress_Write_Telemetry(i);
+		Temperature_Snapshot_Publish();
+	}
+
+	g_uiStress_Done = true;
+
+	for (i = 0; i < uiReaders; i++)
+	{
+		pthread_join(a_sReader[i].hThread, NULL);
+
+		printf("Reader %u: %u reads, %u torn, %u backwards, %u before the first publish\n",
+				i, a_sReader[i].ui32Reads, a_sReader[i].ui32Torn, a_sReader[i].ui32Backwards, a_sReader[i].ui32Empty);
+
+		uiReads += a_sReader[i].ui32Reads;
+		uiTorn += a_sReader[i].ui32Torn;
+		uiBackwards += a_sReader[i].ui32Backwards;
+	}
+
+	// the retry count is bumped by every reader without a lock, it's near enough for a rate
+	printf("Publishes: %u   Reads: %u   Retries: %u   Torn: %u   Backwards: %u\n", uiPublishes, uiReads, g_uiSnapshot_Retries, uiTorn, uiBackwards);
+
+	return ((uiTorn == 0) && (uiBackwards == 0)) ? 0 : 1;
+}
+
+#endif
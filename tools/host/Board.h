@@ -0,0 +1,12 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for Board.h - nothing in it is used by the host build.
+//
+//*****************************************************************************
+
+#ifndef HOST_BOARD_H_
+#define HOST_BOARD_H_
+
+#endif /* HOST_BOARD_H_ */
@@ -0,0 +1,12 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for Console_Interface.h - nothing in it is used by the host build.
+//
+//*****************************************************************************
+
+#ifndef HOST_CONSOLE_INTERFACE_H_
+#define HOST_CONSOLE_INTERFACE_H_
+
+#endif /* HOST_CONSOLE_INTERFACE_H_ */
@@ -0,0 +1,12 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for Driver_Setup.h - nothing in it is used by the host build.
+//
+//*****************************************************************************
+
+#ifndef HOST_DRIVER_SETUP_H_
+#define HOST_DRIVER_SETUP_H_
+
+#endif /* HOST_DRIVER_SETUP_H_ */
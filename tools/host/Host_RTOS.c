@@ -0,0 +1,210 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-ins for the TI-RTOS calls and the board globals, so the acquisition modules build and run
+// on the PC unchanged.  Built with I2C_HAL_SIMULATOR, time is the bus simulator's (I2C_Sim.c).
+//
+// The host build is one thread.  Hwi_disable() has nothing to hold off, there is one task and a
+// constructed task or Clock is recorded but never run... a bench calls the work itself.  A semaphore
+// is a count, and a pend on zero times out at once instead of blocking the only thread.
+//
+// This is a PC module, it is not part of the board build.
+//
+//*****************************************************************************
+
+#if !defined(__TI_COMPILER_VERSION__)
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <xdc/std.h>
+#include <xdc/runtime/Types.h>
+#include <xdc/runtime/Timestamp.h>
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/knl/Task.h>
+#include <ti/sysbios/knl/Semaphore.h>
+#include <ti/drivers/I2C.h>
+
+#include "constants.h"
+#include "globals.h"
+#include "Telemetry.h"
+
+#include "I2C_Sim.h"
+
+
+
+// from globals.c / main.c on the board
+Temperature_Telemetry g_s_Temperature_Telemetry[MAX_TEMPERATURE_PROBES];
+Dish_Movement_Telemetry g_s_Dish_Movement_Telemetry;
+Motor_Voltages g_s_Motor_Voltages;
+EEPROM_Data g_s_EEPROM_Data = { TEMP_RES_BASE_OFFSET };
+
+uint32_t g_ui_Temperature_Clock_Delay[MAX_TEMP_RESOLUTIONS] = { 94, 188, 375, 750 };
+uint32_t g_ui_0001_Second = I2C_SIM_CPU_HZ / 3 / 10000;       // SysCtlDelay() is 3 cycles a count
+uint32_t g_ui_001_Second = I2C_SIM_CPU_HZ / 3 / 1000;
+
+UInt32 Clock_tickPeriod = 1000;
+
+FILE* g_pHost_Telemetry_Output;            // the console, NULL drops it
+
+Task_Struct g_sHost_Task;
+
+
+
+// Telemetry
+void Telemetry_Send_Output(char* szMessage)
+{
+	if (g_pHost_Telemetry_Output != NULL) fprintf(g_pHost_Telemetry_Output, "%s", szMessage);
+}
+
+
+void Telemetry_Send_Output_Value(const char* szMessage, int iValue)
+{
+	if (g_pHost_Telemetry_Output != NULL) fprintf(g_pHost_Telemetry_Output, "%s%i\n", szMessage, iValue);
+}
+
+
+void Telemetry_System_Printf(char* szMessage)
+{
+	if (g_pHost_Telemetry_Output != NULL) fprintf(g_pHost_Telemetry_Output, "%s", szMessage);
+}
+
+
+
+// Timestamp / Clock
+UInt32 Timestamp_get32(void)
+{
+	return I2C_Sim_Get_Cycles();
+}
+
+
+void Timestamp_getFreq(Types_FreqHz* pFrequency)
+{
+	pFrequency->hi = 0;
+	pFrequency->lo = I2C_SIM_CPU_HZ;
+}
+
+
+UInt32 Clock_getTicks(void)
+{
+	return I2C_Sim_Get_Ticks();
+}
+
+
+void Clock_Params_init(Clock_Params* pParams)
+{
+	memset(pParams, 0, sizeof(Clock_Params));
+}
+
+
+void Clock_construct(Clock_Struct* pClock, Clock_FuncPtr pfnFunction, UInt uiTimeout, const Clock_Params* pParams)
+{
+	pClock->pfnFunction = pfnFunction;
+	pClock->uiTimeout = uiTimeout;
+	pClock->sParams = *pParams;
+}
+
+
+Clock_Handle Clock_handle(Clock_Struct* pClock)
+{
+	return pClock;
+}
+
+
+void Clock_start(Clock_Handle hClock)
+{
+}
+
+
+void Clock_stop(Clock_Handle hClock)
+{
+}
+
+
+
+// Hwi / Task
+UInt Hwi_disable(void)
+{
+	return 0;
+}
+
+
+void Hwi_restore(UInt uiKey)
+{
+}
+
+
+Task_Handle Task_self(void)
+{
+	return &g_sHost_Task;
+}
+
+
+void Task_Params_init(Task_Params* pParams)
+{
+	memset(pParams, 0, sizeof(Task_Params));
+}
+
+
+void Task_construct(Task_Struct* pTask, Task_FuncPtr pfnFunction, const Task_Params* pParams, void* pEb)
+{
+	pTask->pfnFunction = pfnFunction;
+	pTask->sParams = *pParams;
+}
+
+
+
+// Semaphore
+void Semaphore_Params_init(Semaphore_Params* pParams)
+{
+	pParams->mode = Semaphore_Mode_COUNTING;
+}
+
+
+void Semaphore_construct(Semaphore_Struct* pSemaphore, Int iCount, const Semaphore_Params* pParams)
+{
+	pSemaphore->iCount = iCount;
+	pSemaphore->eMode = pParams->mode;
+}
+
+
+Semaphore_Handle Semaphore_handle(Semaphore_Struct* pSemaphore)
+{
+	return pSemaphore;
+}
+
+
+Bool Semaphore_pend(Semaphore_Handle hSemaphore, UInt32 uiTimeout)
+{
+	if (hSemaphore->iCount == 0) return false;
+
+	hSemaphore->iCount--;
+	return true;
+}
+
+
+void Semaphore_post(Semaphore_Handle hSemaphore)
+{
+	if ((hSemaphore->eMode == Semaphore_Mode_BINARY) && hSemaphore->iCount) return;
+
+	hSemaphore->iCount++;
+}
+
+
+
+// I2C... the transfers themselves go through I2C_HAL.h to the simulator
+void I2C_Params_init(I2C_Params* pParams)
+{
+	pParams->transferMode = I2C_MODE_BLOCKING;
+	pParams->transferCallbackFxn = NULL;
+	pParams->bitRate = I2C_100kHz;
+	pParams->custom = 0;
+}
+
+#endif
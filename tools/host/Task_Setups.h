@@ -0,0 +1,12 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for Task_Setups.h - nothing in it is used by the host build.
+//
+//*****************************************************************************
+
+#ifndef HOST_TASK_SETUPS_H_
+#define HOST_TASK_SETUPS_H_
+
+#endif /* HOST_TASK_SETUPS_H_ */
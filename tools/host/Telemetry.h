@@ -0,0 +1,21 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for Telemetry.h - text output goes to g_pHost_Telemetry_Output, dropped when it's NULL.
+//
+//*****************************************************************************
+
+#ifndef HOST_TELEMETRY_H_
+#define HOST_TELEMETRY_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+extern FILE* g_pHost_Telemetry_Output;
+
+void Telemetry_Send_Output(char* szMessage);
+void Telemetry_Send_Output_Value(const char* szMessage, int iValue);
+void Telemetry_System_Printf(char* szMessage);
+
+#endif /* HOST_TELEMETRY_H_ */
@@ -0,0 +1,12 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for UDP_Utilities.h - nothing in it is used by the host build.
+//
+//*****************************************************************************
+
+#ifndef HOST_UDP_UTILITIES_H_
+#define HOST_UDP_UTILITIES_H_
+
+#endif /* HOST_UDP_UTILITIES_H_ */
@@ -0,0 +1,32 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for constants.h - the board constants the acquisition modules use, same values.
+//
+//*****************************************************************************
+
+#ifndef HOST_CONSTANTS_H_
+#define HOST_CONSTANTS_H_
+
+#define NO_ERRORS							0
+
+// Temperatures
+#define MAX_TEMPERATURE_PROBES				16
+#define DS18B20_ROM_SIZE					8
+
+#define TEMP_RESOLUTION_BITS_9				0
+#define TEMP_RESOLUTION_BITS_10				1
+#define TEMP_RESOLUTION_BITS_11				2
+#define TEMP_RESOLUTION_BITS_12				3
+#define MAX_TEMP_RESOLUTIONS				4
+#define TEMP_RES_BASE_OFFSET				9      // EEPROM value 9..12 bits
+
+// ADC
+#define MAX_ADC_CHIPS						3
+#define MAX_ADC_CHANNELS					8
+#define MAX_ADC_SAMPLES						10
+#define MAX_PHOTORESISTOR_RLUP				4
+#define ERROR_VOLTAGE_VALUE					0xFFFF
+
+#endif /* HOST_CONSTANTS_H_ */
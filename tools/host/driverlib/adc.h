@@ -0,0 +1,12 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for "driverlib/adc.h" - nothing in it is used by the host build.
+//
+//*****************************************************************************
+
+#ifndef HOST_DRIVERLIB_ADC_H_
+#define HOST_DRIVERLIB_ADC_H_
+
+#endif /* HOST_DRIVERLIB_ADC_H_ */
@@ -0,0 +1,68 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for globals.h - the telemetry structures and settings the acquisition modules fill in.
+//
+// Only the fields the tree uses.  The objects themselves are in Host_RTOS.c.
+//
+//*****************************************************************************
+
+#ifndef HOST_GLOBALS_H_
+#define HOST_GLOBALS_H_
+
+#include <stdint.h>
+
+#include <ti/drivers/I2C.h>
+
+#include "constants.h"
+
+
+typedef struct
+{
+	uint32_t uiErrorFlag;
+	uint32_t uiROM_Flag;
+	uint32_t uiProbe_Configuration_Flag;
+	uint8_t ucROM[DS18B20_ROM_SIZE];
+	uint8_t ui8Whole_C;
+	uint8_t ui8Fraction_C;
+	uint8_t ui8SignBit_C;
+	uint8_t ui8Whole_F;
+	uint8_t ui8Fraction_F;
+	uint8_t ui8SignBit_F;
+} Temperature_Telemetry;
+
+typedef struct
+{
+	uint32_t MT_a_ui32ADC_H_Data[MAX_PHOTORESISTOR_RLUP];
+	uint32_t MT_a_ui32ADC_V_Data[MAX_PHOTORESISTOR_RLUP];
+	int MT_iH_ResultCalc;
+	int MT_iV_ResultCalc;
+} Dish_Movement_Telemetry;
+
+typedef struct
+{
+	uint32_t uiDishPump;
+	uint32_t uiImmediateReseviorPump;
+	uint32_t uiHoldReseviorPump;
+	uint32_t uiAUXPump;
+	uint32_t uiHorizontalDishMotor;
+	uint32_t uiVerticalDishDishMotor;
+} Motor_Voltages;
+
+typedef struct
+{
+	uint32_t uiTemperatureResolution;   // 9..12
+} EEPROM_Data;
+
+
+extern Temperature_Telemetry g_s_Temperature_Telemetry[MAX_TEMPERATURE_PROBES];
+extern Dish_Movement_Telemetry g_s_Dish_Movement_Telemetry;
+extern Motor_Voltages g_s_Motor_Voltages;
+extern EEPROM_Data g_s_EEPROM_Data;
+
+extern uint32_t g_ui_Temperature_Clock_Delay[MAX_TEMP_RESOLUTIONS];   // ms, the DS18B20 conversion times
+extern uint32_t g_ui_0001_Second;                                      // SysCtlDelay() counts
+extern uint32_t g_ui_001_Second;
+
+#endif /* HOST_GLOBALS_H_ */
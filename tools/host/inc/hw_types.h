@@ -0,0 +1,12 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for "inc/hw_types.h" - nothing in it is used by the host build.
+//
+//*****************************************************************************
+
+#ifndef HOST_INC_HW_TYPES_H_
+#define HOST_INC_HW_TYPES_H_
+
+#endif /* HOST_INC_HW_TYPES_H_ */
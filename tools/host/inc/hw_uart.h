@@ -0,0 +1,12 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for "inc/hw_uart.h" - nothing in it is used by the host build.
+//
+//*****************************************************************************
+
+#ifndef HOST_INC_HW_UART_H_
+#define HOST_INC_HW_UART_H_
+
+#endif /* HOST_INC_HW_UART_H_ */
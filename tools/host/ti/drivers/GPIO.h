@@ -0,0 +1,12 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for <ti/drivers/GPIO.h> - nothing in it is used by the host build.
+//
+//*****************************************************************************
+
+#ifndef HOST_TI_DRIVERS_GPIO_H_
+#define HOST_TI_DRIVERS_GPIO_H_
+
+#endif /* HOST_TI_DRIVERS_GPIO_H_ */
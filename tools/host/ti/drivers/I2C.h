@@ -0,0 +1,59 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for <ti/drivers/I2C.h> - the types behind I2C_HAL.h, the transfers go to I2C_Sim.c.
+//
+//*****************************************************************************
+
+#ifndef HOST_TI_DRIVERS_I2C_H_
+#define HOST_TI_DRIVERS_I2C_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define I2C_MASTER_ERR_NONE					0x00000000
+#define I2C_MASTER_INT_NACK					0x00000004       // driverlib I2C_MASTER_ERR_ADDR_ACK
+#define I2C_MASTER_ERR_ADDR_ACK				0x00000004
+#define I2C_MASTER_ERR_DATA_ACK				0x00000008
+#define I2C_MASTER_ERR_ARB_LOST				0x00000010
+
+typedef enum
+{
+	I2C_MODE_BLOCKING,
+	I2C_MODE_CALLBACK
+} I2C_TransferMode;
+
+typedef enum
+{
+	I2C_100kHz,
+	I2C_400kHz
+} I2C_BitRate;
+
+typedef struct I2C_Config* I2C_Handle;
+
+typedef struct
+{
+	void* writeBuf;
+	size_t writeCount;
+	void* readBuf;
+	size_t readCount;
+	uint_least8_t slaveAddress;
+	void* arg;
+	void* nextPtr;
+} I2C_Transaction;
+
+typedef void (*I2C_CallbackFxn)(I2C_Handle, I2C_Transaction*, bool);
+
+typedef struct
+{
+	I2C_TransferMode transferMode;
+	I2C_CallbackFxn transferCallbackFxn;
+	I2C_BitRate bitRate;
+	uintptr_t custom;
+} I2C_Params;
+
+void I2C_Params_init(I2C_Params* pParams);
+
+#endif /* HOST_TI_DRIVERS_I2C_H_ */
@@ -0,0 +1,17 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for <ti/sysbios/BIOS.h> - the timeout constants.
+//
+//*****************************************************************************
+
+#ifndef HOST_TI_SYSBIOS_BIOS_H_
+#define HOST_TI_SYSBIOS_BIOS_H_
+
+#include <xdc/std.h>
+
+#define BIOS_WAIT_FOREVER					(~((UInt) 0))
+#define BIOS_NO_WAIT						0
+
+#endif /* HOST_TI_SYSBIOS_BIOS_H_ */
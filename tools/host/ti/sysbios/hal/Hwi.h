@@ -0,0 +1,17 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for <ti/sysbios/hal/Hwi.h> - the host build runs one thread, there is nothing to disable.
+//
+//*****************************************************************************
+
+#ifndef HOST_TI_SYSBIOS_HAL_HWI_H_
+#define HOST_TI_SYSBIOS_HAL_HWI_H_
+
+#include <xdc/std.h>
+
+UInt Hwi_disable(void);
+void Hwi_restore(UInt uiKey);
+
+#endif /* HOST_TI_SYSBIOS_HAL_HWI_H_ */
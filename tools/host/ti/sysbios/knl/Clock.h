@@ -0,0 +1,42 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for <ti/sysbios/knl/Clock.h> - ticks are the simulator's 1 ms ticks (Host_RTOS.c).
+//
+//*****************************************************************************
+
+#ifndef HOST_TI_SYSBIOS_KNL_CLOCK_H_
+#define HOST_TI_SYSBIOS_KNL_CLOCK_H_
+
+#include <xdc/std.h>
+
+typedef void (*Clock_FuncPtr)(UArg);
+
+typedef struct
+{
+	UInt32 period;
+	Bool startFlag;
+	UArg arg;
+} Clock_Params;
+
+typedef struct
+{
+	Clock_FuncPtr pfnFunction;
+	UInt32 uiTimeout;
+	Clock_Params sParams;
+} Clock_Struct;
+
+typedef Clock_Struct* Clock_Handle;
+
+extern UInt32 Clock_tickPeriod;               // us per tick
+
+UInt32 Clock_getTicks(void);
+
+void Clock_Params_init(Clock_Params* pParams);
+void Clock_construct(Clock_Struct* pClock, Clock_FuncPtr pfnFunction, UInt uiTimeout, const Clock_Params* pParams);
+Clock_Handle Clock_handle(Clock_Struct* pClock);
+void Clock_start(Clock_Handle hClock);
+void Clock_stop(Clock_Handle hClock);
+
+#endif /* HOST_TI_SYSBIOS_KNL_CLOCK_H_ */
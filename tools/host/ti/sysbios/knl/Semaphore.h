@@ -0,0 +1,39 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for <ti/sysbios/knl/Semaphore.h> - a count, a pend on zero times out at once.
+//
+//*****************************************************************************
+
+#ifndef HOST_TI_SYSBIOS_KNL_SEMAPHORE_H_
+#define HOST_TI_SYSBIOS_KNL_SEMAPHORE_H_
+
+#include <xdc/std.h>
+
+typedef enum
+{
+	Semaphore_Mode_COUNTING,
+	Semaphore_Mode_BINARY
+} Semaphore_Mode;
+
+typedef struct
+{
+	Semaphore_Mode mode;
+} Semaphore_Params;
+
+typedef struct
+{
+	Int iCount;
+	Semaphore_Mode eMode;
+} Semaphore_Struct;
+
+typedef Semaphore_Struct* Semaphore_Handle;
+
+void Semaphore_Params_init(Semaphore_Params* pParams);
+void Semaphore_construct(Semaphore_Struct* pSemaphore, Int iCount, const Semaphore_Params* pParams);
+Semaphore_Handle Semaphore_handle(Semaphore_Struct* pSemaphore);
+Bool Semaphore_pend(Semaphore_Handle hSemaphore, UInt32 uiTimeout);
+void Semaphore_post(Semaphore_Handle hSemaphore);
+
+#endif /* HOST_TI_SYSBIOS_KNL_SEMAPHORE_H_ */
@@ -0,0 +1,12 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for <ti/sysbios/knl/Swi.h> - nothing in it is used by the host build.
+//
+//*****************************************************************************
+
+#ifndef HOST_TI_SYSBIOS_KNL_SWI_H_
+#define HOST_TI_SYSBIOS_KNL_SWI_H_
+
+#endif /* HOST_TI_SYSBIOS_KNL_SWI_H_ */
@@ -0,0 +1,37 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for <ti/sysbios/knl/Task.h> - one task, constructed tasks are never run.
+//
+//*****************************************************************************
+
+#ifndef HOST_TI_SYSBIOS_KNL_TASK_H_
+#define HOST_TI_SYSBIOS_KNL_TASK_H_
+
+#include <xdc/std.h>
+
+typedef void (*Task_FuncPtr)(UArg, UArg);
+
+typedef struct
+{
+	Ptr stack;
+	size_t stackSize;
+	Int priority;
+	UArg arg0;
+	UArg arg1;
+} Task_Params;
+
+typedef struct
+{
+	Task_FuncPtr pfnFunction;
+	Task_Params sParams;
+} Task_Struct;
+
+typedef Task_Struct* Task_Handle;
+
+Task_Handle Task_self(void);
+void Task_Params_init(Task_Params* pParams);
+void Task_construct(Task_Struct* pTask, Task_FuncPtr pfnFunction, const Task_Params* pParams, void* pEb);
+
+#endif /* HOST_TI_SYSBIOS_KNL_TASK_H_ */
@@ -0,0 +1,12 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for <xdc/cfg/global.h> - the board build generates this from the .cfg, nothing in it is used by the host build.
+//
+//*****************************************************************************
+
+#ifndef HOST_XDC_CFG_GLOBAL_H_
+#define HOST_XDC_CFG_GLOBAL_H_
+
+#endif /* HOST_XDC_CFG_GLOBAL_H_ */
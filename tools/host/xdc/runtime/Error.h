@@ -0,0 +1,19 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for <xdc/runtime/Error.h> - errors are not raised on the host.
+//
+//*****************************************************************************
+
+#ifndef HOST_XDC_RUNTIME_ERROR_H_
+#define HOST_XDC_RUNTIME_ERROR_H_
+
+typedef struct
+{
+	int iUnused;
+} Error_Block;
+
+#define Error_init(pEb)						((void) (pEb))
+
+#endif /* HOST_XDC_RUNTIME_ERROR_H_ */
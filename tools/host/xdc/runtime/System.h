@@ -0,0 +1,17 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for <xdc/runtime/System.h> - printf to stdout.
+//
+//*****************************************************************************
+
+#ifndef HOST_XDC_RUNTIME_SYSTEM_H_
+#define HOST_XDC_RUNTIME_SYSTEM_H_
+
+#include <stdio.h>
+
+#define System_printf						printf
+#define System_flush()						fflush(stdout)
+
+#endif /* HOST_XDC_RUNTIME_SYSTEM_H_ */
@@ -0,0 +1,18 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for <xdc/runtime/Timestamp.h> - the simulator's CPU cycle count (Host_RTOS.c).
+//
+//*****************************************************************************
+
+#ifndef HOST_XDC_RUNTIME_TIMESTAMP_H_
+#define HOST_XDC_RUNTIME_TIMESTAMP_H_
+
+#include <xdc/std.h>
+#include <xdc/runtime/Types.h>
+
+UInt32 Timestamp_get32(void);
+void Timestamp_getFreq(Types_FreqHz* pFrequency);
+
+#endif /* HOST_XDC_RUNTIME_TIMESTAMP_H_ */
@@ -0,0 +1,20 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for <xdc/runtime/Types.h> - the timestamp frequency.
+//
+//*****************************************************************************
+
+#ifndef HOST_XDC_RUNTIME_TYPES_H_
+#define HOST_XDC_RUNTIME_TYPES_H_
+
+#include <xdc/std.h>
+
+typedef struct
+{
+	Int32 hi;
+	UInt32 lo;
+} Types_FreqHz;
+
+#endif /* HOST_XDC_RUNTIME_TYPES_H_ */
@@ -0,0 +1,31 @@
+//*****************************************************************************
+//
+// XEn, LLC
+//
+// Host stand-in for <xdc/std.h> - the XDC base types.
+//
+//*****************************************************************************
+
+#ifndef HOST_XDC_STD_H_
+#define HOST_XDC_STD_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int Int;
+typedef unsigned int UInt;
+typedef unsigned long ULong;
+typedef int32_t Int32;
+typedef uint32_t UInt32;
+typedef bool Bool;
+typedef void* Ptr;
+typedef uintptr_t UArg;
+typedef char* String;
+
+#ifndef TRUE
+#define TRUE								1
+#define FALSE								0
+#endif
+
+#endif /* HOST_XDC_STD_H_ */